@@ -0,0 +1,110 @@
+#pragma once
+#include <time.h>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//benchmark公共工具 结果按每行一个JSON对象输出到stdout 方便脚本收集
+namespace bench {
+
+inline int64_t nowNanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+class JsonLine
+{
+public:
+    explicit JsonLine(const std::string& bench) { add("bench", bench); }
+
+    JsonLine& add(const std::string& key, const std::string& value)
+    {
+        append(key);
+        body_ += "\"" + value + "\"";
+        return *this;
+    }
+    JsonLine& add(const std::string& key, const char* value) { return add(key, std::string(value)); }
+    JsonLine& add(const std::string& key, int64_t value)
+    {
+        append(key);
+        body_ += std::to_string(value);
+        return *this;
+    }
+    JsonLine& add(const std::string& key, int value) { return add(key, static_cast<int64_t>(value)); }
+    JsonLine& add(const std::string& key, size_t value) { return add(key, static_cast<int64_t>(value)); }
+    JsonLine& add(const std::string& key, double value)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.3f", value);
+        append(key);
+        body_ += buf;
+        return *this;
+    }
+
+    //value已经是JSON 比如log2Histogram的结果
+    JsonLine& addRaw(const std::string& key, const std::string& value)
+    {
+        append(key);
+        body_ += value;
+        return *this;
+    }
+
+    void print() const
+    {
+        printf("{%s}\n", body_.c_str());
+        fflush(stdout);
+    }
+
+private:
+    void append(const std::string& key)
+    {
+        if (!body_.empty())
+        {
+            body_ += ",";
+        }
+        body_ += "\"" + key + "\":";
+    }
+
+    std::string body_;
+};
+
+//按2的幂分桶的延迟直方图 输入是纳秒 输出JSON对象 键是桶的上界(微秒) 只输出非空的桶
+inline std::string log2Histogram(const std::vector<int64_t>& nanos)
+{
+    std::vector<int64_t> buckets;
+    for (int64_t n : nanos)
+    {
+        int64_t micros = n / 1000;
+        size_t bucket = 0;
+        while ((int64_t(1) << bucket) <= micros)
+        {
+            ++bucket;
+        }
+        if (buckets.size() <= bucket)
+        {
+            buckets.resize(bucket + 1, 0);
+        }
+        ++buckets[bucket];
+    }
+
+    std::string json = "{";
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        if (buckets[i] == 0)
+        {
+            continue;
+        }
+        if (json.size() > 1)
+        {
+            json += ",";
+        }
+        json += "\"" + std::to_string(int64_t(1) << i) + "\":" + std::to_string(buckets[i]);
+    }
+    json += "}";
+    return json;
+}
+
+}  // namespace bench
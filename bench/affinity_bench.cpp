@@ -0,0 +1,218 @@
+//IO线程绑核测试 回显服务器有loops个IO线程 客户端connections条连接各自一问一答 统计往返延迟
+//unpinned: 不绑定 pinned: 第i个IO线程绑定到cpus[i % n] 并把内存分配在本地NUMA节点
+//要在多路服务器上跑才看得出跨节点的差别 cpus默认是0..nproc-1
+//用法: affinity_bench [port] [seconds] [loops] [connections] [cpus 如0,2,4,6]
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/base/CurrentThread.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/EventLoopThreadPool.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/TcpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const size_t kMessageSize = 64;
+
+//只在客户端loop线程中使用
+class LoadGenerator : noncopyable
+{
+public:
+    LoadGenerator(EventLoop* loop, const InetAddress& serverAddr, int connections)
+        : message_(kMessageSize, 'm')
+        , recording_(false)
+        , stopped_(false)
+    {
+        for (int i = 0; i < connections; ++i)
+        {
+            std::unique_ptr<TcpClient> client(new TcpClient(loop, serverAddr, "affinity_bench" + std::to_string(i)));
+            std::shared_ptr<int64_t> start = std::make_shared<int64_t>(0);
+            client->setConnectionCallback([this, start](const TcpConnectionPtr& conn) {
+                if (conn->connected())
+                {
+                    conn->setTcpNoDelay(true);
+                    *start = bench::nowNanos();
+                    conn->send(message_);
+                }
+            });
+            client->setMessageCallback([this, start](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+                if (buf->readableBytesLength() < kMessageSize)
+                {
+                    return;
+                }
+                buf->retrieve(kMessageSize);
+                if (recording_ && !stopped_)
+                {
+                    latencies_.push_back(bench::nowNanos() - *start);
+                }
+                if (!stopped_)
+                {
+                    *start = bench::nowNanos();
+                    conn->send(message_);
+                }
+            });
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    void start()
+    {
+        for (auto& client : clients_)
+        {
+            client->connect();
+        }
+    }
+
+    void startRecording() { recording_ = true; }
+    void stop() { stopped_ = true; }
+    std::vector<int64_t>& latencies() { return latencies_; }
+
+private:
+    const std::string message_;
+    bool recording_;
+    bool stopped_;
+    std::vector<int64_t> latencies_;
+    std::vector<std::unique_ptr<TcpClient>> clients_;
+};
+
+double percentileMicros(const std::vector<int64_t>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+std::vector<int> parseCpus(const char* arg)
+{
+    std::vector<int> cpus;
+    if (arg == nullptr)
+    {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long i = 0; i < n; ++i)
+        {
+            cpus.push_back(static_cast<int>(i));
+        }
+        return cpus;
+    }
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        cpus.push_back(atoi(item.c_str()));
+    }
+    return cpus;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18160);
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    int numLoops = argc > 3 ? atoi(argv[3]) : 4;
+    int connections = argc > 4 ? atoi(argv[4]) : 16;
+    std::vector<int> cpus = parseCpus(argc > 5 ? argv[5] : nullptr);
+    const double warmupSeconds = 0.3;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoop loop;
+    EventLoopThread clientThread(ThreadInitCallback(), "bench-client");
+    EventLoop* clientLoop = clientThread.startLoop();
+
+    //每种模式一个服务器 都保留到最后 上一轮连接关闭的回调还会在baseLoop中执行
+    std::vector<std::unique_ptr<TcpServer>> servers;
+    const char* modes[] = {"unpinned", "pinned"};
+    for (const char* mode : modes)
+    {
+        bool pinned = std::string(mode) == "pinned";
+        servers.emplace_back(new TcpServer(&loop, InetAddress(port, true), "affinity_bench"));
+        TcpServer& server = *servers.back();
+        server.setThreadNum(numLoops);
+        if (pinned)
+        {
+            server.threadPool()->setCpuAffinity(cpus);
+            server.threadPool()->setNumaLocalMemory(true);
+        }
+        server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+            if (conn->connected())
+            {
+                conn->setTcpNoDelay(true);
+            }
+        });
+        server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) { conn->send(buf); });
+        server.start();
+
+        //各个IO线程实际所在的NUMA节点
+        std::set<int> nodes;
+        for (EventLoop* ioLoop : server.threadPool()->getAllLoops())
+        {
+            std::promise<int> node;
+            ioLoop->runInLoop([&node]() { node.set_value(base::CurrentThread::numaNode()); });
+            nodes.insert(node.get_future().get());
+        }
+
+        std::shared_ptr<LoadGenerator> generator(new LoadGenerator(clientLoop, InetAddress("127.0.0.1", port), connections));
+        int64_t startNanos = 0;
+        int64_t endNanos = 0;
+        clientLoop->runInLoop([generator]() { generator->start(); });
+        loop.runAfter(warmupSeconds, [&]() {
+            clientLoop->runInLoop([generator]() { generator->startRecording(); });
+            startNanos = bench::nowNanos();
+        });
+        loop.runAfter(warmupSeconds + seconds, [&]() {
+            clientLoop->runInLoop([generator]() { generator->stop(); });
+            endNanos = bench::nowNanos();
+            loop.quit();
+        });
+        loop.loop();
+
+        std::promise<void> destroyed;
+        std::vector<int64_t> latencies;
+        clientLoop->runInLoop([&]() {
+            latencies.swap(generator->latencies());
+            generator.reset();
+            //TcpClient析构后连接的关闭要再经过几次queueInLoop 等它们执行完
+            clientLoop->runAfter(0.01, [&]() { destroyed.set_value(); });
+        });
+        destroyed.get_future().wait();
+
+        std::sort(latencies.begin(), latencies.end());
+        double elapsed = static_cast<double>(endNanos - startNanos) / 1e9;
+        bench::JsonLine("affinity")
+            .add("mode", mode)
+            .add("loops", numLoops)
+            .add("connections", connections)
+            .add("cpus", static_cast<int>(cpus.size()))
+            .add("numa_nodes", static_cast<int>(nodes.size()))
+            .add("round_trips_per_sec", static_cast<double>(latencies.size()) / elapsed)
+            .add("p50_us", percentileMicros(latencies, 0.50))
+            .add("p99_us", percentileMicros(latencies, 0.99))
+            .add("p999_us", percentileMicros(latencies, 0.999))
+            .print();
+        ++port;
+    }
+
+    //最后一轮连接关闭的回调还在baseLoop中排队 处理完再析构服务器
+    loop.runAfter(0.05, [&]() { loop.quit(); });
+    loop.loop();
+    return 0;
+}
@@ -0,0 +1,90 @@
+//Buffer读写测试 每个case重复到至少200ms 输出每次操作的纳秒数和吞吐量
+//append_retrieve: 追加size字节再全部取走 缓冲区不扩容 只有指针移动和memcpy
+//append_retrieve_string: 取走时拷贝成std::string 对应retrieveAllAsString的用法
+//pipelined: 连续追加16条size字节的消息再逐条取走 会触发空间整理(memmove)
+//int32: appendInt32后readInt32 对应长度头编解码
+//用法: buffer_bench
+#include <string>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+
+using myMuduo::net::Buffer;
+
+namespace {
+
+const int64_t kMinDurationNanos = 200 * 1000 * 1000;
+const int kBatch = 1000;
+const int kPipelineDepth = 16;
+
+volatile size_t g_sink = 0;
+
+//func执行一次处理bytesPerOp字节
+template <typename Func>
+void measure(const char* caseName, size_t size, size_t bytesPerOp, Func func)
+{
+    int64_t start = bench::nowNanos();
+    int64_t elapsed = 0;
+    int64_t iterations = 0;
+    while (elapsed < kMinDurationNanos)
+    {
+        for (int i = 0; i < kBatch; ++i)
+        {
+            g_sink += func();
+        }
+        iterations += kBatch;
+        elapsed = bench::nowNanos() - start;
+    }
+    double seconds = static_cast<double>(elapsed) / 1e9;
+    bench::JsonLine("buffer")
+        .add("case", caseName)
+        .add("size", size)
+        .add("ns_per_op", static_cast<double>(elapsed) / static_cast<double>(iterations))
+        .add("ops_per_sec", static_cast<double>(iterations) / seconds)
+        .add("gb_per_sec", static_cast<double>(iterations) * static_cast<double>(bytesPerOp) / seconds / 1e9)
+        .print();
+}
+
+}  // namespace
+
+int main()
+{
+    const size_t sizes[] = {16, 256, 4096, 65536};
+    for (size_t size : sizes)
+    {
+        const std::string data(size, 'b');
+        Buffer buffer;
+
+        measure("append_retrieve", size, size, [&]() {
+            buffer.append(data.data(), data.size());
+            size_t n = buffer.readableBytesLength();
+            buffer.retrieve(n);
+            return n;
+        });
+
+        measure("append_retrieve_string", size, size, [&]() {
+            buffer.append(data.data(), data.size());
+            return buffer.retrieveAllAsString().size();
+        });
+
+        measure("pipelined", size, size * kPipelineDepth, [&]() {
+            for (int i = 0; i < kPipelineDepth; ++i)
+            {
+                buffer.append(data.data(), data.size());
+            }
+            size_t total = 0;
+            while (buffer.readableBytesLength() >= size)
+            {
+                total += static_cast<size_t>(*buffer.peek());
+                buffer.retrieve(size);
+            }
+            return total;
+        });
+    }
+
+    Buffer buffer;
+    measure("int32", sizeof(int32_t), sizeof(int32_t), [&]() {
+        buffer.appendInt32(static_cast<int32_t>(g_sink));
+        return static_cast<size_t>(buffer.readInt32());
+    });
+    return 0;
+}
@@ -0,0 +1,123 @@
+//分隔符查找测试
+//scan: 一次性扫描N字节 分隔符在末尾 对比std::search/std::find和base/ByteSearch
+//incremental: 一行数据分多次到达 每次到达后都查找一次 对比每次从peek()重新扫描和Buffer的断点续扫
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include "bench/BenchUtil.h"
+#include "myMuduo/base/ByteSearch.h"
+#include "myMuduo/net/Buffer.h"
+
+using myMuduo::net::Buffer;
+
+namespace {
+
+const int64_t kMinDurationNanos = 200 * 1000 * 1000;
+const char kCRLF[] = "\r\n";
+
+volatile size_t g_sink = 0;
+
+template <typename Func>
+void measure(const char* caseName, const char* impl, size_t size, Func func)
+{
+    int64_t start = bench::nowNanos();
+    int64_t elapsed = 0;
+    size_t iterations = 0;
+    while (elapsed < kMinDurationNanos)
+    {
+        g_sink += func();
+        ++iterations;
+        elapsed = bench::nowNanos() - start;
+    }
+    double seconds = static_cast<double>(elapsed) / 1e9;
+    bench::JsonLine("buffer_search")
+        .add("case", caseName)
+        .add("impl", impl)
+        .add("size", size)
+        .add("ns_per_op", static_cast<double>(elapsed) / static_cast<double>(iterations))
+        .add("gb_per_sec", static_cast<double>(iterations * size) / seconds / 1e9)
+        .print();
+}
+
+//大部分是普通字符 夹杂少量'\r'模拟真实的文本协议
+std::string makeText(size_t size)
+{
+    std::string text(size, 'a');
+    for (size_t i = 97; i + 1 < size; i += 97)
+    {
+        text[i] = '\r';
+    }
+    text[size - 2] = '\r';
+    text[size - 1] = '\n';
+    return text;
+}
+
+void scanCases()
+{
+    const size_t sizes[] = {64, 256, 1024, 4096, 16384, 65536};
+    for (size_t size : sizes)
+    {
+        std::string text = makeText(size);
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+
+        measure("crlf_scan", "std_search", size,
+                [&]() { return static_cast<size_t>(std::search(begin, end, kCRLF, kCRLF + 2) - begin); });
+        measure("crlf_scan", myMuduo::base::byteSearchImplementation(), size,
+                [&]() { return static_cast<size_t>(myMuduo::base::findCRLF(begin, end) - begin); });
+
+        measure("byte_scan", "std_find", size,
+                [&]() { return static_cast<size_t>(std::find(begin, end, '\n') - begin); });
+        measure("byte_scan", "memchr", size, [&]() {
+            return static_cast<size_t>(static_cast<const char*>(memchr(begin, '\n', text.size())) - begin);
+        });
+        measure("byte_scan", "findEOL", size,
+                [&]() { return static_cast<size_t>(myMuduo::base::findEOL(begin, end) - begin); });
+    }
+}
+
+//每次到达chunk字节 每次到达后查找一次 直到找到行尾
+void incrementalCases()
+{
+    const size_t chunk = 512;
+    const size_t sizes[] = {4096, 65536, 256 * 1024};
+    for (size_t size : sizes)
+    {
+        std::string text = makeText(size);
+
+        measure("crlf_incremental", "rescan_std_search", size, [&]() {
+            Buffer buf;
+            size_t found = 0;
+            for (size_t off = 0; off < text.size(); off += chunk)
+            {
+                buf.append(text.data() + off, std::min(chunk, text.size() - off));
+                const char* begin = buf.peek();
+                const char* end = begin + buf.readableBytesLength();
+                const char* crlf = std::search(begin, end, kCRLF, kCRLF + 2);
+                if (crlf != end) found = static_cast<size_t>(crlf - begin);
+            }
+            return found;
+        });
+
+        measure("crlf_incremental", "resume_findCRLF", size, [&]() {
+            Buffer buf;
+            size_t found = 0;
+            for (size_t off = 0; off < text.size(); off += chunk)
+            {
+                buf.append(text.data() + off, std::min(chunk, text.size() - off));
+                const char* crlf = buf.findCRLF();
+                if (crlf != nullptr) found = static_cast<size_t>(crlf - buf.peek());
+            }
+            return found;
+        });
+    }
+}
+
+}  // namespace
+
+int main()
+{
+    scanCases();
+    incrementalCases();
+    return 0;
+}
@@ -0,0 +1,180 @@
+//忙等模式测试 服务端loop在单独的线程中 分别设置不同的忙等时间
+//pingpong: 一条连接上一问一答的往返延迟
+//queue: 主线程queueInLoop到服务端loop 从提交到执行的延迟 忙等时不写eventfd
+//每种模式输出p50/p99和log2直方图 忙等会占满一个核 单核机器上反而更慢
+//用法: busypoll_bench [port] [rounds] [spinMicros 如0,50,1000]
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/TcpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const size_t kMessageSize = 64;
+
+double percentileMicros(const std::vector<int64_t>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+void report(const char* test, int64_t spinMicros, std::vector<int64_t>& latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    bench::JsonLine("busypoll")
+        .add("test", test)
+        .add("spin_us", spinMicros)
+        .add("samples", latencies.size())
+        .add("p50_us", percentileMicros(latencies, 0.50))
+        .add("p99_us", percentileMicros(latencies, 0.99))
+        .add("p999_us", percentileMicros(latencies, 0.999))
+        .addRaw("hist_us", bench::log2Histogram(latencies))
+        .print();
+}
+
+//客户端在主线程的loop中 一问一答rounds次
+std::vector<int64_t> pingpong(EventLoop* loop, const InetAddress& serverAddr, int rounds)
+{
+    std::vector<int64_t> latencies;
+    latencies.reserve(rounds);
+    std::string message(kMessageSize, 'p');
+    int64_t start = 0;
+
+    TcpClient client(loop, serverAddr, "busypoll_bench");
+    client.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if (conn->connected())
+        {
+            conn->setTcpNoDelay(true);
+            start = bench::nowNanos();
+            conn->send(message);
+        }
+    });
+    client.setMessageCallback([&](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+        if (buf->readableBytesLength() < kMessageSize)
+        {
+            return;
+        }
+        buf->retrieve(kMessageSize);
+        latencies.push_back(bench::nowNanos() - start);
+        if (static_cast<int>(latencies.size()) < rounds)
+        {
+            start = bench::nowNanos();
+            conn->send(message);
+        }
+        else
+        {
+            loop->quit();
+        }
+    });
+    client.connect();
+    loop->loop();
+    client.disconnect();
+    //等连接关闭的回调执行完
+    loop->runAfter(0.01, [loop]() { loop->quit(); });
+    loop->loop();
+    return latencies;
+}
+
+std::vector<int64_t> queueLatency(EventLoop* serverLoop, int rounds)
+{
+    std::vector<int64_t> latencies;
+    latencies.reserve(rounds);
+    std::atomic<int64_t> executed(0);
+    for (int i = 0; i < rounds; ++i)
+    {
+        executed.store(0);
+        int64_t start = bench::nowNanos();
+        serverLoop->queueInLoop([&executed]() { executed.store(bench::nowNanos()); });
+        int64_t end = 0;
+        while ((end = executed.load()) == 0)
+        {
+        }
+        latencies.push_back(end - start);
+    }
+    return latencies;
+}
+
+std::vector<int64_t> parseList(const char* arg)
+{
+    std::vector<int64_t> values;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        values.push_back(atoll(item.c_str()));
+    }
+    return values;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18230);
+    int rounds = argc > 2 ? atoi(argv[2]) : 20000;
+    std::vector<int64_t> spins = parseList(argc > 3 ? argv[3] : "0,50,1000");
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoopThread serverThread(ThreadInitCallback(), "busypoll-server");
+    EventLoop* serverLoop = serverThread.startLoop();
+    std::unique_ptr<TcpServer> server;
+    std::promise<void> started;
+    serverLoop->runInLoop([&]() {
+        server.reset(new TcpServer(serverLoop, InetAddress(port, true), "busypoll_bench"));
+        server->setConnectionCallback([](const TcpConnectionPtr& conn) {
+            if (conn->connected())
+            {
+                conn->setTcpNoDelay(true);
+            }
+        });
+        server->setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) { conn->send(buf); });
+        server->start();
+        started.set_value();
+    });
+    started.get_future().wait();
+
+    EventLoop loop;
+    InetAddress serverAddr("127.0.0.1", port);
+    for (int64_t spin : spins)
+    {
+        serverLoop->setBusyPoll(spin);
+        //唤醒一次 让新的设置在下一轮生效
+        serverLoop->wakeup();
+
+        std::vector<int64_t> latencies = pingpong(&loop, serverAddr, rounds);
+        report("pingpong", spin, latencies);
+
+        latencies = queueLatency(serverLoop, rounds);
+        report("queue", spin, latencies);
+    }
+
+    //TcpServer在它的loop线程中析构
+    serverLoop->setBusyPoll(0);
+    std::promise<void> destroyed;
+    serverLoop->runInLoop([&]() {
+        server.reset();
+        destroyed.set_value();
+    });
+    destroyed.get_future().wait();
+    return 0;
+}
@@ -0,0 +1,178 @@
+//编解码吞吐测试 不经过网络 只测从inputBuffer_切分消息的开销
+//view: LengthHeaderCodec/DelimiterCodec 回调拿到指向Buffer内部的视图
+//copy: 手写的切分方式 每条消息retrieveAsString一次
+//fields: [int32长度][int16类型][int64 id][varint值][消息体] 逐个字段readInt 消息越小越依赖Buffer访问函数的内联
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/codec/DelimiterCodec.h"
+#include "myMuduo/net/codec/LengthHeaderCodec.h"
+
+using myMuduo::Timestamp;
+using myMuduo::base::StringPiece;
+using myMuduo::net::Buffer;
+using myMuduo::net::DelimiterCodec;
+using myMuduo::net::LengthHeaderCodec;
+using myMuduo::net::TcpConnectionPtr;
+
+namespace {
+
+const size_t kBatchBytes = 4 * 1024 * 1024;
+const int64_t kMinDurationNanos = 300 * 1000 * 1000;
+
+volatile size_t g_sink = 0;
+
+std::string makeLengthFrames(const LengthHeaderCodec& codec, size_t messageSize, size_t* count)
+{
+    std::string payload(messageSize, 'x');
+    Buffer buf;
+    *count = kBatchBytes / (messageSize + codec.headerLength()) + 1;
+    for (size_t i = 0; i < *count; ++i)
+    {
+        Buffer one;
+        codec.encode(&one, payload);
+        buf.append(one.peek(), one.readableBytesLength());
+    }
+    return buf.retrieveAllAsString();
+}
+
+std::string makeLines(size_t messageSize, size_t* count)
+{
+    std::string line(messageSize, 'x');
+    line += "\r\n";
+    *count = kBatchBytes / line.size() + 1;
+    std::string data;
+    data.reserve(*count * line.size());
+    for (size_t i = 0; i < *count; ++i)
+    {
+        data += line;
+    }
+    return data;
+}
+
+std::string makeFieldRecords(size_t messageSize, size_t* count)
+{
+    std::string payload(messageSize, 'x');
+    Buffer buf;
+    Buffer body;
+    *count = 0;
+    while (buf.readableBytesLength() < kBatchBytes)
+    {
+        body.appendInt16(static_cast<int16_t>(*count & 0xff));
+        body.appendInt64(static_cast<int64_t>(*count));
+        body.appendVarint64(*count * 131);
+        body.append(payload.data(), payload.size());
+        buf.appendInt32(static_cast<int32_t>(body.readableBytesLength()));
+        buf.append(body.peek(), body.readableBytesLength());
+        body.retrieveAll();
+        ++(*count);
+    }
+    return buf.retrieveAllAsString();
+}
+
+//只读取不消耗 解析函数拿const Buffer&就够了
+bool hasCompleteRecord(const Buffer& buf)
+{
+    return buf.readableBytesLength() >= sizeof(int32_t) &&
+           buf.readableBytesLength() - sizeof(int32_t) >= static_cast<uint32_t>(buf.peekInt32());
+}
+
+//fill和decode分开计时 只统计decode
+template <typename Decode>
+void run(const char* codecName, const char* mode, size_t messageSize, const std::string& data, size_t count,
+         Decode decode)
+{
+    Buffer buf;
+    int64_t elapsed = 0;
+    size_t messages = 0;
+    while (elapsed < kMinDurationNanos)
+    {
+        buf.append(data.data(), data.size());
+        int64_t start = bench::nowNanos();
+        decode(&buf);
+        elapsed += bench::nowNanos() - start;
+        messages += count;
+    }
+    double seconds = static_cast<double>(elapsed) / 1e9;
+    bench::JsonLine("codec")
+        .add("codec", codecName)
+        .add("mode", mode)
+        .add("msg_size", messageSize)
+        .add("msgs_per_sec", static_cast<double>(messages) / seconds)
+        .add("mb_per_sec", static_cast<double>(messages * messageSize) / seconds / (1024 * 1024))
+        .print();
+}
+
+}  // namespace
+
+int main()
+{
+    const size_t sizes[] = {16, 64, 256, 1024, 4096, 16384, 65536};
+    TcpConnectionPtr noConn;
+
+    for (size_t size : sizes)
+    {
+        LengthHeaderCodec codec([](const TcpConnectionPtr&, const StringPiece& msg, Timestamp) { g_sink += msg.size(); });
+        size_t count = 0;
+        std::string frames = makeLengthFrames(codec, size, &count);
+
+        run("length4", "view", size, frames, count,
+            [&](Buffer* buf) { codec.onMessage(noConn, buf, Timestamp()); });
+
+        run("length4", "copy", size, frames, count, [&](Buffer* buf) {
+            while (buf->readableBytesLength() >= 4)
+            {
+                std::string header(buf->peek(), 4);
+                uint32_t len = (static_cast<uint8_t>(header[0]) << 24) | (static_cast<uint8_t>(header[1]) << 16) |
+                               (static_cast<uint8_t>(header[2]) << 8) | static_cast<uint8_t>(header[3]);
+                if (buf->readableBytesLength() < 4 + len) break;
+                buf->retrieve(4);
+                std::string msg = buf->retrieveAsString(len);
+                g_sink += msg.size();
+            }
+        });
+    }
+
+    for (size_t size : sizes)
+    {
+        size_t count = 0;
+        std::string records = makeFieldRecords(size, &count);
+
+        run("fields", "view", size, records, count, [&](Buffer* buf) {
+            while (hasCompleteRecord(*buf))
+            {
+                size_t length = static_cast<size_t>(buf->readInt32());
+                size_t remaining = buf->readableBytesLength() - length;
+                int16_t type = buf->readInt16();
+                int64_t id = buf->readInt64();
+                uint64_t value = 0;
+                buf->readVarint64(&value);
+                //剩下的是消息体
+                size_t bodyLength = buf->readableBytesLength() - remaining;
+                g_sink += static_cast<size_t>(type) + static_cast<size_t>(id) + value + bodyLength;
+                buf->retrieve(bodyLength);
+            }
+        });
+    }
+
+    for (size_t size : sizes)
+    {
+        DelimiterCodec codec([](const TcpConnectionPtr&, const StringPiece& msg, Timestamp) { g_sink += msg.size(); });
+        size_t count = 0;
+        std::string lines = makeLines(size, &count);
+
+        run("crlf", "view", size, lines, count, [&](Buffer* buf) { codec.onMessage(noConn, buf, Timestamp()); });
+
+        run("crlf", "copy", size, lines, count, [&](Buffer* buf) {
+            const char* crlf = nullptr;
+            while ((crlf = buf->findCRLF()) != nullptr)
+            {
+                std::string msg = buf->retrieveAsString(crlf - buf->peek());
+                buf->retrieve(2);
+                g_sink += msg.size();
+            }
+        });
+    }
+    return 0;
+}
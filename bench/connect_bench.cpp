@@ -0,0 +1,182 @@
+//建立/关闭连接速率测试 服务端接受连接后立即shutdown 模拟短连接
+//客户端concurrency个TcpClient开启重连 连接被关闭后马上重新连接
+//统计每秒完成的连接数 以及从发起连接到连接建立回调的延迟
+//用法: connect_bench [port] [seconds] [concurrency] [serverThreads]
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/TcpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+//只在客户端loop线程中使用
+class LoadGenerator : noncopyable
+{
+public:
+    LoadGenerator(EventLoop* loop, const InetAddress& serverAddr, int concurrency)
+        : cycles_(0)
+        , recording_(false)
+    {
+        for (int i = 0; i < concurrency; ++i)
+        {
+            std::unique_ptr<TcpClient> client(new TcpClient(loop, serverAddr, "connect_bench" + std::to_string(i)));
+            client->enableRetry();
+            std::shared_ptr<int64_t> start = std::make_shared<int64_t>(0);
+            client->setConnectionCallback([this, start](const TcpConnectionPtr& conn) {
+                int64_t now = bench::nowNanos();
+                if (conn->connected())
+                {
+                    if (recording_)
+                    {
+                        latencies_.push_back(now - *start);
+                    }
+                }
+                else
+                {
+                    if (recording_)
+                    {
+                        ++cycles_;
+                    }
+                    //TcpClient::removeConnection随后立即重连
+                    *start = now;
+                }
+            });
+            starts_.push_back(start);
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    void start()
+    {
+        for (size_t i = 0; i < clients_.size(); ++i)
+        {
+            *starts_[i] = bench::nowNanos();
+            clients_[i]->connect();
+        }
+    }
+
+    void startRecording() { recording_ = true; }
+
+    //停止重连 返回完成的连接数 之后TcpClient析构时关闭连接的回调不再访问LoadGenerator
+    int64_t stop()
+    {
+        recording_ = false;
+        for (auto& client : clients_)
+        {
+            client->stop();
+            client->setConnectionCallback([](const TcpConnectionPtr&) {});
+            TcpConnectionPtr conn = client->connection();
+            if (conn)
+            {
+                conn->setConnectionCallback([](const TcpConnectionPtr&) {});
+            }
+        }
+        return cycles_;
+    }
+
+    std::vector<int64_t>& latencies() { return latencies_; }
+
+private:
+    int64_t cycles_;
+    bool recording_;
+    std::vector<int64_t> latencies_;
+    std::vector<std::shared_ptr<int64_t>> starts_;
+    std::vector<std::unique_ptr<TcpClient>> clients_;
+};
+
+double percentileMicros(const std::vector<int64_t>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18220);
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    int concurrency = argc > 3 ? atoi(argv[3]) : 8;
+    int serverThreads = argc > 4 ? atoi(argv[4]) : 1;
+    const double warmupSeconds = 0.2;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(port, true), "connect_server");
+    server.setThreadNum(serverThreads);
+    server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+        if (conn->connected())
+        {
+            conn->shutdown();
+        }
+    });
+    server.start();
+
+    EventLoopThread clientThread(ThreadInitCallback(), "bench-client");
+    EventLoop* clientLoop = clientThread.startLoop();
+    std::unique_ptr<LoadGenerator> generator(new LoadGenerator(clientLoop, InetAddress("127.0.0.1", port), concurrency));
+    clientLoop->runInLoop([&]() { generator->start(); });
+
+    int64_t startNanos = 0;
+    int64_t endNanos = 0;
+    int64_t cycles = 0;
+    loop.runAfter(warmupSeconds, [&]() {
+        clientLoop->runInLoop([&]() { generator->startRecording(); });
+        startNanos = bench::nowNanos();
+    });
+    loop.runAfter(warmupSeconds + seconds, [&]() {
+        std::promise<void> stopped;
+        clientLoop->runInLoop([&]() {
+            cycles = generator->stop();
+            stopped.set_value();
+        });
+        stopped.get_future().wait();
+        endNanos = bench::nowNanos();
+        loop.quit();
+    });
+    loop.loop();
+
+    std::promise<void> destroyed;
+    std::vector<int64_t> latencies;
+    clientLoop->runInLoop([&]() {
+        latencies.swap(generator->latencies());
+        generator.reset();
+        //TcpClient析构后连接的关闭要再经过几次queueInLoop 等它们执行完
+        clientLoop->runAfter(0.01, [&]() { destroyed.set_value(); });
+    });
+    destroyed.get_future().wait();
+
+    std::sort(latencies.begin(), latencies.end());
+    double elapsed = static_cast<double>(endNanos - startNanos) / 1e9;
+    bench::JsonLine("connect")
+        .add("concurrency", concurrency)
+        .add("server_threads", serverThreads)
+        .add("seconds", elapsed)
+        .add("connections_per_sec", static_cast<double>(cycles) / elapsed)
+        .add("connect_p50_us", percentileMicros(latencies, 0.50))
+        .add("connect_p99_us", percentileMicros(latencies, 0.99))
+        .add("connect_p999_us", percentileMicros(latencies, 0.999))
+        .print();
+
+    //服务端连接关闭的回调还在baseLoop中排队 处理完再析构服务器
+    loop.runAfter(0.05, [&]() { loop.quit(); });
+    loop.loop();
+    return 0;
+}
@@ -0,0 +1,268 @@
+//写合并测试 服务端每收到一个请求分三次send响应(响应头 消息体 尾部) 模拟请求处理流水线
+//每条连接同时有pipeline个请求在路上 收到完整响应后立即发下一个
+//依次测试三种模式 none: 每次send都尝试直接write cork: 一次onMessage前后cork/uncork auto: setAutoCork(true)
+//统计每秒完成的响应数 以及服务端每个响应的write系统调用次数(ConnectionStats::kWriteCalls)
+//用法: cork_bench [port] [seconds] [connections] [pipeline] [bodySize]
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/ConnectionStats.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/TcpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const size_t kRequestSize = 32;
+const size_t kHeaderSize = 64;
+const size_t kTrailerSize = 8;
+const double kConnectTimeoutSeconds = 30.0;
+
+enum Mode
+{
+    kNone,
+    kCork,
+    kAuto
+};
+
+const char* modeName(Mode mode)
+{
+    switch (mode)
+    {
+        case kCork:
+            return "cork";
+        case kAuto:
+            return "auto";
+        default:
+            return "none";
+    }
+}
+
+//只在客户端loop线程中使用 connected_和responses_可以在其他线程读
+class LoadGenerator : noncopyable
+{
+public:
+    LoadGenerator(EventLoop* loop, const InetAddress& serverAddr, int connections, int pipeline, size_t responseSize)
+        : request_(kRequestSize, 'q')
+        , pipeline_(pipeline)
+        , responseSize_(responseSize)
+        , connected_(0)
+        , responses_(0)
+        , running_(true)
+    {
+        for (int i = 0; i < connections; ++i)
+        {
+            std::unique_ptr<TcpClient> client(new TcpClient(loop, serverAddr, "cork_bench" + std::to_string(i)));
+            client->setConnectionCallback([this](const TcpConnectionPtr& conn) {
+                if (conn->connected())
+                {
+                    conn->setTcpNoDelay(true);
+                    connected_.store(connected_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    for (int j = 0; j < pipeline_; ++j)
+                    {
+                        conn->send(request_);
+                    }
+                }
+            });
+            client->setMessageCallback([this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+                while (buf->readableBytesLength() >= responseSize_)
+                {
+                    buf->retrieve(responseSize_);
+                    responses_.store(responses_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    if (running_)
+                    {
+                        conn->send(request_);
+                    }
+                }
+            });
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    void connect()
+    {
+        for (auto& client : clients_)
+        {
+            client->connect();
+        }
+    }
+
+    //停止发送新请求 之后到达的响应直接丢弃
+    void stop()
+    {
+        running_ = false;
+        for (auto& client : clients_)
+        {
+            client->setConnectionCallback([](const TcpConnectionPtr&) {});
+            TcpConnectionPtr conn = client->connection();
+            if (conn)
+            {
+                conn->setMessageCallback([](const TcpConnectionPtr&, Buffer* buf, Timestamp) { buf->retrieveAll(); });
+            }
+        }
+    }
+
+    int connected() const { return connected_.load(std::memory_order_relaxed); }
+    int64_t responses() const { return responses_.load(std::memory_order_relaxed); }
+
+private:
+    const std::string request_;
+    const int pipeline_;
+    const size_t responseSize_;
+    std::atomic<int> connected_;
+    std::atomic<int64_t> responses_;
+    bool running_;
+    std::vector<std::unique_ptr<TcpClient>> clients_;
+};
+
+//在loop线程中执行func 等待完成
+template <typename Func>
+void runAndWait(EventLoop* loop, Func func)
+{
+    std::promise<void> done;
+    loop->runInLoop([&]() {
+        func();
+        done.set_value();
+    });
+    done.get_future().wait();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18600);
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    int connections = argc > 3 ? atoi(argv[3]) : 10;
+    int pipeline = argc > 4 ? atoi(argv[4]) : 4;
+    size_t bodySize = static_cast<size_t>(argc > 5 ? atoi(argv[5]) : 256);
+
+    spdlog::set_level(spdlog::level::warn);
+
+    const std::string header(kHeaderSize, 'h');
+    const std::string body(bodySize, 'b');
+    const std::string trailer(kTrailerSize, 't');
+    const size_t responseSize = header.size() + body.size() + trailer.size();
+
+    EventLoop loop;
+    EventLoopThread clientThread(ThreadInitCallback(), "cork_client");
+    EventLoop* clientLoop = clientThread.startLoop();
+
+    //每种模式一个服务器 都保留到最后 上一轮连接关闭的回调还会在baseLoop中执行
+    std::vector<std::unique_ptr<TcpServer>> servers;
+    //当前模式的服务端连接 在服务端io线程中加入
+    std::mutex mutex;
+    std::vector<TcpConnectionPtr> serverConns;
+    const Mode modes[] = {kNone, kCork, kAuto};
+    for (Mode mode : modes)
+    {
+        servers.emplace_back(new TcpServer(&loop, InetAddress(port, true), "cork_server"));
+        TcpServer& server = *servers.back();
+        server.setThreadNum(1);
+        server.setConnectionCallback([&, mode](const TcpConnectionPtr& conn) {
+            if (conn->connected())
+            {
+                conn->setTcpNoDelay(true);
+                if (mode == kAuto)
+                {
+                    conn->setAutoCork(true);
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                serverConns.push_back(conn);
+            }
+        });
+        server.setMessageCallback([&, mode](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+            if (mode == kCork)
+            {
+                conn->cork();
+            }
+            while (buf->readableBytesLength() >= kRequestSize)
+            {
+                buf->retrieve(kRequestSize);
+                conn->send(header);
+                conn->send(body);
+                conn->send(trailer);
+            }
+            if (mode == kCork)
+            {
+                conn->uncork();
+            }
+        });
+        server.start();
+
+        std::unique_ptr<LoadGenerator> generator;
+        runAndWait(clientLoop, [&]() {
+            generator.reset(
+                new LoadGenerator(clientLoop, InetAddress("127.0.0.1", port), connections, pipeline, responseSize));
+            generator->connect();
+        });
+
+        //等待连接全部建立
+        int64_t connectStart = bench::nowNanos();
+        base::TimerId poll = loop.runEvery(0.01, [&]() {
+            if (generator->connected() == connections ||
+                bench::nowNanos() - connectStart > static_cast<int64_t>(kConnectTimeoutSeconds * 1e9))
+            {
+                loop.quit();
+            }
+        });
+        loop.loop();
+        loop.cancel(poll);
+
+        auto writeCalls = [&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            uint64_t total = 0;
+            for (const TcpConnectionPtr& conn : serverConns)
+            {
+                total += conn->stats().get(ConnectionStats::kWriteCalls);
+            }
+            return total;
+        };
+        uint64_t writeCallsBefore = writeCalls();
+        int64_t responsesBefore = generator->responses();
+        int64_t startNanos = bench::nowNanos();
+        loop.runAfter(seconds, [&]() { loop.quit(); });
+        loop.loop();
+        int64_t responses = generator->responses() - responsesBefore;
+        uint64_t writes = writeCalls() - writeCallsBefore;
+        double elapsed = static_cast<double>(bench::nowNanos() - startNanos) / 1e9;
+
+        bench::JsonLine("cork")
+            .add("mode", modeName(mode))
+            .add("connections", generator->connected())
+            .add("pipeline", pipeline)
+            .add("response_size", responseSize)
+            .add("seconds", elapsed)
+            .add("responses_per_sec", static_cast<double>(responses) / elapsed)
+            .add("write_calls_per_response",
+                 responses > 0 ? static_cast<double>(writes) / static_cast<double>(responses) : 0.0)
+            .print();
+
+        runAndWait(clientLoop, [&]() { generator->stop(); });
+        //等最后一批响应到达并丢弃 带着未读数据close会发RST 服务端会打印错误
+        loop.runAfter(0.2, [&]() { loop.quit(); });
+        loop.loop();
+        //TcpClient析构后连接的关闭要再经过几次queueInLoop 等它们执行完
+        runAndWait(clientLoop, [&]() { generator.reset(); });
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            serverConns.clear();
+        }
+        loop.runAfter(0.2, [&]() { loop.quit(); });
+        loop.loop();
+        ++port;
+    }
+    return 0;
+}
@@ -0,0 +1,197 @@
+//协程层开销测试 按行回显 服务端分别用回调和协程实现 比较每秒处理的行数
+//客户端每次发送pipeline行 全部收到回显后再发下一批
+//用法: coro_bench [port] [seconds] [pipeline]
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include "bench/BenchUtil.h"
+#include "myMuduo/base/ByteSearch.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/TcpServer.h"
+#include "myMuduo/net/coro/CoConnection.h"
+#include "myMuduo/net/coro/Task.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const size_t kLineLength = 32;
+
+coro::Task<void> echoSession(TcpConnectionPtr conn)
+{
+    coro::CoConnection c(conn);
+    std::string reply;
+    while (true)
+    {
+        base::StringPiece line = co_await c.readUntil("\r\n");
+        if (line.empty())
+        {
+            break;
+        }
+        reply.assign(line.data(), line.size());
+        if (!co_await c.write(reply))
+        {
+            break;
+        }
+    }
+    conn->shutdown();
+}
+
+void callbackEcho(const TcpConnectionPtr& conn, Buffer* buf, Timestamp)
+{
+    while (true)
+    {
+        const char* crlf = base::findCRLF(buf->peek(), buf->peek() + buf->readableBytesLength());
+        if (crlf == nullptr)
+        {
+            break;
+        }
+        size_t length = static_cast<size_t>(crlf - buf->peek()) + 2;
+        conn->send(std::string(buf->peek(), length));
+        buf->retrieve(length);
+    }
+}
+
+//只在客户端loop线程中使用
+class LoadGenerator : noncopyable
+{
+public:
+    LoadGenerator(EventLoop* loop, const InetAddress& serverAddr, int pipeline)
+        : client_(loop, serverAddr, "coro_bench")
+        , recording_(false)
+        , stopped_(false)
+        , outstanding_(0)
+        , lines_(0)
+    {
+        std::string line(kLineLength, 'x');
+        line += "\r\n";
+        for (int i = 0; i < pipeline; ++i)
+        {
+            batch_ += line;
+        }
+        client_.setConnectionCallback([this](const TcpConnectionPtr& conn) {
+            if (conn->connected())
+            {
+                conn->setTcpNoDelay(true);
+                issue(conn);
+            }
+        });
+        client_.setMessageCallback([this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+            size_t replies = static_cast<size_t>(std::count(buf->peek(), buf->peek() + buf->readableBytesLength(), '\n'));
+            buf->retrieveAll();
+            outstanding_ -= replies;
+            if (recording_ && !stopped_)
+            {
+                lines_ += static_cast<int64_t>(replies);
+            }
+            if (outstanding_ == 0 && !stopped_)
+            {
+                issue(conn);
+            }
+        });
+    }
+
+    void start() { client_.connect(); }
+    void startRecording() { recording_ = true; }
+    void stop() { stopped_ = true; }
+    int64_t lines() const { return lines_; }
+
+private:
+    void issue(const TcpConnectionPtr& conn)
+    {
+        outstanding_ = batch_.size() / (kLineLength + 2);
+        conn->send(batch_);
+    }
+
+    TcpClient client_;
+    std::string batch_;
+    bool recording_;
+    bool stopped_;
+    size_t outstanding_;
+    int64_t lines_;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18150);
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    int pipeline = argc > 3 ? atoi(argv[3]) : 16;
+    const double warmupSeconds = 0.3;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    bool useCoroutine = false;
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(port, true), "coro_bench");
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if (conn->connected())
+        {
+            conn->setTcpNoDelay(true);
+            if (useCoroutine)
+            {
+                coro::spawn(echoSession(conn));
+            }
+        }
+    });
+    server.setMessageCallback(callbackEcho);
+    server.start();
+
+    EventLoopThread clientThread;
+    EventLoop* clientLoop = clientThread.startLoop();
+    InetAddress serverAddr("127.0.0.1", port);
+
+    const char* modes[] = {"callback", "coroutine"};
+    for (const char* mode : modes)
+    {
+        useCoroutine = std::string(mode) == "coroutine";
+        std::shared_ptr<LoadGenerator> generator;
+        std::promise<void> created;
+        clientLoop->runInLoop([&]() {
+            generator.reset(new LoadGenerator(clientLoop, serverAddr, pipeline));
+            generator->start();
+            created.set_value();
+        });
+        created.get_future().wait();
+
+        int64_t startNanos = 0;
+        int64_t endNanos = 0;
+        loop.runAfter(warmupSeconds, [&]() {
+            clientLoop->runInLoop([generator]() { generator->startRecording(); });
+            startNanos = bench::nowNanos();
+        });
+        loop.runAfter(warmupSeconds + seconds, [&]() {
+            clientLoop->runInLoop([generator]() { generator->stop(); });
+            endNanos = bench::nowNanos();
+            loop.quit();
+        });
+        loop.loop();
+
+        std::promise<void> destroyed;
+        int64_t lines = 0;
+        clientLoop->runInLoop([&]() {
+            lines = generator->lines();
+            generator.reset();
+            //TcpClient析构后连接的关闭要再经过几次queueInLoop 等它们执行完
+            clientLoop->runAfter(0.01, [&]() { destroyed.set_value(); });
+        });
+        destroyed.get_future().wait();
+
+        double elapsed = static_cast<double>(endNanos - startNanos) / 1e9;
+        bench::JsonLine("coro")
+            .add("mode", mode)
+            .add("pipeline", pipeline)
+            .add("lines_per_sec", static_cast<double>(lines) / elapsed)
+            .print();
+    }
+    return 0;
+}
@@ -0,0 +1,252 @@
+//回显QPS测试 每条连接同时只有一个请求在路上 收到完整回显后立即发下一个
+//依次测试connections中的每个连接数 连接全部建立后再开始计时
+//每条连接在两端各占一个fd 启动时把RLIMIT_NOFILE提到硬上限 不够时按上限减少连接数并在结果中注明
+//用法: echo_bench [port] [seconds] [connections 如1,100,10000] [serverThreads] [clientThreads] [messageSize]
+#include <sys/resource.h>
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThreadPool.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/TcpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const double kConnectTimeoutSeconds = 30.0;
+
+//一个客户端loop上的所有连接 只在该loop线程中使用
+class LoadGenerator : noncopyable
+{
+public:
+    LoadGenerator(EventLoop* loop, const InetAddress& serverAddr, int connections, size_t messageSize)
+        : loop_(loop)
+        , message_(messageSize, 'e')
+        , connected_(0)
+        , requests_(0)
+        , running_(false)
+    {
+        for (int i = 0; i < connections; ++i)
+        {
+            std::unique_ptr<TcpClient> client(new TcpClient(loop, serverAddr, "echo_bench" + std::to_string(i)));
+            client->setConnectionCallback([this](const TcpConnectionPtr& conn) {
+                if (conn->connected())
+                {
+                    conn->setTcpNoDelay(true);
+                    ++connected_;
+                }
+            });
+            client->setMessageCallback([this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+                while (buf->readableBytesLength() >= message_.size())
+                {
+                    buf->retrieve(message_.size());
+                    ++requests_;
+                    if (running_)
+                    {
+                        conn->send(message_);
+                    }
+                }
+            });
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    void connect()
+    {
+        for (auto& client : clients_)
+        {
+            client->connect();
+        }
+    }
+
+    int connected() const { return connected_; }
+
+    void start()
+    {
+        running_ = true;
+        for (auto& client : clients_)
+        {
+            TcpConnectionPtr conn = client->connection();
+            if (conn)
+            {
+                conn->send(message_);
+            }
+        }
+    }
+
+    //返回停止前完成的请求数 之后到达的回显直接丢弃 不再访问LoadGenerator
+    int64_t stop()
+    {
+        running_ = false;
+        for (auto& client : clients_)
+        {
+            TcpConnectionPtr conn = client->connection();
+            if (conn)
+            {
+                conn->setMessageCallback([](const TcpConnectionPtr&, Buffer* buf, Timestamp) { buf->retrieveAll(); });
+            }
+        }
+        return requests_;
+    }
+
+    EventLoop* loop() const { return loop_; }
+
+private:
+    EventLoop* loop_;
+    const std::string message_;
+    int connected_;
+    int64_t requests_;
+    bool running_;
+    std::vector<std::unique_ptr<TcpClient>> clients_;
+};
+
+std::vector<int> parseList(const char* arg)
+{
+    std::vector<int> values;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        values.push_back(atoi(item.c_str()));
+    }
+    return values;
+}
+
+//返回可以同时打开的fd数
+int64_t raiseFdLimit()
+{
+    struct rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    return static_cast<int64_t>(limit.rlim_cur);
+}
+
+//在每个客户端loop线程中执行func 等待全部完成
+template <typename Func>
+void forEachGenerator(std::vector<std::unique_ptr<LoadGenerator>>& generators, Func func)
+{
+    for (auto& generator : generators)
+    {
+        std::promise<void> done;
+        generator->loop()->runInLoop([&]() {
+            func(generator);
+            done.set_value();
+        });
+        done.get_future().wait();
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18210);
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    std::vector<int> connectionList = parseList(argc > 3 ? argv[3] : "1,100,10000");
+    int serverThreads = argc > 4 ? atoi(argv[4]) : 1;
+    int clientThreads = argc > 5 ? atoi(argv[5]) : 1;
+    size_t messageSize = static_cast<size_t>(argc > 6 ? atoi(argv[6]) : 64);
+
+    spdlog::set_level(spdlog::level::warn);
+    //客户端和服务端各一个fd 再留一些给epoll eventfd timerfd和监听socket
+    const int64_t maxConnections = (raiseFdLimit() - 64) / 2;
+
+    EventLoop loop;
+    EventLoopThreadPool clientPool(&loop, "echo_client");
+    clientPool.setThreadNum(clientThreads);
+    clientPool.start();
+
+    //每个连接数一个服务器 都保留到最后 上一轮连接关闭的回调还会在baseLoop中执行
+    std::vector<std::unique_ptr<TcpServer>> servers;
+    for (int requested : connectionList)
+    {
+        int connections = static_cast<int>(std::min<int64_t>(requested, maxConnections));
+        servers.emplace_back(new TcpServer(&loop, InetAddress(port, true), "echo_server"));
+        TcpServer& server = *servers.back();
+        server.setThreadNum(serverThreads);
+        server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+            if (conn->connected())
+            {
+                conn->setTcpNoDelay(true);
+            }
+        });
+        server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) { conn->send(buf); });
+        server.start();
+
+        std::vector<std::unique_ptr<LoadGenerator>> generators;
+        std::vector<EventLoop*> clientLoops = clientPool.getAllLoops();
+        for (size_t i = 0; i < clientLoops.size(); ++i)
+        {
+            int share = connections / static_cast<int>(clientLoops.size()) +
+                        (static_cast<int>(i) < connections % static_cast<int>(clientLoops.size()) ? 1 : 0);
+            generators.emplace_back(new LoadGenerator(clientLoops[i], InetAddress("127.0.0.1", port), share, messageSize));
+        }
+        forEachGenerator(generators, [](std::unique_ptr<LoadGenerator>& g) { g->connect(); });
+
+        //等待连接全部建立
+        int64_t connectStart = bench::nowNanos();
+        int64_t startNanos = 0;
+        int established = 0;
+        base::TimerId poll = loop.runEvery(0.01, [&]() {
+            established = 0;
+            forEachGenerator(generators, [&](std::unique_ptr<LoadGenerator>& g) { established += g->connected(); });
+            if (established == connections ||
+                bench::nowNanos() - connectStart > static_cast<int64_t>(kConnectTimeoutSeconds * 1e9))
+            {
+                loop.quit();
+            }
+        });
+        loop.loop();
+        loop.cancel(poll);
+        double connectSeconds = static_cast<double>(bench::nowNanos() - connectStart) / 1e9;
+
+        forEachGenerator(generators, [](std::unique_ptr<LoadGenerator>& g) { g->start(); });
+        startNanos = bench::nowNanos();
+        loop.runAfter(seconds, [&]() { loop.quit(); });
+        loop.loop();
+
+        int64_t requests = 0;
+        forEachGenerator(generators, [&](std::unique_ptr<LoadGenerator>& g) { requests += g->stop(); });
+        double elapsed = static_cast<double>(bench::nowNanos() - startNanos) / 1e9;
+
+        bench::JsonLine("echo")
+            .add("connections", connections)
+            .add("requested_connections", requested)
+            .add("established", established)
+            .add("server_threads", serverThreads)
+            .add("client_threads", clientThreads)
+            .add("message_size", messageSize)
+            .add("connect_seconds", connectSeconds)
+            .add("seconds", elapsed)
+            .add("qps", static_cast<double>(requests) / elapsed)
+            .print();
+
+        //等最后一批回显到达并丢弃 带着未读数据close会发RST 服务端会打印错误
+        loop.runAfter(0.2, [&]() { loop.quit(); });
+        loop.loop();
+        //在各自的loop线程中析构 TcpClient析构后连接的关闭要再经过几次queueInLoop 等它们执行完
+        forEachGenerator(generators, [](std::unique_ptr<LoadGenerator>& g) {
+            EventLoop* clientLoop = g->loop();
+            g.reset();
+            clientLoop->queueInLoop([]() {});
+        });
+        generators.clear();
+        loop.runAfter(0.2, [&]() { loop.quit(); });
+        loop.loop();
+        ++port;
+    }
+    return 0;
+}
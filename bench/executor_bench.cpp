@@ -0,0 +1,130 @@
+//loop执行器偏斜测试 所有任务都由loop0产生 loop0还有一个定时器占掉一半CPU
+//pinned: 任务用queueInLoop留在loop0执行 其他loop空闲
+//stealing: 在loop0中submit到LoopExecutor 其他loop来偷
+//external: 在主线程中submit 分给最空闲的loop
+//单核机器上看不到加速 只能看到任务在各个loop上的分布
+//用法: executor_bench [loops] [tasks] [taskMicros]
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThreadPool.h"
+#include "myMuduo/net/LoopExecutor.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+void spin(int64_t micros)
+{
+    int64_t deadline = bench::nowNanos() + micros * 1000;
+    while (bench::nowNanos() < deadline)
+    {
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    int numLoops = argc > 1 ? atoi(argv[1]) : 4;
+    int numTasks = argc > 2 ? atoi(argv[2]) : 20000;
+    int64_t taskMicros = argc > 3 ? atoi(argv[3]) : 20;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoop baseLoop;
+    EventLoopThreadPool threadPool(&baseLoop, "executor_bench");
+    threadPool.setThreadNum(numLoops);
+    threadPool.start();
+    std::vector<EventLoop*> loops = threadPool.getAllLoops();
+    EventLoop* hotLoop = loops[0];
+
+    //loop0上的IO负载
+    std::promise<base::TimerId> hotTimer;
+    hotLoop->runInLoop([&]() { hotTimer.set_value(hotLoop->runEvery(0.001, []() { spin(500); })); });
+    base::TimerId hotTimerId = hotTimer.get_future().get();
+
+    const char* modes[] = {"pinned", "stealing", "external"};
+    for (const char* mode : modes)
+    {
+        std::string name(mode);
+        std::unique_ptr<LoopExecutor> executor(new LoopExecutor(&threadPool));
+        std::vector<std::atomic<int64_t>> perLoop(loops.size());
+        for (auto& n : perLoop)
+        {
+            n = 0;
+        }
+        std::atomic<int> remaining(numTasks);
+        std::promise<void> done;
+
+        auto task = [&]() {
+            spin(taskMicros);
+            for (size_t i = 0; i < loops.size(); ++i)
+            {
+                if (loops[i]->isInLoopThread())
+                {
+                    ++perLoop[i];
+                }
+            }
+            if (--remaining == 0)
+            {
+                done.set_value();
+            }
+        };
+
+        int64_t start = bench::nowNanos();
+        if (name == "external")
+        {
+            for (int i = 0; i < numTasks; ++i)
+            {
+                executor->submit(task);
+            }
+        }
+        else
+        {
+            LoopExecutor* e = executor.get();
+            hotLoop->runInLoop([&, e]() {
+                for (int i = 0; i < numTasks; ++i)
+                {
+                    if (name == "pinned")
+                    {
+                        hotLoop->queueInLoop(task);
+                    }
+                    else
+                    {
+                        e->submit(task);
+                    }
+                }
+            });
+        }
+        done.get_future().wait();
+        int64_t elapsed = bench::nowNanos() - start;
+
+        int64_t maxShare = 0;
+        for (auto& n : perLoop)
+        {
+            maxShare = std::max(maxShare, n.load());
+        }
+        LoopExecutor::Stats stats = executor->stats();
+        bench::JsonLine("executor")
+            .add("mode", mode)
+            .add("loops", static_cast<int>(loops.size()))
+            .add("tasks", numTasks)
+            .add("task_us", taskMicros)
+            .add("tasks_per_sec", static_cast<double>(numTasks) / (static_cast<double>(elapsed) / 1e9))
+            .add("max_loop_share", static_cast<double>(maxShare) / numTasks)
+            .add("stolen", static_cast<int64_t>(stats.stolen))
+            .print();
+    }
+
+    hotLoop->runInLoop([&]() { hotLoop->cancel(hotTimerId); });
+    return 0;
+}
@@ -0,0 +1,182 @@
+//HTTP吞吐测试 类似wrk: 若干条keep-alive连接 每条连接保持pipeline个请求在途
+//服务端运行在主线程的loop中 压测客户端运行在单独的EventLoopThread中
+//用法: http_bench [port] [seconds] [connections]
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/http/HttpRequest.h"
+#include "myMuduo/net/http/HttpResponse.h"
+#include "myMuduo/net/http/HttpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const char kRequest[] = "GET /hello HTTP/1.1\r\nHost: 127.0.0.1\r\nUser-Agent: http_bench\r\nAccept: */*\r\n\r\n";
+
+//只在客户端loop线程中使用 completed_除外
+class LoadGenerator : noncopyable
+{
+public:
+    LoadGenerator(EventLoop* loop, const InetAddress& serverAddr, int connections, int pipeline)
+        : pipeline_(pipeline)
+        , completed_(0)
+        , stopped_(false)
+    {
+        for (int i = 0; i < connections; ++i)
+        {
+            std::unique_ptr<TcpClient> client(new TcpClient(loop, serverAddr, "http_bench" + std::to_string(i)));
+            client->setConnectionCallback([this](const TcpConnectionPtr& conn) { onConnection(conn); });
+            client->setMessageCallback(
+                [this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) { onMessage(conn, buf); });
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    void start()
+    {
+        for (auto& client : clients_)
+        {
+            client->connect();
+        }
+    }
+
+    void stop() { stopped_ = true; }
+
+    int64_t completed() const { return completed_.load(std::memory_order_relaxed); }
+
+private:
+    void onConnection(const TcpConnectionPtr& conn)
+    {
+        if (conn->connected())
+        {
+            conn->setTcpNoDelay(true);
+            sendRequests(conn, pipeline_);
+        }
+    }
+
+    //一次回调可能收到多个应答 补发同样数量的请求 保持在途请求数不变
+    void onMessage(const TcpConnectionPtr& conn, Buffer* buf)
+    {
+        int responses = 0;
+        const char* headerEnd = nullptr;
+        while ((headerEnd = buf->findDelimiter("\r\n\r\n", 4)) != nullptr)
+        {
+            size_t headerLength = static_cast<size_t>(headerEnd - buf->peek()) + 4;
+            size_t bodyLength = contentLength(buf->peek(), headerEnd);
+            if (buf->readableBytesLength() < headerLength + bodyLength)
+            {
+                break;
+            }
+            buf->retrieve(headerLength + bodyLength);
+            ++responses;
+        }
+        completed_.fetch_add(responses, std::memory_order_relaxed);
+        if (!stopped_ && responses > 0)
+        {
+            sendRequests(conn, responses);
+        }
+    }
+
+    static size_t contentLength(const char* begin, const char* end)
+    {
+        static const char kField[] = "Content-Length: ";
+        const char* p = std::search(begin, end, kField, kField + sizeof kField - 1);
+        return p == end ? 0 : static_cast<size_t>(atoll(p + sizeof kField - 1));
+    }
+
+    void sendRequests(const TcpConnectionPtr& conn, int count)
+    {
+        Buffer buf;
+        for (int i = 0; i < count; ++i)
+        {
+            buf.append(kRequest, sizeof kRequest - 1);
+        }
+        conn->send(&buf);
+    }
+
+    const int pipeline_;
+    std::atomic<int64_t> completed_;
+    std::atomic<bool> stopped_;
+    std::vector<std::unique_ptr<TcpClient>> clients_;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18080);
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    int connections = argc > 3 ? atoi(argv[3]) : 16;
+    const double warmupSeconds = 0.3;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoop loop;
+    InetAddress listenAddr(port, true);
+    HttpServer server(&loop, listenAddr, "http_bench");
+    const std::string body = "hello, world!\n";
+    server.setHttpCallback([&body](const HttpRequest&, HttpResponse* resp) {
+        resp->setStatusCode(HttpResponse::k200Ok);
+        resp->setContentType("text/plain");
+        resp->setBody(body);
+    });
+    server.start();
+
+    EventLoopThread clientThread;
+    EventLoop* clientLoop = clientThread.startLoop();
+    InetAddress serverAddr("127.0.0.1", port);
+
+    const int pipelines[] = {1, 4, 16};
+    for (int pipeline : pipelines)
+    {
+        std::shared_ptr<LoadGenerator> generator(new LoadGenerator(clientLoop, serverAddr, connections, pipeline));
+        int64_t startCount = 0;
+        int64_t startNanos = 0;
+        int64_t endCount = 0;
+        int64_t endNanos = 0;
+
+        clientLoop->runInLoop([generator]() { generator->start(); });
+        loop.runAfter(warmupSeconds, [&]() {
+            startCount = generator->completed();
+            startNanos = bench::nowNanos();
+        });
+        loop.runAfter(warmupSeconds + seconds, [&]() {
+            endCount = generator->completed();
+            endNanos = bench::nowNanos();
+            generator->stop();
+            loop.quit();
+        });
+        loop.loop();
+
+        //TcpClient要在自己的loop线程中析构
+        std::promise<void> destroyed;
+        clientLoop->runInLoop([&generator, &destroyed]() {
+            generator.reset();
+            destroyed.set_value();
+        });
+        destroyed.get_future().wait();
+
+        double elapsed = static_cast<double>(endNanos - startNanos) / 1e9;
+        bench::JsonLine("http")
+            .add("connections", connections)
+            .add("pipeline", pipeline)
+            .add("seconds", elapsed)
+            .add("requests", endCount - startCount)
+            .add("requests_per_sec", static_cast<double>(endCount - startCount) / elapsed)
+            .print();
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+//流式应答测试 服务端用chunked编码发送一个很大的body 客户端只计数丢弃
+//fast: 客户端尽快读  slow: 客户端每次读完暂停1ms 服务端必须靠高水位暂停producer
+//max_rss_kb基本不随body大小增长 说明每条连接的内存是有界的
+//用法: http_stream_bench [port] [fastMB] [slowMB]
+#include <sys/resource.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/http/HttpRequest.h"
+#include "myMuduo/net/http/HttpResponse.h"
+#include "myMuduo/net/http/HttpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const size_t kChunkSize = 16 * 1024;
+
+long maxRssKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+//客户端和服务端在同一个loop中 请求body大小由path给出
+void runOnce(EventLoop* loop, const InetAddress& serverAddr, const char* mode, size_t totalBytes, bool slow)
+{
+    TcpClient client(loop, serverAddr, "stream_bench");
+    size_t received = 0;
+    int64_t start = 0;
+    int64_t end = 0;
+    std::string request = "GET /" + std::to_string(totalBytes) + " HTTP/1.1\r\nConnection: close\r\n\r\n";
+
+    client.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if (conn->connected())
+        {
+            start = bench::nowNanos();
+            conn->send(request);
+        }
+        else
+        {
+            end = bench::nowNanos();
+            loop->quit();
+        }
+    });
+    client.setMessageCallback([&](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+        received += buf->readableBytesLength();
+        buf->retrieveAll();
+        if (slow)
+        {
+            conn->stopRead();
+            std::weak_ptr<TcpConnection> weakConn(conn);
+            loop->runAfter(0.001, [weakConn]() {
+                TcpConnectionPtr c = weakConn.lock();
+                if (c) c->startRead();
+            });
+        }
+    });
+    client.connect();
+    loop->loop();
+
+    double seconds = static_cast<double>(end - start) / 1e9;
+    bench::JsonLine("http_stream")
+        .add("mode", mode)
+        .add("body_bytes", totalBytes)
+        .add("wire_bytes", received)
+        .add("mb_per_sec", static_cast<double>(received) / seconds / (1024 * 1024))
+        .add("max_rss_kb", static_cast<int64_t>(maxRssKb()))
+        .print();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18090);
+    size_t fastMB = static_cast<size_t>(argc > 2 ? atoi(argv[2]) : 256);
+    size_t slowMB = static_cast<size_t>(argc > 3 ? atoi(argv[3]) : 16);
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoop loop;
+    HttpServer server(&loop, InetAddress(port, true), "stream_bench");
+    server.setHttpCallback([](const HttpRequest& req, HttpResponse* resp) {
+        size_t total = static_cast<size_t>(atoll(req.path().data() + 1));
+        std::shared_ptr<size_t> remaining = std::make_shared<size_t>(total);
+        std::shared_ptr<std::string> chunk = std::make_shared<std::string>(kChunkSize, 'x');
+        resp->setStatusCode(HttpResponse::k200Ok);
+        resp->setContentType("application/octet-stream");
+        resp->setBodyProducer([remaining, chunk](Buffer* out) {
+            size_t n = std::min(*remaining, chunk->size());
+            out->append(chunk->data(), n);
+            *remaining -= n;
+            return *remaining > 0;
+        });
+    });
+    server.start();
+
+    InetAddress serverAddr("127.0.0.1", port);
+    runOnce(&loop, serverAddr, "fast", fastMB * 1024 * 1024, false);
+    runOnce(&loop, serverAddr, "fast", fastMB * 4 * 1024 * 1024, false);
+    runOnce(&loop, serverAddr, "slow", slowMB * 1024 * 1024, true);
+    return 0;
+}
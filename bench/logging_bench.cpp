@@ -0,0 +1,118 @@
+//日志开销测试 threads个线程各自运行一个EventLoop 始终可读的eventfd让loop每轮都有一个活跃Channel
+//读回调中用MYMUDUO_LOG_INFO写一条日志 统计所有loop每秒的循环次数 日志写到/dev/null
+//off: 运行时关闭日志 sync: 同步logger ring: Logging::enableRing 每个线程一个无锁队列
+//async: Logging::enableAsync 所有线程共用spdlog的加锁队列
+//库中热路径的trace/debug日志是否编译进来由MYMUDUO_LOG_LEVEL决定 结果中的compiled_level
+//用法: logging_bench [seconds] [threads]
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/base/Logging.h"
+#include "myMuduo/net/Channel.h"
+#include "myMuduo/net/EventLoop.h"
+#include "spdlog/sinks/basic_file_sink.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+int64_t runLoop(double seconds)
+{
+    EventLoop loop;
+    //写入后不读 水平触发下每次epoll_wait都返回它
+    int fd = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+    Channel channel(&loop, fd);
+    channel.setReadCallback([fd](Timestamp receiveTime) {
+        MYMUDUO_LOG_INFO("event fd={} time={}", fd, receiveTime.microSecondsSinceEpoch());
+    });
+    channel.enableReading();
+
+    int64_t iterations = 0;
+    loop.setIterationCallback([&iterations]() { ++iterations; });
+    loop.runAfter(seconds, [&loop]() { loop.quit(); });
+    loop.loop();
+
+    channel.disableAll();
+    channel.remove();
+    close(fd);
+    return iterations;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    int numThreads = argc > 2 ? atoi(argv[2]) : 4;
+
+    std::shared_ptr<spdlog::logger> logger = std::make_shared<spdlog::logger>(
+        "logging_bench", std::make_shared<spdlog::sinks::basic_file_sink_mt>("/dev/null"));
+    spdlog::set_default_logger(logger);
+
+    //异步logger不能换回同步 放在最后
+    const char* modes[] = {"off", "sync", "ring", "async"};
+    for (const char* mode : modes)
+    {
+        std::string name(mode);
+        if (name == "off")
+        {
+            spdlog::set_level(spdlog::level::off);
+        }
+        else if (name == "sync")
+        {
+            spdlog::set_level(spdlog::level::trace);
+        }
+        else if (name == "ring")
+        {
+            base::Logging::enableRing();
+        }
+        else
+        {
+            base::Logging::enableAsync();
+        }
+
+        std::vector<int64_t> iterations(numThreads, 0);
+        std::vector<std::unique_ptr<std::thread>> threads;
+        int64_t start = bench::nowNanos();
+        for (int i = 0; i < numThreads; ++i)
+        {
+            threads.emplace_back(new std::thread([&iterations, i, seconds]() { iterations[i] = runLoop(seconds); }));
+        }
+        int64_t total = 0;
+        for (int i = 0; i < numThreads; ++i)
+        {
+            threads[i]->join();
+            total += iterations[i];
+        }
+        double elapsed = static_cast<double>(bench::nowNanos() - start) / 1e9;
+
+        uint64_t dropped = 0;
+        if (name == "ring")
+        {
+            base::Logging::stopRing();
+            dropped = base::Logging::ringStats().dropped;
+        }
+        else if (name == "async")
+        {
+            base::Logging::flush();
+            dropped = base::Logging::dropped();
+        }
+
+        bench::JsonLine("logging")
+            .add("mode", mode)
+            .add("threads", numThreads)
+            .add("compiled_level", base::Logging::compiledLevel())
+            .add("iterations_per_sec", static_cast<double>(total) / elapsed)
+            .add("dropped", static_cast<int64_t>(dropped))
+            .print();
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+//计算任务卸载测试 服务端只有一个IO线程 slow连接的每个请求要算kSlowMicros
+//inline: 直接在IO线程中计算 fast连接的请求要排在计算后面
+//offload: 交给ThreadPool 结果回到IO线程发送 fast连接的延迟不受影响
+//用法: offload_bench [port] [seconds] [slowConnections] [workers]
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/base/ThreadPool.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/Offload.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/TcpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const int64_t kSlowMicros = 500;
+
+//模拟计算 忙等kSlowMicros
+char compute()
+{
+    int64_t deadline = bench::nowNanos() + kSlowMicros * 1000;
+    while (bench::nowNanos() < deadline)
+    {
+    }
+    return 's';
+}
+
+//只在客户端loop线程中使用 每条连接同时只有一个请求在途
+class LoadGenerator : noncopyable
+{
+public:
+    LoadGenerator(EventLoop* loop, const InetAddress& serverAddr, int slowConnections)
+        : recording_(false)
+        , stopped_(false)
+        , slowReplies_(0)
+        , fastStart_(0)
+    {
+        for (int i = 0; i <= slowConnections; ++i)
+        {
+            bool fast = i == slowConnections;
+            std::unique_ptr<TcpClient> client(new TcpClient(loop, serverAddr, "offload_bench" + std::to_string(i)));
+            client->setConnectionCallback([this, fast](const TcpConnectionPtr& conn) {
+                if (conn->connected())
+                {
+                    issue(conn, fast);
+                }
+            });
+            client->setMessageCallback([this, fast](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+                size_t replies = buf->readableBytesLength();
+                buf->retrieveAll();
+                if (recording_ && !stopped_)
+                {
+                    if (fast)
+                    {
+                        latencies_.push_back(bench::nowNanos() - fastStart_);
+                    }
+                    else
+                    {
+                        slowReplies_ += static_cast<int64_t>(replies);
+                    }
+                }
+                if (!stopped_)
+                {
+                    issue(conn, fast);
+                }
+            });
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    void start()
+    {
+        for (auto& client : clients_)
+        {
+            client->connect();
+        }
+    }
+
+    void startRecording() { recording_ = true; }
+    void stop() { stopped_ = true; }
+
+    std::vector<int64_t>& latencies() { return latencies_; }
+    int64_t slowReplies() const { return slowReplies_; }
+
+private:
+    void issue(const TcpConnectionPtr& conn, bool fast)
+    {
+        if (fast)
+        {
+            fastStart_ = bench::nowNanos();
+        }
+        conn->send(fast ? "f" : "s");
+    }
+
+    bool recording_;
+    bool stopped_;
+    int64_t slowReplies_;
+    int64_t fastStart_;
+    std::vector<int64_t> latencies_;
+    std::vector<std::unique_ptr<TcpClient>> clients_;
+};
+
+double percentileMicros(const std::vector<int64_t>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18140);
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    int slowConnections = argc > 3 ? atoi(argv[3]) : 4;
+    int workers = argc > 4 ? atoi(argv[4]) : 4;
+    const double warmupSeconds = 0.3;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    base::ThreadPool pool("offload");
+    pool.start(workers);
+
+    bool offloading = false;
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(port, true), "offload_bench");
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if (conn->connected())
+        {
+            conn->setContext(std::make_shared<base::Strand>(&pool));
+        }
+    });
+    server.setMessageCallback([&](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+        std::string requests = buf->retrieveAllAsString();
+        for (char request : requests)
+        {
+            if (request == 'f')
+            {
+                conn->send("f");
+            }
+            else if (!offloading)
+            {
+                conn->send(std::string(1, compute()));
+            }
+            else
+            {
+                std::shared_ptr<base::Strand>* strand = conn->getMutableContext()->cast<std::shared_ptr<base::Strand>>();
+                offload(*strand, conn, compute, [](const TcpConnectionPtr& c, char& reply) { c->send(std::string(1, reply)); });
+            }
+        }
+    });
+    server.start();
+
+    EventLoopThread clientThread;
+    EventLoop* clientLoop = clientThread.startLoop();
+    InetAddress serverAddr("127.0.0.1", port);
+
+    const char* modes[] = {"inline", "offload"};
+    for (const char* mode : modes)
+    {
+        offloading = std::string(mode) == "offload";
+        std::shared_ptr<LoadGenerator> generator(new LoadGenerator(clientLoop, serverAddr, slowConnections));
+        int64_t startNanos = 0;
+        int64_t endNanos = 0;
+
+        clientLoop->runInLoop([generator]() { generator->start(); });
+        loop.runAfter(warmupSeconds, [&]() {
+            clientLoop->runInLoop([generator]() { generator->startRecording(); });
+            startNanos = bench::nowNanos();
+        });
+        loop.runAfter(warmupSeconds + seconds, [&]() {
+            clientLoop->runInLoop([generator]() { generator->stop(); });
+            endNanos = bench::nowNanos();
+            loop.quit();
+        });
+        loop.loop();
+
+        std::promise<void> destroyed;
+        std::vector<int64_t> latencies;
+        int64_t slowReplies = 0;
+        clientLoop->runInLoop([&]() {
+            latencies.swap(generator->latencies());
+            slowReplies = generator->slowReplies();
+            generator.reset();
+            //TcpClient析构后连接的关闭要再经过几次queueInLoop 等它们执行完
+            clientLoop->runAfter(0.01, [&]() { destroyed.set_value(); });
+        });
+        destroyed.get_future().wait();
+
+        std::sort(latencies.begin(), latencies.end());
+        double elapsed = static_cast<double>(endNanos - startNanos) / 1e9;
+        base::ThreadPool::Stats stats = pool.stats();
+        bench::JsonLine("offload")
+            .add("mode", mode)
+            .add("slow_connections", slowConnections)
+            .add("workers", workers)
+            .add("slow_per_sec", static_cast<double>(slowReplies) / elapsed)
+            .add("fast_requests", latencies.size())
+            .add("fast_p50_us", percentileMicros(latencies, 0.50))
+            .add("fast_p99_us", percentileMicros(latencies, 0.99))
+            .add("pool_avg_wait_us", stats.avgWaitMicros)
+            .add("pool_max_queue_depth", stats.maxQueueDepth)
+            .print();
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+#!/bin/sh
+# 按profile优化的完整流程 并输出各个构建的回显QPS对比
+# 1. debug: 默认的-g -O0构建 作为基线
+# 2. release: -O2
+# 3. lto: -O2 + 链接时优化
+# 4. pgo: -O2 + LTO 先插桩构建运行run_reactor_bench训练 再在同一个构建目录中用profile重新编译
+# 每个构建跑一次echo_bench 结果每行一个JSON 前面加上"build"字段
+# 用法: bench/pgo.sh [buildRoot] [echo_bench的连接数 如1,100,10000] [seconds]
+set -e
+
+SOURCE_DIR=$(cd "$(dirname "$0")/.." && pwd)
+BUILD_ROOT=${1:-"$SOURCE_DIR/build-pgo"}
+CONNECTIONS=${2:-1,100,10000}
+SECONDS_PER_RUN=${3:-2}
+JOBS=$(nproc)
+PORT=18400
+
+configure_and_build() {
+    dir=$1
+    shift
+    cmake -S "$SOURCE_DIR" -B "$dir" "$@" > /dev/null
+    cmake --build "$dir" -j"$JOBS" --target "$TARGET" > /dev/null
+}
+
+run_echo() {
+    build=$1
+    dir=$2
+    "$dir/bench/echo_bench" "$PORT" "$SECONDS_PER_RUN" "$CONNECTIONS" 2> /dev/null | sed "s/^{/{\"build\":\"$build\",/"
+    PORT=$((PORT + 10))
+}
+
+TARGET=echo_bench
+configure_and_build "$BUILD_ROOT/debug" -DCMAKE_BUILD_TYPE=Debug
+run_echo debug "$BUILD_ROOT/debug"
+
+configure_and_build "$BUILD_ROOT/release" -DCMAKE_BUILD_TYPE=Release -DMYMUDUO_ENABLE_LTO=OFF -DMYMUDUO_PGO=OFF
+run_echo release "$BUILD_ROOT/release"
+
+configure_and_build "$BUILD_ROOT/lto" -DCMAKE_BUILD_TYPE=Release -DMYMUDUO_ENABLE_LTO=ON -DMYMUDUO_PGO=OFF
+run_echo lto "$BUILD_ROOT/lto"
+
+# 旧的profile会和新的插桩数据累加 先清掉
+PGO_BUILD="$BUILD_ROOT/pgo"
+rm -rf "$PGO_BUILD/pgo"
+TARGET=reactor_bench
+configure_and_build "$PGO_BUILD" -DCMAKE_BUILD_TYPE=Release -DMYMUDUO_ENABLE_LTO=ON -DMYMUDUO_PGO=GENERATE
+cmake --build "$PGO_BUILD" --target run_reactor_bench > /dev/null 2>&1
+
+TARGET=echo_bench
+configure_and_build "$PGO_BUILD" -DMYMUDUO_PGO=USE
+run_echo pgo "$PGO_BUILD"
@@ -0,0 +1,138 @@
+//pingpong吞吐量测试 客户端sessions条连接各发一个blockSize的块 两端收到多少就原样发回多少
+//统计客户端收到的字节数 输出MiB/s 服务端和客户端各threads个IO线程
+//用法: pingpong_bench [port] [seconds] [sessions] [blockSize] [threads]
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThreadPool.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/TcpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+//每条连接的字节数只在所属的客户端loop线程中累加
+struct Session
+{
+    std::unique_ptr<TcpClient> client;
+    int64_t bytesRead = 0;
+    int64_t messagesRead = 0;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18200);
+    double seconds = argc > 2 ? atof(argv[2]) : 3.0;
+    int sessions = argc > 3 ? atoi(argv[3]) : 1;
+    size_t blockSize = static_cast<size_t>(argc > 4 ? atoi(argv[4]) : 16384);
+    int threads = argc > 5 ? atoi(argv[5]) : 1;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(port, true), "pingpong_server");
+    server.setThreadNum(threads);
+    server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+        if (conn->connected())
+        {
+            conn->setTcpNoDelay(true);
+        }
+    });
+    server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) { conn->send(buf); });
+    server.start();
+
+    EventLoopThreadPool clientPool(&loop, "pingpong_client");
+    clientPool.setThreadNum(threads);
+    clientPool.start();
+
+    const std::string block(blockSize, 'p');
+    std::vector<Session> clients(sessions);
+    int connected = 0;
+    int64_t startNanos = 0;
+    for (int i = 0; i < sessions; ++i)
+    {
+        Session* session = &clients[i];
+        session->client.reset(new TcpClient(clientPool.getNextLoop(), InetAddress("127.0.0.1", port),
+                                            "pingpong_client" + std::to_string(i)));
+        session->client->setConnectionCallback([&, session](const TcpConnectionPtr& conn) {
+            if (conn->connected())
+            {
+                conn->setTcpNoDelay(true);
+                //所有连接建立之后再同时开始
+                loop.runInLoop([&]() {
+                    if (++connected == sessions)
+                    {
+                        startNanos = bench::nowNanos();
+                        for (Session& s : clients)
+                        {
+                            TcpConnectionPtr c = s.client->connection();
+                            c->getLoop()->runInLoop([c, &block]() { c->send(block); });
+                        }
+                    }
+                });
+            }
+        });
+        session->client->setMessageCallback([session](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+            session->bytesRead += static_cast<int64_t>(buf->readableBytesLength());
+            ++session->messagesRead;
+            conn->send(buf);
+        });
+        session->client->connect();
+    }
+
+    loop.runEvery(0.01, [&]() {
+        if (startNanos != 0 && bench::nowNanos() - startNanos >= static_cast<int64_t>(seconds * 1e9))
+        {
+            loop.quit();
+        }
+    });
+    loop.loop();
+
+    //在各自的loop线程中读取计数并停止转发
+    int64_t endNanos = bench::nowNanos();
+    int64_t bytes = 0;
+    int64_t messages = 0;
+    for (Session& session : clients)
+    {
+        std::promise<void> done;
+        session.client->getLoop()->runInLoop([&]() {
+            bytes += session.bytesRead;
+            messages += session.messagesRead;
+            TcpConnectionPtr conn = session.client->connection();
+            if (conn)
+            {
+                conn->setMessageCallback([](const TcpConnectionPtr&, Buffer* buf, Timestamp) { buf->retrieveAll(); });
+            }
+            done.set_value();
+        });
+        done.get_future().wait();
+    }
+
+    double elapsed = static_cast<double>(endNanos - startNanos) / 1e9;
+    bench::JsonLine("pingpong")
+        .add("sessions", sessions)
+        .add("block_size", blockSize)
+        .add("threads", threads)
+        .add("seconds", elapsed)
+        .add("mib_per_sec", static_cast<double>(bytes) / elapsed / (1024 * 1024))
+        .add("messages_per_sec", static_cast<double>(messages) / elapsed)
+        .add("avg_message_size", messages > 0 ? static_cast<double>(bytes) / static_cast<double>(messages) : 0.0)
+        .print();
+
+    //TcpClient析构后连接的关闭要再经过几次queueInLoop 等它们执行完再析构服务器和IO线程
+    clients.clear();
+    loop.runAfter(0.05, [&]() { loop.quit(); });
+    loop.loop();
+    return 0;
+}
@@ -0,0 +1,230 @@
+//RESP吞吐测试 模拟redis-benchmark -P: 若干条连接 每条连接保持pipeline条命令在途
+//服务端是进程内的SET/GET/PING处理 运行在主线程的loop中 客户端运行在单独的EventLoopThread中
+//客户端用RespParser::scanValue数应答 不解析内容
+//用法: resp_bench [port] [seconds] [connections]
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/resp/RespCommand.h"
+#include "myMuduo/net/resp/RespParser.h"
+#include "myMuduo/net/resp/RespReply.h"
+#include "myMuduo/net/resp/RespServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+//和redis-benchmark -r 100000一样 key在固定范围内轮换
+const int kKeySpace = 100000;
+const char kValue[] = "xxx";
+
+std::string makeCommand(const char* command, int key)
+{
+    char keyBuf[32];
+    int keyLength = snprintf(keyBuf, sizeof keyBuf, "key:%012d", key);
+    if (std::string(command) == "PING")
+    {
+        return "*1\r\n$4\r\nPING\r\n";
+    }
+    bool set = std::string(command) == "SET";
+    std::string result = set ? "*3\r\n$3\r\nSET\r\n" : "*2\r\n$3\r\nGET\r\n";
+    result += "$" + std::to_string(keyLength) + "\r\n" + std::string(keyBuf, keyLength) + "\r\n";
+    if (set)
+    {
+        result += "$" + std::to_string(sizeof kValue - 1) + "\r\n" + kValue + "\r\n";
+    }
+    return result;
+}
+
+//只在客户端loop线程中使用 completed_除外
+class LoadGenerator : noncopyable
+{
+public:
+    LoadGenerator(EventLoop* loop, const InetAddress& serverAddr, int connections, int pipeline,
+                  const char* command)
+        : pipeline_(pipeline)
+        , nextKey_(0)
+        , completed_(0)
+        , stopped_(false)
+    {
+        for (int i = 0; i < 1024; ++i)
+        {
+            commands_.push_back(makeCommand(command, rand() % kKeySpace));
+        }
+        for (int i = 0; i < connections; ++i)
+        {
+            std::unique_ptr<TcpClient> client(new TcpClient(loop, serverAddr, "resp_bench" + std::to_string(i)));
+            client->setConnectionCallback([this](const TcpConnectionPtr& conn) {
+                if (conn->connected())
+                {
+                    conn->setTcpNoDelay(true);
+                    sendCommands(conn, pipeline_);
+                }
+            });
+            client->setMessageCallback(
+                [this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) { onMessage(conn, buf); });
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    void start()
+    {
+        for (auto& client : clients_)
+        {
+            client->connect();
+        }
+    }
+
+    void stop() { stopped_ = true; }
+
+    int64_t completed() const { return completed_.load(std::memory_order_relaxed); }
+
+private:
+    //一次回调可能收到多个应答 补发同样数量的命令 保持在途命令数不变
+    void onMessage(const TcpConnectionPtr& conn, Buffer* buf)
+    {
+        int replies = 0;
+        int64_t n = 0;
+        while ((n = RespParser::scanValue(buf->peek(), buf->readableBytesLength())) > 0)
+        {
+            buf->retrieve(static_cast<size_t>(n));
+            ++replies;
+        }
+        if (n < 0)
+        {
+            spdlog::critical("resp_bench - malformed reply");
+            abort();
+        }
+        completed_.fetch_add(replies, std::memory_order_relaxed);
+        if (!stopped_ && replies > 0)
+        {
+            sendCommands(conn, replies);
+        }
+    }
+
+    void sendCommands(const TcpConnectionPtr& conn, int count)
+    {
+        Buffer buf;
+        for (int i = 0; i < count; ++i)
+        {
+            const std::string& command = commands_[nextKey_++ % commands_.size()];
+            buf.append(command.data(), command.size());
+        }
+        conn->send(&buf);
+    }
+
+    const int pipeline_;
+    size_t nextKey_;
+    std::vector<std::string> commands_;
+    std::atomic<int64_t> completed_;
+    std::atomic<bool> stopped_;
+    std::vector<std::unique_ptr<TcpClient>> clients_;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18120);
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    int connections = argc > 3 ? atoi(argv[3]) : 16;
+    const double warmupSeconds = 0.3;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoop loop;
+    InetAddress listenAddr(port, true);
+    RespServer server(&loop, listenAddr, "resp_bench");
+    std::unordered_map<std::string, std::string> store;
+    server.setCommandCallback([&store](const TcpConnectionPtr&, const RespCommand& command, RespReply* reply) {
+        if (command.is("GET") && command.argc() == 2)
+        {
+            base::StringPiece key = command.arg(1);
+            auto it = store.find(std::string(key.data(), key.size()));
+            if (it == store.end())
+                reply->null();
+            else
+                reply->bulkString(it->second);
+        }
+        else if (command.is("SET") && command.argc() == 3)
+        {
+            base::StringPiece key = command.arg(1);
+            base::StringPiece value = command.arg(2);
+            store[std::string(key.data(), key.size())].assign(value.data(), value.size());
+            reply->simpleString("OK");
+        }
+        else if (command.is("PING"))
+        {
+            reply->simpleString("PONG");
+        }
+        else
+        {
+            reply->error("ERR unknown command");
+        }
+    });
+    server.start();
+
+    EventLoopThread clientThread;
+    EventLoop* clientLoop = clientThread.startLoop();
+    InetAddress serverAddr("127.0.0.1", port);
+
+    const char* commands[] = {"PING", "SET", "GET"};
+    const int pipelines[] = {1, 16, 64};
+    for (const char* command : commands)
+    {
+        for (int pipeline : pipelines)
+        {
+            std::shared_ptr<LoadGenerator> generator(
+                new LoadGenerator(clientLoop, serverAddr, connections, pipeline, command));
+            int64_t startCount = 0;
+            int64_t startNanos = 0;
+            int64_t endCount = 0;
+            int64_t endNanos = 0;
+
+            clientLoop->runInLoop([generator]() { generator->start(); });
+            loop.runAfter(warmupSeconds, [&]() {
+                startCount = generator->completed();
+                startNanos = bench::nowNanos();
+            });
+            loop.runAfter(warmupSeconds + seconds, [&]() {
+                endCount = generator->completed();
+                endNanos = bench::nowNanos();
+                generator->stop();
+                loop.quit();
+            });
+            loop.loop();
+
+            //TcpClient要在自己的loop线程中析构
+            std::promise<void> destroyed;
+            clientLoop->runInLoop([&generator, &destroyed]() {
+                generator.reset();
+                destroyed.set_value();
+            });
+            destroyed.get_future().wait();
+
+            double elapsed = static_cast<double>(endNanos - startNanos) / 1e9;
+            bench::JsonLine("resp")
+                .add("command", command)
+                .add("connections", connections)
+                .add("pipeline", pipeline)
+                .add("seconds", elapsed)
+                .add("requests", endCount - startCount)
+                .add("requests_per_sec", static_cast<double>(endCount - startCount) / elapsed)
+                .print();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+//RPC测试 若干条连接 每条连接保持inflight个调用在途 统计吞吐和延迟分位数
+//服务端是在IO线程中执行的echo 运行在主线程的loop中 客户端运行在单独的EventLoopThread中
+//每个调用都设置截止时间 包含定时器的开销
+//用法: rpc_bench [port] [seconds] [connections]
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/rpc/RpcClient.h"
+#include "myMuduo/net/rpc/RpcServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const double kDeadlineSeconds = 1.0;
+const size_t kPayloadSize = 64;
+
+//只在客户端loop线程中使用
+class LoadGenerator : noncopyable
+{
+public:
+    LoadGenerator(EventLoop* loop, const InetAddress& serverAddr, int connections, int inflight)
+        : inflight_(inflight)
+        , payload_(kPayloadSize, 'p')
+        , recording_(false)
+        , stopped_(false)
+        , errors_(0)
+    {
+        for (int i = 0; i < connections; ++i)
+        {
+            std::unique_ptr<RpcClient> client(new RpcClient(loop, serverAddr, "rpc_bench" + std::to_string(i)));
+            RpcClient* c = client.get();
+            client->setConnectionCallback([this, c](const TcpConnectionPtr& conn) {
+                if (conn->connected())
+                {
+                    for (int j = 0; j < inflight_; ++j)
+                    {
+                        issue(c);
+                    }
+                }
+            });
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    void start()
+    {
+        for (auto& client : clients_)
+        {
+            client->connect();
+        }
+    }
+
+    void startRecording() { recording_ = true; }
+    void stop() { stopped_ = true; }
+
+    std::vector<int64_t>& latencies() { return latencies_; }
+    int64_t errors() const { return errors_; }
+
+private:
+    void issue(RpcClient* client)
+    {
+        int64_t start = bench::nowNanos();
+        client->call(
+            "echo", payload_,
+            [this, client, start](RpcStatus status, const base::StringPiece&) {
+                if (status != kRpcOk)
+                {
+                    ++errors_;
+                }
+                else if (recording_ && !stopped_)
+                {
+                    latencies_.push_back(bench::nowNanos() - start);
+                }
+                if (!stopped_)
+                {
+                    issue(client);
+                }
+            },
+            kDeadlineSeconds);
+    }
+
+    const int inflight_;
+    const std::string payload_;
+    bool recording_;
+    bool stopped_;
+    int64_t errors_;
+    std::vector<int64_t> latencies_;
+    std::vector<std::unique_ptr<RpcClient>> clients_;
+};
+
+double percentileMicros(const std::vector<int64_t>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18130);
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    int connections = argc > 3 ? atoi(argv[3]) : 4;
+    const double warmupSeconds = 0.3;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoop loop;
+    RpcServer server(&loop, InetAddress(port, true), "rpc_bench");
+    server.registerMethod("echo",
+                          [](const base::StringPiece& request, const RpcResponder& responder) { responder.reply(request); });
+    server.start();
+
+    EventLoopThread clientThread;
+    EventLoop* clientLoop = clientThread.startLoop();
+    InetAddress serverAddr("127.0.0.1", port);
+
+    const int inflights[] = {1, 16, 256};
+    for (int inflight : inflights)
+    {
+        std::shared_ptr<LoadGenerator> generator(new LoadGenerator(clientLoop, serverAddr, connections, inflight));
+        int64_t startNanos = 0;
+        int64_t endNanos = 0;
+
+        clientLoop->runInLoop([generator]() { generator->start(); });
+        loop.runAfter(warmupSeconds, [&]() {
+            clientLoop->runInLoop([generator]() { generator->startRecording(); });
+            startNanos = bench::nowNanos();
+        });
+        loop.runAfter(warmupSeconds + seconds, [&]() {
+            clientLoop->runInLoop([generator]() { generator->stop(); });
+            endNanos = bench::nowNanos();
+            loop.quit();
+        });
+        loop.loop();
+
+        //停止后在客户端线程中取结果并析构RpcClient
+        std::promise<void> destroyed;
+        std::vector<int64_t> latencies;
+        int64_t errors = 0;
+        clientLoop->runInLoop([&]() {
+            latencies.swap(generator->latencies());
+            errors = generator->errors();
+            generator.reset();
+            destroyed.set_value();
+        });
+        destroyed.get_future().wait();
+
+        std::sort(latencies.begin(), latencies.end());
+        double elapsed = static_cast<double>(endNanos - startNanos) / 1e9;
+        bench::JsonLine("rpc")
+            .add("connections", connections)
+            .add("inflight", inflight)
+            .add("calls", latencies.size())
+            .add("calls_per_sec", static_cast<double>(latencies.size()) / elapsed)
+            .add("p50_us", percentileMicros(latencies, 0.50))
+            .add("p99_us", percentileMicros(latencies, 0.99))
+            .add("errors", errors)
+            .print();
+    }
+    return 0;
+}
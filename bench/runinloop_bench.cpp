@@ -0,0 +1,115 @@
+//跨线程runInLoop速率测试 producers个线程同时向同一个loop提交空任务
+//throughput: 每个线程提交count个任务 统计从开始提交到全部执行完的速率和每轮循环执行的任务数
+//pingpong: 一个线程提交一个任务 等它执行完再提交下一个 统计往返延迟 每次都要经过eventfd唤醒
+//用法: runinloop_bench [count] [producers]
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/LoopMetrics.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+double percentileMicros(const std::vector<int64_t>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    int count = argc > 1 ? atoi(argv[1]) : 200000;
+    int producers = argc > 2 ? atoi(argv[2]) : 2;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoopThread loopThread(ThreadInitCallback(), "runinloop_bench");
+    EventLoop* loop = loopThread.startLoop();
+
+    //throughput 计数只在loop线程中修改
+    {
+        int64_t total = static_cast<int64_t>(count) * producers;
+        int64_t executed = 0;
+        std::promise<void> finished;
+        uint64_t wakeupsBefore = loop->metrics().get(LoopMetrics::kWakeups);
+
+        int64_t start = bench::nowNanos();
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < count; ++i)
+                {
+                    loop->runInLoop([&]() {
+                        if (++executed == total)
+                        {
+                            finished.set_value();
+                        }
+                    });
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        int64_t submitNanos = bench::nowNanos() - start;
+        finished.get_future().wait();
+        int64_t nanos = bench::nowNanos() - start;
+        uint64_t wakeups = loop->metrics().get(LoopMetrics::kWakeups) - wakeupsBefore;
+
+        bench::JsonLine("runinloop")
+            .add("test", "throughput")
+            .add("producers", producers)
+            .add("tasks", total)
+            .add("tasks_per_sec", static_cast<double>(total) * 1e9 / static_cast<double>(nanos))
+            .add("submit_ns_per_task", static_cast<double>(submitNanos) / static_cast<double>(total))
+            .add("tasks_per_wakeup", wakeups > 0 ? static_cast<double>(total) / static_cast<double>(wakeups) : 0.0)
+            .print();
+    }
+
+    //pingpong
+    {
+        int rounds = std::max(1, count / 10);
+        std::vector<int64_t> latencies;
+        latencies.reserve(rounds);
+        std::atomic<bool> done(false);
+        for (int i = 0; i < rounds; ++i)
+        {
+            done.store(false, std::memory_order_relaxed);
+            int64_t start = bench::nowNanos();
+            loop->runInLoop([&]() { done.store(true, std::memory_order_release); });
+            while (!done.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            latencies.push_back(bench::nowNanos() - start);
+        }
+        std::sort(latencies.begin(), latencies.end());
+        bench::JsonLine("runinloop")
+            .add("test", "pingpong")
+            .add("rounds", rounds)
+            .add("p50_us", percentileMicros(latencies, 0.50))
+            .add("p99_us", percentileMicros(latencies, 0.99))
+            .add("p999_us", percentileMicros(latencies, 0.999))
+            .addRaw("hist_us", bench::log2Histogram(latencies))
+            .print();
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+//跨线程发送测试 producers个应用线程同时对服务端的连接调用TcpConnection::send 连接属于另一个io线程
+//每个线程发送count条messageSize字节的消息 轮流发到各条连接上 客户端只统计收到的字节数
+//统计从开始发送到客户端全部收到的速率 生产者每次send的平均耗时 以及io线程每次唤醒处理的消息数
+//用法: send_bench [port] [count] [producers 如1,2,4,8] [messageSize] [connections]
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "myMuduo/net/LoopMetrics.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/TcpServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const double kTimeoutSeconds = 30.0;
+
+std::vector<int> parseList(const char* arg)
+{
+    std::vector<int> values;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        values.push_back(atoi(item.c_str()));
+    }
+    return values;
+}
+
+//在loop线程中执行func 等待完成
+template <typename Func>
+void runAndWait(EventLoop* loop, Func func)
+{
+    std::promise<void> done;
+    loop->runInLoop([&]() {
+        func();
+        done.set_value();
+    });
+    done.get_future().wait();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18500);
+    int count = argc > 2 ? atoi(argv[2]) : 100000;
+    std::vector<int> producerList = parseList(argc > 3 ? argv[3] : "1,2,4,8");
+    size_t messageSize = static_cast<size_t>(argc > 4 ? atoi(argv[4]) : 64);
+    int connections = argc > 5 ? atoi(argv[5]) : 1;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    //服务端只有一个io线程 发送全部来自其他线程
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(port, true), "send_server");
+    server.setThreadNum(1);
+    std::mutex mutex;
+    std::vector<TcpConnectionPtr> serverConns;
+    server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+        if (conn->connected())
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            serverConns.push_back(conn);
+        }
+    });
+    server.start();
+
+    //received只在客户端loop线程中修改
+    EventLoopThread clientThread(ThreadInitCallback(), "send_client");
+    EventLoop* clientLoop = clientThread.startLoop();
+    std::atomic<int64_t> received(0);
+    std::vector<std::unique_ptr<TcpClient>> clients;
+    runAndWait(clientLoop, [&]() {
+        for (int i = 0; i < connections; ++i)
+        {
+            clients.emplace_back(new TcpClient(clientLoop, InetAddress("127.0.0.1", port), "send_bench" + std::to_string(i)));
+            clients.back()->setMessageCallback([&](const TcpConnectionPtr&, Buffer* buf, Timestamp) {
+                received.store(received.load(std::memory_order_relaxed) + static_cast<int64_t>(buf->readableBytesLength()),
+                               std::memory_order_relaxed);
+                buf->retrieveAll();
+            });
+            clients.back()->connect();
+        }
+    });
+
+    //等待连接全部建立
+    int64_t connectStart = bench::nowNanos();
+    base::TimerId poll = loop.runEvery(0.01, [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (static_cast<int>(serverConns.size()) == connections ||
+            bench::nowNanos() - connectStart > static_cast<int64_t>(kTimeoutSeconds * 1e9))
+        {
+            loop.quit();
+        }
+    });
+    loop.loop();
+    loop.cancel(poll);
+    if (static_cast<int>(serverConns.size()) != connections)
+    {
+        spdlog::error("send_bench - only {} of {} connections established", serverConns.size(), connections);
+        return 1;
+    }
+    EventLoop* ioLoop = serverConns.front()->getLoop();
+
+    const std::string message(messageSize, 's');
+    for (int producers : producerList)
+    {
+        int64_t total = static_cast<int64_t>(count) * producers;
+        int64_t expectedBytes = received.load() + total * static_cast<int64_t>(messageSize);
+        uint64_t wakeupsBefore = ioLoop->metrics().get(LoopMetrics::kWakeups);
+        std::vector<int64_t> submitNanos(producers);
+
+        int64_t start = bench::nowNanos();
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]() {
+                int64_t begin = bench::nowNanos();
+                for (int i = 0; i < count; ++i)
+                {
+                    serverConns[static_cast<size_t>(i + p) % serverConns.size()]->send(message);
+                }
+                submitNanos[p] = bench::nowNanos() - begin;
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        while (received.load() < expectedBytes && bench::nowNanos() - start < static_cast<int64_t>(kTimeoutSeconds * 1e9))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        int64_t nanos = bench::nowNanos() - start;
+        uint64_t wakeups = ioLoop->metrics().get(LoopMetrics::kWakeups) - wakeupsBefore;
+
+        int64_t submitTotal = 0;
+        for (int64_t n : submitNanos)
+        {
+            submitTotal += n;
+        }
+        bench::JsonLine("send")
+            .add("producers", producers)
+            .add("connections", connections)
+            .add("message_size", messageSize)
+            .add("messages", total)
+            .addRaw("complete", received.load() >= expectedBytes ? "true" : "false")
+            .add("msgs_per_sec", static_cast<double>(total) * 1e9 / static_cast<double>(nanos))
+            .add("send_ns_per_msg", static_cast<double>(submitTotal) / static_cast<double>(total))
+            .add("msgs_per_wakeup", wakeups > 0 ? static_cast<double>(total) / static_cast<double>(wakeups) : 0.0)
+            .print();
+    }
+
+    //客户端在自己的loop线程中析构 连接关闭还要再经过几次queueInLoop 等它们执行完
+    std::promise<void> destroyed;
+    clientLoop->runInLoop([&]() {
+        clients.clear();
+        clientLoop->runAfter(0.05, [&]() { destroyed.set_value(); });
+    });
+    destroyed.get_future().wait();
+    serverConns.clear();
+    loop.runAfter(0.2, [&]() { loop.quit(); });
+    loop.loop();
+    return 0;
+}
@@ -0,0 +1,115 @@
+//定时器测试 都在loop线程中执行
+//add: runAfter添加count个不会到期的定时器 cancel: 再逐个取消 输出每次操作的纳秒数
+//fire: 添加count个立即到期的定时器 统计从添加到全部执行完的时间
+//cross_thread_add: 其他线程调用runAfter 每次都要经过queueInLoop
+//用法: timer_bench [count] [rounds]
+#include <cstdlib>
+#include <future>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/base/TimerId.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThread.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+void report(const char* test, int count, int64_t nanos)
+{
+    bench::JsonLine("timer")
+        .add("test", test)
+        .add("count", count)
+        .add("ns_per_op", static_cast<double>(nanos) / count)
+        .add("ops_per_sec", count * 1e9 / static_cast<double>(nanos))
+        .print();
+}
+
+//在loop线程中执行func 等待完成
+template <typename Func>
+void runAndWait(EventLoop* loop, Func func)
+{
+    std::promise<void> done;
+    loop->runInLoop([&]() {
+        func();
+        done.set_value();
+    });
+    done.get_future().wait();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 3;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoopThread loopThread(ThreadInitCallback(), "timer_bench");
+    EventLoop* loop = loopThread.startLoop();
+    std::vector<base::TimerId> timers;
+    timers.reserve(count);
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        int64_t addNanos = 0;
+        int64_t cancelNanos = 0;
+        runAndWait(loop, [&]() {
+            //到期时间各不相同 和实际的超时定时器一样
+            int64_t start = bench::nowNanos();
+            for (int i = 0; i < count; ++i)
+            {
+                timers.push_back(loop->runAfter(3600.0 + i * 1e-6, []() {}));
+            }
+            addNanos = bench::nowNanos() - start;
+
+            start = bench::nowNanos();
+            for (const base::TimerId& timer : timers)
+            {
+                loop->cancel(timer);
+            }
+            cancelNanos = bench::nowNanos() - start;
+            timers.clear();
+        });
+        report("add", count, addNanos);
+        report("cancel", count, cancelNanos);
+
+        //timerfd到期后在一次handleRead中执行所有到期的定时器
+        std::promise<int64_t> fired;
+        int remaining = count;
+        int64_t fireStart = 0;
+        runAndWait(loop, [&]() {
+            fireStart = bench::nowNanos();
+            for (int i = 0; i < count; ++i)
+            {
+                loop->runAfter(0.0, [&]() {
+                    if (--remaining == 0)
+                    {
+                        fired.set_value(bench::nowNanos() - fireStart);
+                    }
+                });
+            }
+        });
+        report("fire", count, fired.get_future().get());
+
+        //其他线程添加 包括queueInLoop的开销和loop线程中的addTimerInLoop
+        int64_t start = bench::nowNanos();
+        for (int i = 0; i < count; ++i)
+        {
+            timers.push_back(loop->runAfter(3600.0 + i * 1e-6, []() {}));
+        }
+        runAndWait(loop, []() {});
+        report("cross_thread_add", count, bench::nowNanos() - start);
+        runAndWait(loop, [&]() {
+            for (const base::TimerId& timer : timers)
+            {
+                loop->cancel(timer);
+            }
+        });
+        timers.clear();
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+//卡顿检测开销测试 一个始终可读的eventfd让loop每轮都处理一个事件 统计每秒处理的事件数
+//none: 不启动LoopWatchdog watchdog: 启动LoopWatchdog 前后各测一次none 排除机器状态的漂移
+//loop每次切换回调都会记录activity 两种模式都有这部分开销 可以和之前的版本对比
+//最后让一个读回调阻塞stallMs毫秒 检查是否被发现
+//用法: watchdog_bench [seconds] [thresholdMs] [stallMs]
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Channel.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/LoopWatchdog.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+int main(int argc, char* argv[])
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    double thresholdMs = argc > 2 ? atof(argv[2]) : 50;
+    int stallMs = argc > 3 ? atoi(argv[3]) : 200;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    EventLoop loop;
+    //写入后不读 水平触发下每次epoll_wait都返回它
+    int fd = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+    Channel channel(&loop, fd);
+    int64_t events = 0;
+    bool stall = false;
+    channel.setReadCallback([&](Timestamp) {
+        ++events;
+        if (stall)
+        {
+            stall = false;
+            usleep(stallMs * 1000);
+        }
+    });
+    channel.enableReading();
+
+    LoopWatchdog watchdog(thresholdMs / 1000);
+    const char* modes[] = {"none", "watchdog", "none"};
+    for (const char* mode : modes)
+    {
+        if (std::string(mode) == "watchdog")
+        {
+            watchdog.start();
+        }
+        else
+        {
+            watchdog.stop();
+        }
+        events = 0;
+        int64_t start = bench::nowNanos();
+        loop.runAfter(seconds, [&loop]() { loop.quit(); });
+        loop.loop();
+        double elapsed = static_cast<double>(bench::nowNanos() - start) / 1e9;
+        bench::JsonLine("watchdog")
+            .add("mode", mode)
+            .add("events_per_sec", static_cast<double>(events) / elapsed)
+            .print();
+    }
+
+    //阻塞一次读回调 等检测线程再检查一遍
+    stall = true;
+    loop.runAfter(static_cast<double>(stallMs) / 1000 + thresholdMs / 1000, [&loop]() { loop.quit(); });
+    loop.loop();
+    watchdog.stop();
+    bench::JsonLine("watchdog")
+        .add("mode", "stall")
+        .add("stall_ms", stallMs)
+        .add("threshold_ms", thresholdMs)
+        .add("stalls_detected", static_cast<int64_t>(watchdog.stalls()))
+        .print();
+
+    channel.disableAll();
+    channel.remove();
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,215 @@
+//WebSocket测试
+//unmask: 逐字节异或和WebSocketCodec::unmask(SSE2 + 8字节)的吞吐
+//broadcast: 同一个loop中N个客户端 shared每条消息只编码一次 per_conn每条连接各编码一次
+//用法: websocket_bench [port] [connections] [messages]
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench/BenchUtil.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "myMuduo/net/websocket/WebSocketCodec.h"
+#include "myMuduo/net/websocket/WebSocketServer.h"
+#include "spdlog/spdlog.h"
+
+using namespace myMuduo;
+using namespace myMuduo::net;
+
+namespace {
+
+const int64_t kMinDurationNanos = 200 * 1000 * 1000;
+const size_t kMessageSize = 1024;
+const char kUpgradeRequest[] =
+    "GET /chat HTTP/1.1\r\nHost: 127.0.0.1\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+
+volatile char g_sink = 0;
+
+void unmaskBytewise(char* data, size_t len, const unsigned char mask[4])
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        data[i] = static_cast<char>(data[i] ^ mask[i & 3]);
+    }
+}
+
+template <typename Unmask>
+void runUnmask(const char* mode, size_t size, Unmask unmask)
+{
+    const unsigned char mask[4] = {0x37, 0xfa, 0x21, 0x3d};
+    std::string data(size, 'x');
+    int64_t bytes = 0;
+    int64_t start = bench::nowNanos();
+    int64_t elapsed = 0;
+    while (elapsed < kMinDurationNanos)
+    {
+        unmask(&data[0], data.size(), mask);
+        g_sink = static_cast<char>(g_sink ^ data[size / 2]);
+        bytes += static_cast<int64_t>(size);
+        elapsed = bench::nowNanos() - start;
+    }
+    bench::JsonLine("websocket_unmask")
+        .add("mode", mode)
+        .add("payload_bytes", size)
+        .add("gb_per_sec", static_cast<double>(bytes) / static_cast<double>(elapsed))
+        .print();
+}
+
+//客户端和服务端在同一个loop中 客户端只统计握手应答之后收到的字节数
+class BroadcastBench : noncopyable
+{
+public:
+    BroadcastBench(EventLoop* loop, const InetAddress& listenAddr, int connections, int messages)
+        : loop_(loop)
+        , server_(loop, listenAddr, "websocket_bench")
+        , connections_(connections)
+        , messages_(messages)
+        , message_(kMessageSize, 'm')
+        , received_(0)
+        , phase_(0)
+        , start_(0)
+    {
+        server_.setPingInterval(0);
+        server_.setConnectionCallback([this](const TcpConnectionPtr& conn) {
+            //断开后不能再持有连接 否则socket不会关闭
+            if (!conn->connected())
+            {
+                serverConns_.erase(std::remove(serverConns_.begin(), serverConns_.end(), conn), serverConns_.end());
+                return;
+            }
+            serverConns_.push_back(conn);
+            if (static_cast<int>(serverConns_.size()) == connections_)
+            {
+                loop_->queueInLoop([this]() { startPhase(); });
+            }
+        });
+        server_.start();
+
+        for (int i = 0; i < connections_; ++i)
+        {
+            std::unique_ptr<TcpClient> client(new TcpClient(loop, listenAddr, "ws_client" + std::to_string(i)));
+            client->setConnectionCallback([](const TcpConnectionPtr& conn) {
+                if (conn->connected())
+                {
+                    conn->setContext(false);
+                    conn->send(kUpgradeRequest);
+                }
+            });
+            client->setMessageCallback([this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+                bool* upgraded = conn->getMutableContext()->cast<bool>();
+                if (!*upgraded)
+                {
+                    const char* end = buf->findDelimiter("\r\n\r\n", 4);
+                    if (end == nullptr) return;
+                    buf->retrieve(static_cast<size_t>(end - buf->peek()) + 4);
+                    *upgraded = true;
+                }
+                received_ += buf->readableBytesLength();
+                buf->retrieveAll();
+                if (received_ == expected())
+                {
+                    finishPhase();
+                }
+            });
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    void run()
+    {
+        for (auto& client : clients_)
+        {
+            client->connect();
+        }
+        loop_->loop();
+    }
+
+private:
+    static const char* phaseName(int phase) { return phase == 0 ? "shared" : "per_conn"; }
+
+    size_t expected() const
+    {
+        size_t frameSize = kMessageSize + 4;
+        return frameSize * static_cast<size_t>(messages_) * static_cast<size_t>(connections_);
+    }
+
+    void startPhase()
+    {
+        received_ = 0;
+        start_ = bench::nowNanos();
+        for (int i = 0; i < messages_; ++i)
+        {
+            if (phase_ == 0)
+            {
+                server_.broadcast(message_);
+            }
+            else
+            {
+                for (const TcpConnectionPtr& conn : serverConns_)
+                {
+                    WebSocketServer::send(conn, message_);
+                }
+            }
+        }
+    }
+
+    void finishPhase()
+    {
+        double seconds = static_cast<double>(bench::nowNanos() - start_) / 1e9;
+        bench::JsonLine("websocket_broadcast")
+            .add("mode", phaseName(phase_))
+            .add("connections", connections_)
+            .add("messages", messages_)
+            .add("message_bytes", kMessageSize)
+            .add("deliveries_per_sec", static_cast<double>(messages_) * connections_ / seconds)
+            .print();
+        if (++phase_ < 2)
+        {
+            loop_->queueInLoop([this]() { startPhase(); });
+            return;
+        }
+        for (auto& client : clients_)
+        {
+            client->disconnect();
+        }
+        loop_->runAfter(0.1, [this]() { loop_->quit(); });
+    }
+
+    EventLoop* loop_;
+    WebSocketServer server_;
+    int connections_;
+    int messages_;
+    std::string message_;
+    std::vector<std::unique_ptr<TcpClient>> clients_;
+    std::vector<TcpConnectionPtr> serverConns_;
+    size_t received_;
+    int phase_;
+    int64_t start_;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 18100);
+    int connections = argc > 2 ? atoi(argv[2]) : 64;
+    int messages = argc > 3 ? atoi(argv[3]) : 2000;
+
+    spdlog::set_level(spdlog::level::warn);
+
+    const size_t sizes[] = {64, 1024, 64 * 1024};
+    for (size_t size : sizes)
+    {
+        runUnmask("bytewise", size, unmaskBytewise);
+        runUnmask("word_simd", size, WebSocketCodec::unmask);
+    }
+
+    EventLoop loop;
+    BroadcastBench broadcast(&loop, InetAddress(port, true), connections, messages);
+    broadcast.run();
+    return 0;
+}
@@ -18,7 +18,7 @@ public:
     {
         if (this != &other)
         {
-            InternalData *temp = other.dataPtr_->Clone();
+            InternalData *temp = other.dataPtr_ ? other.dataPtr_->Clone() : nullptr;
             dataPtr_.reset(temp);
         }
         return *this;
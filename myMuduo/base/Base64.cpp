@@ -0,0 +1,47 @@
+#include "myMuduo/base/Base64.h"
+#include <stdint.h>
+
+namespace myMuduo {
+namespace base {
+
+namespace {
+
+const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+}  // namespace
+
+std::string base64Encode(const void* data, size_t len)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::string result;
+    result.reserve((len + 2) / 3 * 4);
+
+    //每3字节编码成4个字符
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3)
+    {
+        uint32_t n = static_cast<uint32_t>(p[i]) << 16 | static_cast<uint32_t>(p[i + 1]) << 8 | p[i + 2];
+        result += kAlphabet[(n >> 18) & 0x3F];
+        result += kAlphabet[(n >> 12) & 0x3F];
+        result += kAlphabet[(n >> 6) & 0x3F];
+        result += kAlphabet[n & 0x3F];
+    }
+
+    //剩下1或2个字节 不足的部分用'='填充
+    if (i < len)
+    {
+        uint32_t n = static_cast<uint32_t>(p[i]) << 16;
+        if (i + 1 < len)
+        {
+            n |= static_cast<uint32_t>(p[i + 1]) << 8;
+        }
+        result += kAlphabet[(n >> 18) & 0x3F];
+        result += kAlphabet[(n >> 12) & 0x3F];
+        result += i + 1 < len ? kAlphabet[(n >> 6) & 0x3F] : '=';
+        result += '=';
+    }
+    return result;
+}
+
+}  // namespace base
+}  // namespace myMuduo
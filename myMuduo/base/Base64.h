@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace myMuduo {
+namespace base {
+
+//标准Base64编码(RFC 4648) 带'='填充
+std::string base64Encode(const void* data, size_t len);
+
+}  // namespace base
+}  // namespace myMuduo
@@ -0,0 +1,126 @@
+#include "myMuduo/base/ByteSearch.h"
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MYMUDUO_BYTESEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace myMuduo {
+namespace base {
+
+namespace {
+
+//'\r'只可能出现在[begin, end - 1)
+const char* findCRLFScalar(const char* begin, const char* end)
+{
+    for (const char* p = begin; p + 1 < end; ++p)
+    {
+        if (p[0] == '\r' && p[1] == '\n') return p;
+    }
+    return nullptr;
+}
+
+#ifdef MYMUDUO_BYTESEARCH_X86
+
+//x86-64一定支持SSE2 不需要检测
+//同时比较p[i]=='\r'和p[i+1]=='\n' 两次错开一个字节的load
+const char* findCRLFSse2(const char* begin, const char* end)
+{
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const char* p = begin;
+    while (end - p >= 17)
+    {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+        __m128i hit = _mm_and_si128(_mm_cmpeq_epi8(first, cr), _mm_cmpeq_epi8(second, lf));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask != 0) return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+    return findCRLFScalar(p, end);
+}
+
+__attribute__((target("avx2"))) const char* findCRLFAvx2(const char* begin, const char* end)
+{
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const char* p = begin;
+    while (end - p >= 33)
+    {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1));
+        __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi8(first, cr), _mm256_cmpeq_epi8(second, lf));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+        if (mask != 0) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return findCRLFSse2(p, end);
+}
+
+#endif
+
+using FindCRLFFunc = const char* (*)(const char*, const char*);
+
+struct Implementation
+{
+    FindCRLFFunc findCRLF;
+    const char* name;
+};
+
+//默认实现是常量初始化的 其他全局对象的构造函数里调用也安全
+//进程启动时再检测一次CPU 支持AVX2就切换过去
+#ifdef MYMUDUO_BYTESEARCH_X86
+Implementation g_implementation = {findCRLFSse2, "sse2"};
+
+class ImplementationSelector
+{
+public:
+    ImplementationSelector()
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            g_implementation = Implementation{findCRLFAvx2, "avx2"};
+        }
+    }
+};
+
+ImplementationSelector implementationSelector;
+#else
+Implementation g_implementation = {findCRLFScalar, "scalar"};
+#endif
+
+}  // namespace
+
+//单字节查找glibc的memchr已经按CPU选择了向量实现 直接用它
+const char* findByte(const char* begin, const char* end, char c)
+{
+    if (begin >= end) return nullptr;
+    return static_cast<const char*>(memchr(begin, c, static_cast<size_t>(end - begin)));
+}
+
+const char* findCRLF(const char* begin, const char* end) { return g_implementation.findCRLF(begin, end); }
+
+const char* findDelimiter(const char* begin, const char* end, const char* delim, size_t delimLength)
+{
+    if (delimLength == 0) return begin;
+    if (delimLength == 1) return findByte(begin, end, delim[0]);
+    if (delimLength == 2 && delim[0] == '\r' && delim[1] == '\n') return findCRLF(begin, end);
+
+    const char* p = begin;
+    while (static_cast<size_t>(end - p) >= delimLength)
+    {
+        p = findByte(p, end - delimLength + 1, delim[0]);
+        if (p == nullptr) return nullptr;
+        if (memcmp(p + 1, delim + 1, delimLength - 1) == 0) return p;
+        ++p;
+    }
+    return nullptr;
+}
+
+const char* byteSearchImplementation() { return g_implementation.name; }
+
+}  // namespace base
+}  // namespace myMuduo
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+
+namespace myMuduo {
+namespace base {
+
+//在[begin, end)中查找 找不到返回nullptr
+const char* findByte(const char* begin, const char* end, char c);
+
+//查找"\r\n" 返回'\r'的位置
+//x86-64上用SSE2 运行时检测到AVX2时用AVX2 其他平台退化成逐字节比较
+const char* findCRLF(const char* begin, const char* end);
+
+//查找'\n'
+inline const char* findEOL(const char* begin, const char* end) { return findByte(begin, end, '\n'); }
+
+//查找任意分隔符 先用findByte定位首字节再比较剩余部分
+const char* findDelimiter(const char* begin, const char* end, const char* delim, size_t delimLength);
+
+//当前实际使用的实现 "avx2" "sse2" "scalar"
+const char* byteSearchImplementation();
+
+}  // namespace base
+}  // namespace myMuduo
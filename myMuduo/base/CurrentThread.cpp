@@ -1,4 +1,7 @@
 #include "myMuduo/base/CurrentThread.h"
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
 
 namespace myMuduo {
 namespace base {
@@ -52,6 +55,44 @@ const char* threadName()
     }
     return t_threadName ? t_threadName : "unknown";
 }
+
+void setName(const char* name)
+{
+    //内核限制16字节 包括结尾的0
+    char buf[16];
+    size_t len = strnlen(name, sizeof(buf) - 1);
+    memcpy(buf, name, len);
+    buf[len] = '\0';
+    pthread_setname_np(pthread_self(), buf);
+}
+
+bool setAffinity(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool setLocalMemoryPolicy()
+{
+    //MPOL_LOCAL 直接用系统调用 不依赖libnuma
+    const int kMpolLocal = 4;
+    return syscall(SYS_set_mempolicy, kMpolLocal, nullptr, 0) == 0;
+}
+
+int cpu() { return sched_getcpu(); }
+
+int numaNode()
+{
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+    {
+        return -1;
+    }
+    return static_cast<int>(node);
+}
 }  // namespace CurrentThread
 }  // namespace base
 }  // namespace myMuduo
\ No newline at end of file
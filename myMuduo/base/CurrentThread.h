@@ -23,6 +23,20 @@ int tidStringLength();
 
 const char* threadName();
 
+//设置内核中的线程名 top -H和/proc中可见 超过15个字节会被截断
+void setName(const char* name);
+
+//把当前线程绑定到一个cpu 失败返回false
+bool setAffinity(int cpu);
+
+//之后新分配的内存页放在当前线程所在cpu的NUMA节点上 不受进程级interleave等策略影响
+//需要先绑定cpu 否则线程迁移后内存就不是本地的了
+bool setLocalMemoryPolicy();
+
+//当前所在的cpu和NUMA节点 失败返回-1
+int cpu();
+int numaNode();
+
 }  // namespace CurrentThread
 
 }  // namespace base
@@ -0,0 +1,99 @@
+#include "myMuduo/base/Histogram.h"
+
+namespace myMuduo {
+namespace base {
+
+const int Histogram::kSubBucketBits;
+const int Histogram::kSubBuckets;
+const int Histogram::kNumBuckets;
+
+Histogram::Snapshot::Snapshot()
+    : buckets(kNumBuckets, 0)
+    , count(0)
+    , sum(0)
+    , max(0)
+{
+}
+
+void Histogram::Snapshot::merge(const Snapshot& other)
+{
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    if (other.max > max)
+    {
+        max = other.max;
+    }
+}
+
+int64_t Histogram::Snapshot::percentile(double p) const
+{
+    //各个桶和count是分别读的 以桶的总和为准
+    uint64_t total = 0;
+    for (uint64_t n : buckets)
+    {
+        total += n;
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(total));
+    if (rank >= total)
+    {
+        rank = total - 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+        seen += buckets[i];
+        if (seen > rank)
+        {
+            int64_t upper = bucketUpperBound(i);
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+Histogram::Histogram()
+    : count_(0)
+    , sum_(0)
+    , max_(0)
+{
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+Histogram::Snapshot Histogram::snapshot() const
+{
+    Snapshot snapshot;
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+        snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count = count_.load(std::memory_order_relaxed);
+    snapshot.sum = sum_.load(std::memory_order_relaxed);
+    snapshot.max = max_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+int64_t Histogram::bucketUpperBound(int index)
+{
+    if (index < kSubBuckets)
+    {
+        return index;
+    }
+    int shift = index / kSubBuckets - 1;
+    uint64_t sub = static_cast<uint64_t>(index % kSubBuckets);
+    uint64_t lower = (static_cast<uint64_t>(kSubBuckets) + sub) << shift;
+    return static_cast<int64_t>(lower + (static_cast<uint64_t>(1) << shift) - 1);
+}
+
+}  // namespace base
+}  // namespace myMuduo
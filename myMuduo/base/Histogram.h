@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "myMuduo/base/noncopyable.h"
+
+namespace myMuduo {
+namespace base {
+
+//HDR风格的对数-线性直方图 每个2的幂区间再均分成8份 相对误差不超过12.5%
+//只能有一个线程record 其他线程可以随时snapshot 计数用relaxed原子变量 写入和普通变量一样没有lock前缀
+class Histogram : noncopyable
+{
+public:
+    static const int kSubBucketBits = 3;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+    //value非负 最高位最多是第62位
+    static const int kNumBuckets = (63 - kSubBucketBits + 1) * kSubBuckets;
+
+    //合并之后的结果 普通的值类型
+    struct Snapshot
+    {
+        Snapshot();
+
+        void merge(const Snapshot& other);
+        //返回第p(0~1)分位所在桶的上界 没有数据时返回0
+        int64_t percentile(double p) const;
+        double mean() const { return count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0; }
+
+        std::vector<uint64_t> buckets;
+        uint64_t count;
+        int64_t sum;
+        int64_t max;
+    };
+
+    Histogram();
+
+    //负数按0记
+    void record(int64_t value)
+    {
+        if (value < 0)
+        {
+            value = 0;
+        }
+        increment(&buckets_[bucketIndex(value)], 1);
+        increment(&count_, 1);
+        sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed))
+        {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    Snapshot snapshot() const;
+
+    static int bucketIndex(int64_t value)
+    {
+        uint64_t v = static_cast<uint64_t>(value);
+        if (v < static_cast<uint64_t>(kSubBuckets))
+        {
+            return static_cast<int>(v);
+        }
+        int msb = 63 - __builtin_clzll(v);
+        int shift = msb - kSubBucketBits;
+        int sub = static_cast<int>((v >> shift) & (kSubBuckets - 1));
+        return (shift + 1) * kSubBuckets + sub;
+    }
+
+    //桶中最大的值(包含)
+    static int64_t bucketUpperBound(int index);
+
+private:
+    static void increment(std::atomic<uint64_t>* counter, uint64_t n)
+    {
+        counter->store(counter->load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> buckets_[kNumBuckets];
+    std::atomic<uint64_t> count_;
+    std::atomic<int64_t> sum_;
+    std::atomic<int64_t> max_;
+};
+
+}  // namespace base
+}  // namespace myMuduo
@@ -0,0 +1,36 @@
+#include "myMuduo/base/LogRing.h"
+
+namespace myMuduo {
+namespace base {
+
+const size_t LogRecord::kSize;
+const size_t LogRecord::kPayloadSize;
+
+namespace {
+
+size_t roundUpPowerOfTwo(size_t n)
+{
+    size_t rounded = 1;
+    while (rounded < n)
+    {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+}  // namespace
+
+LogRing::LogRing(size_t capacity)
+    : records_(roundUpPowerOfTwo(capacity))
+    , mask_(records_.size() - 1)
+    , closed_(false)
+    , head_(0)
+    , cachedTail_(0)
+    , tail_(0)
+    , cachedHead_(0)
+    , dropped_(0)
+{
+}
+
+}  // namespace base
+}  // namespace myMuduo
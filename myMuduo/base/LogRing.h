@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "myMuduo/base/noncopyable.h"
+#include "spdlog/fmt/fmt.h"
+
+namespace myMuduo {
+namespace base {
+
+//一条定长的二进制日志 生产者只做拷贝 格式化留给后台线程
+//format只存指针 必须是字符串字面量 参数按 类型标记+值 依次写在payload中 字符串拷贝进来
+struct LogRecord
+{
+    static const size_t kSize = 256;
+    static const size_t kPayloadSize = 224;
+
+    enum ArgType : uint8_t
+    {
+        kInt,
+        kUint,
+        kDouble,
+        kBool,
+        kChar,
+        kPointer,
+        kString  //2字节长度+内容
+    };
+
+    const char* format;
+    int64_t micros;  //写入时间 自epoch的微秒
+    int tid;
+    uint8_t level;
+    uint8_t argCount;
+    bool truncated;   //payload放不下 后面的参数丢掉了
+    uint16_t length;  //payload已用的字节数
+    char payload[kPayloadSize];
+};
+
+static_assert(sizeof(LogRecord) == LogRecord::kSize, "LogRecord must be fixed size");
+
+namespace detail {
+
+inline void appendLogArg(LogRecord* record, LogRecord::ArgType type, const void* data, size_t n)
+{
+    if (record->truncated || record->length + 1 + n > LogRecord::kPayloadSize)
+    {
+        record->truncated = true;
+        return;
+    }
+    char* p = record->payload + record->length;
+    *p = static_cast<char>(type);
+    memcpy(p + 1, data, n);
+    record->length = static_cast<uint16_t>(record->length + 1 + n);
+    ++record->argCount;
+}
+
+//放不下时截断字符串本身 参数个数不变
+inline void appendLogString(LogRecord* record, const char* data, size_t n)
+{
+    if (record->truncated || static_cast<size_t>(record->length) + 3 > LogRecord::kPayloadSize)
+    {
+        record->truncated = true;
+        return;
+    }
+    size_t room = LogRecord::kPayloadSize - record->length - 3;
+    uint16_t len = static_cast<uint16_t>(n < room ? n : room);
+    char* p = record->payload + record->length;
+    *p = static_cast<char>(LogRecord::kString);
+    memcpy(p + 1, &len, sizeof(len));
+    memcpy(p + 3, data, len);
+    record->length = static_cast<uint16_t>(record->length + 3 + len);
+    ++record->argCount;
+}
+
+inline void encodeLogArg(LogRecord* record, int64_t v) { appendLogArg(record, LogRecord::kInt, &v, sizeof(v)); }
+inline void encodeLogArg(LogRecord* record, uint64_t v) { appendLogArg(record, LogRecord::kUint, &v, sizeof(v)); }
+inline void encodeLogArg(LogRecord* record, int v) { encodeLogArg(record, static_cast<int64_t>(v)); }
+inline void encodeLogArg(LogRecord* record, long long v) { encodeLogArg(record, static_cast<int64_t>(v)); }
+inline void encodeLogArg(LogRecord* record, unsigned v) { encodeLogArg(record, static_cast<uint64_t>(v)); }
+inline void encodeLogArg(LogRecord* record, unsigned long long v) { encodeLogArg(record, static_cast<uint64_t>(v)); }
+inline void encodeLogArg(LogRecord* record, double v) { appendLogArg(record, LogRecord::kDouble, &v, sizeof(v)); }
+inline void encodeLogArg(LogRecord* record, float v) { encodeLogArg(record, static_cast<double>(v)); }
+inline void encodeLogArg(LogRecord* record, bool v) { appendLogArg(record, LogRecord::kBool, &v, sizeof(v)); }
+inline void encodeLogArg(LogRecord* record, char v) { appendLogArg(record, LogRecord::kChar, &v, sizeof(v)); }
+inline void encodeLogArg(LogRecord* record, const void* v) { appendLogArg(record, LogRecord::kPointer, &v, sizeof(v)); }
+inline void encodeLogArg(LogRecord* record, const char* v) { appendLogString(record, v, strlen(v)); }
+inline void encodeLogArg(LogRecord* record, const std::string& v) { appendLogString(record, v.data(), v.size()); }
+
+//其他类型在生产者线程先格式化成字符串
+template <typename T>
+void encodeLogArg(LogRecord* record, const T& v)
+{
+    fmt::memory_buffer buf;
+    fmt::format_to(std::back_inserter(buf), "{}", v);
+    appendLogString(record, buf.data(), buf.size());
+}
+
+}  // namespace detail
+
+//单生产者单消费者的LogRecord环形队列 每个写日志的线程一个 后台线程是唯一的消费者
+//head_和tail_分在不同的cache line 双方各自缓存对方的位置 队列不空不满时不用读对方的变量
+class LogRing : noncopyable
+{
+public:
+    //容量向上取2的幂
+    explicit LogRing(size_t capacity);
+
+    //生产者 满了返回nullptr
+    LogRecord* tryAcquire()
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_)
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_)
+            {
+                return nullptr;
+            }
+        }
+        return &records_[tail & mask_];
+    }
+    void publish() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+    //只有生产者写 不需要原子的读改写
+    void addDropped() { dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    //消费者 空了返回nullptr
+    LogRecord* front()
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_)
+        {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_)
+            {
+                return nullptr;
+            }
+        }
+        return &records_[head & mask_];
+    }
+    void pop() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    //所属线程已经退出 后台线程取完剩下的记录后释放
+    void close() { closed_.store(true, std::memory_order_release); }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    static const size_t kCacheLineSize = 64;
+
+    std::vector<LogRecord> records_;
+    const size_t mask_;
+    std::atomic<bool> closed_;
+
+    char pad0_[kCacheLineSize];
+    std::atomic<size_t> head_;  //消费者写
+    size_t cachedTail_;
+
+    char pad1_[kCacheLineSize];
+    std::atomic<size_t> tail_;  //生产者写
+    size_t cachedHead_;
+    std::atomic<uint64_t> dropped_;
+
+    char pad2_[kCacheLineSize];
+};
+
+}  // namespace base
+}  // namespace myMuduo
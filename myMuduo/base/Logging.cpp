@@ -0,0 +1,345 @@
+#include "myMuduo/base/Logging.h"
+#include <sched.h>
+#include <unistd.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "myMuduo/base/CurrentThread.h"
+#include "myMuduo/base/Thread.h"
+#include "spdlog/async.h"
+#include "spdlog/fmt/bundled/args.h"
+
+namespace myMuduo {
+namespace base {
+namespace Logging {
+
+void enableAsync(size_t queueSize)
+{
+    std::shared_ptr<spdlog::logger> old = spdlog::default_logger();
+    if (std::dynamic_pointer_cast<spdlog::async_logger>(old))
+    {
+        spdlog::warn("Logging::enableAsync() - default logger is already async");
+        return;
+    }
+
+    //后台只开一个线程 多个线程写同一个sink时顺序会乱
+    spdlog::init_thread_pool(queueSize, 1, []() { CurrentThread::setName("log-async"); });
+    std::shared_ptr<spdlog::async_logger> logger =
+        std::make_shared<spdlog::async_logger>(old->name(), old->sinks().begin(), old->sinks().end(),
+                                               spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+    logger->set_level(old->level());
+    logger->flush_on(old->flush_level());
+    spdlog::set_default_logger(logger);
+}
+
+void flush()
+{
+    std::shared_ptr<spdlog::details::thread_pool> pool = spdlog::thread_pool();
+    spdlog::default_logger()->flush();
+    //异步logger的flush只是把flush请求排进队列 等队列清空
+    while (pool && pool->queue_size() > 0)
+    {
+        usleep(1000);
+    }
+}
+
+size_t dropped()
+{
+    std::shared_ptr<spdlog::details::thread_pool> pool = spdlog::thread_pool();
+    return pool ? pool->overrun_counter() : 0;
+}
+
+int compiledLevel() { return MYMUDUO_LOG_LEVEL; }
+
+namespace detail {
+
+std::atomic<bool> g_ringEnabled(false);
+
+namespace {
+
+const int kIdleSleepMicros = 1000;
+
+//日志队列的后台线程 轮流取出各个线程队列中的记录 格式化后写到sink
+class RingBackend : noncopyable
+{
+public:
+    RingBackend()
+        : recordsPerThread_(kDefaultRingSize)
+        , policy_(kDropNewest)
+        , running_(false)
+        , written_(0)
+        , closedDropped_(0)
+    {
+    }
+
+    ~RingBackend() { stop(); }
+
+    void start(size_t recordsPerThread, OverflowPolicy policy)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_)
+        {
+            spdlog::warn("Logging::enableRing() - log ring is already enabled");
+            return;
+        }
+        std::shared_ptr<spdlog::logger> logger = spdlog::default_logger();
+        loggerName_ = logger->name();
+        sinks_ = logger->sinks();
+        recordsPerThread_ = recordsPerThread;
+        policy_ = policy;
+        running_ = true;
+        threadPtr_.reset(new Thread([this]() { threadFunc(); }, "log-ring"));
+        threadPtr_->start();
+        g_ringEnabled.store(true, std::memory_order_release);
+    }
+
+    void stop()
+    {
+        std::unique_ptr<Thread> thread;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_)
+            {
+                return;
+            }
+            g_ringEnabled.store(false, std::memory_order_release);
+            running_ = false;
+            thread.swap(threadPtr_);
+        }
+        //后台线程看到running_为false后再取一遍所有队列才退出
+        thread->join();
+    }
+
+    LogRing* threadRing()
+    {
+        //线程退出时标记队列关闭 后台线程取完剩下的记录后释放
+        struct Holder
+        {
+            ~Holder()
+            {
+                if (ring)
+                {
+                    ring->close();
+                }
+            }
+            std::shared_ptr<LogRing> ring;
+        };
+        static thread_local Holder t_holder;
+
+        if (!t_holder.ring)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            t_holder.ring = std::make_shared<LogRing>(recordsPerThread_);
+            rings_.push_back(t_holder.ring);
+        }
+        return t_holder.ring.get();
+    }
+
+    OverflowPolicy policy() const { return policy_; }
+
+    RingStats stats()
+    {
+        RingStats stats;
+        stats.written = written_.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.dropped = closedDropped_;
+        for (const std::shared_ptr<LogRing>& ring : rings_)
+        {
+            stats.dropped += ring->dropped();
+        }
+        stats.rings = rings_.size();
+        return stats;
+    }
+
+private:
+    void threadFunc()
+    {
+        std::vector<std::shared_ptr<LogRing>> rings;
+        fmt::memory_buffer buf;
+        while (true)
+        {
+            bool running = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                running = running_;
+                //先看关闭标记再取记录 关闭之后不会再有新记录 取完就可以释放
+                for (auto it = rings_.begin(); it != rings_.end();)
+                {
+                    if ((*it)->closed() && (*it)->size() == 0)
+                    {
+                        closedDropped_ += (*it)->dropped();
+                        it = rings_.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+                rings = rings_;
+            }
+
+            size_t count = 0;
+            for (const std::shared_ptr<LogRing>& ring : rings)
+            {
+                LogRecord* record = nullptr;
+                while ((record = ring->front()) != nullptr)
+                {
+                    write(*record, &buf);
+                    ring->pop();
+                    ++count;
+                }
+            }
+
+            if (count > 0)
+            {
+                written_.fetch_add(count, std::memory_order_relaxed);
+                for (const spdlog::sink_ptr& sink : sinks_)
+                {
+                    sink->flush();
+                }
+            }
+            else if (!running)
+            {
+                break;
+            }
+            else
+            {
+                usleep(kIdleSleepMicros);
+            }
+        }
+    }
+
+    void write(const LogRecord& record, fmt::memory_buffer* buf)
+    {
+        buf->clear();
+        format(record, buf);
+        spdlog::level::level_enum level = static_cast<spdlog::level::level_enum>(record.level);
+        spdlog::details::log_msg msg(spdlog::log_clock::time_point(std::chrono::microseconds(record.micros)),
+                                     spdlog::source_loc(), loggerName_, level,
+                                     spdlog::string_view_t(buf->data(), buf->size()));
+        msg.thread_id = static_cast<size_t>(record.tid);
+        for (const spdlog::sink_ptr& sink : sinks_)
+        {
+            if (sink->should_log(level))
+            {
+                sink->log(msg);
+            }
+        }
+    }
+
+    static void format(const LogRecord& record, fmt::memory_buffer* buf)
+    {
+        fmt::dynamic_format_arg_store<fmt::format_context> args;
+        const char* p = record.payload;
+        for (uint8_t i = 0; i < record.argCount; ++i)
+        {
+            LogRecord::ArgType type = static_cast<LogRecord::ArgType>(*p++);
+            switch (type)
+            {
+                case LogRecord::kInt:
+                    args.push_back(load<int64_t>(&p));
+                    break;
+                case LogRecord::kUint:
+                    args.push_back(load<uint64_t>(&p));
+                    break;
+                case LogRecord::kDouble:
+                    args.push_back(load<double>(&p));
+                    break;
+                case LogRecord::kBool:
+                    args.push_back(load<bool>(&p));
+                    break;
+                case LogRecord::kChar:
+                    args.push_back(load<char>(&p));
+                    break;
+                case LogRecord::kPointer:
+                    args.push_back(load<const void*>(&p));
+                    break;
+                case LogRecord::kString:
+                {
+                    uint16_t len = load<uint16_t>(&p);
+                    args.push_back(fmt::string_view(p, len));
+                    p += len;
+                    break;
+                }
+            }
+        }
+
+        try
+        {
+            fmt::vformat_to(std::back_inserter(*buf), fmt::string_view(record.format), args);
+        }
+        catch (const fmt::format_error& e)
+        {
+            buf->clear();
+            fmt::format_to(std::back_inserter(*buf), "[format error: {}] {}", e.what(), record.format);
+        }
+        if (record.truncated)
+        {
+            fmt::format_to(std::back_inserter(*buf), " [truncated]");
+        }
+    }
+
+    template <typename T>
+    static T load(const char** p)
+    {
+        T v;
+        memcpy(&v, *p, sizeof(v));
+        *p += sizeof(v);
+        return v;
+    }
+
+    std::mutex mutex_;  //保护下面除written_以外的成员
+    std::vector<std::shared_ptr<LogRing>> rings_;
+    std::vector<spdlog::sink_ptr> sinks_;
+    std::string loggerName_;
+    size_t recordsPerThread_;
+    OverflowPolicy policy_;
+    bool running_;
+    std::unique_ptr<Thread> threadPtr_;
+    std::atomic<uint64_t> written_;
+    uint64_t closedDropped_;  //已经释放的队列丢掉的条数
+};
+
+RingBackend& backend()
+{
+    static RingBackend instance;
+    return instance;
+}
+
+}  // namespace
+
+LogRing* threadRing() { return backend().threadRing(); }
+
+LogRecord* acquireSlow(LogRing* ring)
+{
+    if (backend().policy() == kDropNewest)
+    {
+        ring->addDropped();
+        return nullptr;
+    }
+    LogRecord* record = nullptr;
+    while ((record = ring->tryAcquire()) == nullptr)
+    {
+        if (!g_ringEnabled.load(std::memory_order_acquire))
+        {
+            ring->addDropped();
+            return nullptr;
+        }
+        sched_yield();
+    }
+    return record;
+}
+
+}  // namespace detail
+
+void enableRing(size_t recordsPerThread, OverflowPolicy policy) { detail::backend().start(recordsPerThread, policy); }
+
+void stopRing() { detail::backend().stop(); }
+
+RingStats ringStats() { return detail::backend().stats(); }
+
+}  // namespace Logging
+}  // namespace base
+}  // namespace myMuduo
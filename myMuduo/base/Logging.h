@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "myMuduo/base/CurrentThread.h"
+#include "myMuduo/base/LogRing.h"
+#include "myMuduo/base/Timestamp.h"
+#include "spdlog/spdlog.h"
+
+//编译期日志级别 数值和spdlog::level一致 0 trace 1 debug 2 info
+//低于它的MYMUDUO_LOG_TRACE/MYMUDUO_LOG_DEBUG直接编译掉 参数也不求值 用在每个事件都会经过的热路径上
+//cmake -DMYMUDUO_LOG_LEVEL=0 打开全部热路径日志
+#ifndef MYMUDUO_LOG_LEVEL
+#define MYMUDUO_LOG_LEVEL 2
+#endif
+
+//MYMUDUO_LOG_xxx的格式串必须是字符串字面量 启用了日志队列(Logging::enableRing)时只保存它的指针
+//编译掉时放在sizeof中 参数仍然算作被使用 格式串也照样在编译期检查
+#if MYMUDUO_LOG_LEVEL <= 0
+#define MYMUDUO_LOG_TRACE(...) ::myMuduo::base::Logging::log(spdlog::level::trace, __VA_ARGS__)
+#else
+#define MYMUDUO_LOG_TRACE(...) static_cast<void>(sizeof(spdlog::trace(__VA_ARGS__), 0))
+#endif
+
+#if MYMUDUO_LOG_LEVEL <= 1
+#define MYMUDUO_LOG_DEBUG(...) ::myMuduo::base::Logging::log(spdlog::level::debug, __VA_ARGS__)
+#else
+#define MYMUDUO_LOG_DEBUG(...) static_cast<void>(sizeof(spdlog::debug(__VA_ARGS__), 0))
+#endif
+
+#define MYMUDUO_LOG_INFO(...) ::myMuduo::base::Logging::log(spdlog::level::info, __VA_ARGS__)
+#define MYMUDUO_LOG_WARN(...) ::myMuduo::base::Logging::log(spdlog::level::warn, __VA_ARGS__)
+#define MYMUDUO_LOG_ERROR(...) ::myMuduo::base::Logging::log(spdlog::level::err, __VA_ARGS__)
+
+namespace myMuduo {
+namespace base {
+namespace Logging {
+
+const size_t kDefaultQueueSize = 8192;
+
+//把spdlog的默认logger换成异步的 沿用原来的sink和级别
+//IO线程只负责格式化和入队 写sink由spdlog的后台线程完成
+//队列满时覆盖最旧的一条 不阻塞IO线程 被覆盖的条数见dropped()
+//在启动loop之前调用 之后库中和用户的spdlog::xxx调用都走异步logger
+void enableAsync(size_t queueSize = kDefaultQueueSize);
+
+//等后台线程写完队列中已有的日志
+void flush();
+
+//队列满时被丢弃的日志条数 没有启用异步时返回0
+size_t dropped();
+
+//编译期日志级别 MYMUDUO_LOG_LEVEL
+int compiledLevel();
+
+const size_t kDefaultRingSize = 4096;
+
+//日志队列满时的处理
+enum OverflowPolicy
+{
+    kDropNewest,  //丢掉这一条 计入dropped 不阻塞IO线程
+    kBlock        //等后台线程腾出位置
+};
+
+//每个写日志的线程一个LogRing 存放定长的二进制记录(格式串指针+参数)
+//一个后台线程轮流取出各个队列的记录 格式化后写到默认logger的sink中
+//线程之间不再争用同一个队列 格式化也移出了IO线程 代价是不同线程的日志之间不保证顺序
+//只影响MYMUDUO_LOG_xxx 直接调用spdlog::xxx的地方照旧
+void enableRing(size_t recordsPerThread = kDefaultRingSize, OverflowPolicy policy = kDropNewest);
+
+//取完所有队列中的记录后停止后台线程 之后MYMUDUO_LOG_xxx回到同步的spdlog
+//要在写日志的线程都停止之后调用 否则之后写入的记录要等下一次enableRing才会输出
+void stopRing();
+
+struct RingStats
+{
+    uint64_t written;  //后台线程已经输出的条数
+    uint64_t dropped;  //队列满时丢掉的条数
+    size_t rings;      //当前的队列个数
+};
+RingStats ringStats();
+
+namespace detail {
+
+extern std::atomic<bool> g_ringEnabled;
+
+//当前线程的队列 第一次调用时创建并登记到后台线程
+LogRing* threadRing();
+//队列满时按OverflowPolicy处理 返回nullptr表示丢掉
+LogRecord* acquireSlow(LogRing* ring);
+
+}  // namespace detail
+
+template <size_t N, typename... Args>
+void log(spdlog::level::level_enum level, const char (&format)[N], const Args&... args)
+{
+    spdlog::logger* logger = spdlog::default_logger_raw();
+    if (!logger->should_log(level))
+    {
+        return;
+    }
+    if (!detail::g_ringEnabled.load(std::memory_order_acquire))
+    {
+        logger->log(level, fmt::runtime(format), args...);
+        return;
+    }
+
+    LogRing* ring = detail::threadRing();
+    LogRecord* record = ring->tryAcquire();
+    if (record == nullptr && (record = detail::acquireSlow(ring)) == nullptr)
+    {
+        return;
+    }
+    record->format = format;
+    record->micros = Timestamp::now().microSecondsSinceEpoch();
+    record->tid = CurrentThread::tid();
+    record->level = static_cast<uint8_t>(level);
+    record->argCount = 0;
+    record->truncated = false;
+    record->length = 0;
+    int expand[] = {0, (base::detail::encodeLogArg(record, args), 0)...};
+    static_cast<void>(expand);
+    ring->publish();
+}
+
+}  // namespace Logging
+}  // namespace base
+}  // namespace myMuduo
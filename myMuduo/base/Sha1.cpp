@@ -0,0 +1,112 @@
+#include "myMuduo/base/Sha1.h"
+#include <stdint.h>
+#include <cstring>
+
+namespace myMuduo {
+namespace base {
+
+namespace {
+
+inline uint32_t rotateLeft(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+//处理一个64字节的分组
+void transform(uint32_t state[5], const unsigned char block[64])
+{
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i)
+    {
+        w[i] = static_cast<uint32_t>(block[i * 4]) << 24 | static_cast<uint32_t>(block[i * 4 + 1]) << 16 |
+               static_cast<uint32_t>(block[i * 4 + 2]) << 8 | static_cast<uint32_t>(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 80; ++i)
+    {
+        w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    for (int i = 0; i < 80; ++i)
+    {
+        uint32_t f;
+        uint32_t k;
+        if (i < 20)
+        {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        }
+        else if (i < 40)
+        {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        }
+        else if (i < 60)
+        {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        }
+        else
+        {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t temp = rotateLeft(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotateLeft(b, 30);
+        b = a;
+        a = temp;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+}  // namespace
+
+std::string sha1(const void* data, size_t len)
+{
+    uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    size_t remaining = len;
+    while (remaining >= 64)
+    {
+        transform(state, p);
+        p += 64;
+        remaining -= 64;
+    }
+
+    //末尾补0x80 再补0 最后8字节是按位计的长度(大端)
+    unsigned char tail[128];
+    memset(tail, 0, sizeof tail);
+    memcpy(tail, p, remaining);
+    tail[remaining] = 0x80;
+    size_t tailLength = remaining + 1 + 8 <= 64 ? 64 : 128;
+    uint64_t bits = static_cast<uint64_t>(len) * 8;
+    for (int i = 0; i < 8; ++i)
+    {
+        tail[tailLength - 1 - i] = static_cast<unsigned char>(bits >> (i * 8));
+    }
+    transform(state, tail);
+    if (tailLength == 128)
+    {
+        transform(state, tail + 64);
+    }
+
+    std::string digest(20, '\0');
+    for (int i = 0; i < 5; ++i)
+    {
+        digest[i * 4] = static_cast<char>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<char>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<char>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<char>(state[i]);
+    }
+    return digest;
+}
+
+}  // namespace base
+}  // namespace myMuduo
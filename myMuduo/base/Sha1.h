@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace myMuduo {
+namespace base {
+
+//SHA-1摘要 只用于WebSocket握手计算Sec-WebSocket-Accept 不要用于安全用途
+//返回20字节的原始摘要
+std::string sha1(const void* data, size_t len);
+
+}  // namespace base
+}  // namespace myMuduo
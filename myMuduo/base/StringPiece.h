@@ -0,0 +1,97 @@
+#pragma once
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace myMuduo {
+namespace base {
+
+//不拥有内存的字符串视图 C++11没有std::string_view
+//只在指向的内存有效期间使用 比如Buffer里的数据在retrieve之前
+class StringPiece
+{
+public:
+    StringPiece()
+        : ptr_(nullptr)
+        , length_(0)
+    {
+    }
+    StringPiece(const char* str)
+        : ptr_(str)
+        , length_(static_cast<size_t>(strlen(str)))
+    {
+    }
+    StringPiece(const std::string& str)
+        : ptr_(str.data())
+        , length_(str.size())
+    {
+    }
+    StringPiece(const char* offset, size_t len)
+        : ptr_(offset)
+        , length_(len)
+    {
+    }
+
+    const char* data() const { return ptr_; }
+    size_t size() const { return length_; }
+    bool empty() const { return length_ == 0; }
+    const char* begin() const { return ptr_; }
+    const char* end() const { return ptr_ + length_; }
+
+    void clear()
+    {
+        ptr_ = nullptr;
+        length_ = 0;
+    }
+    void set(const char* buffer, size_t len)
+    {
+        ptr_ = buffer;
+        length_ = len;
+    }
+
+    char operator[](size_t i) const { return ptr_[i]; }
+
+    void removePrefix(size_t n)
+    {
+        ptr_ += n;
+        length_ -= n;
+    }
+    void removeSuffix(size_t n) { length_ -= n; }
+
+    bool operator==(const StringPiece& rhs) const
+    {
+        return length_ == rhs.length_ && (length_ == 0 || memcmp(ptr_, rhs.ptr_, length_) == 0);
+    }
+    bool operator!=(const StringPiece& rhs) const { return !(*this == rhs); }
+
+    int compare(const StringPiece& rhs) const
+    {
+        size_t len = length_ < rhs.length_ ? length_ : rhs.length_;
+        int r = len == 0 ? 0 : memcmp(ptr_, rhs.ptr_, len);
+        if (r == 0)
+        {
+            if (length_ < rhs.length_) r = -1;
+            else if (length_ > rhs.length_) r = 1;
+        }
+        return r;
+    }
+
+    bool startsWith(const StringPiece& x) const
+    {
+        return length_ >= x.length_ && (x.length_ == 0 || memcmp(ptr_, x.ptr_, x.length_) == 0);
+    }
+
+    std::string toString() const { return std::string(ptr_, length_); }
+
+private:
+    const char* ptr_;
+    size_t length_;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const StringPiece& piece)
+{
+    return os.write(piece.data(), static_cast<std::streamsize>(piece.size()));
+}
+
+}  // namespace base
+}  // namespace myMuduo
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include "myMuduo/base/StringPiece.h"
+
+namespace myMuduo {
+namespace base {
+
+//相对于某个起始位置的偏移 HTTP和RESP解析器用它记录字段 数据留在Buffer中
+struct Slice
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+//[begin, end)相对于data的偏移 调用方保证长度不超过uint32_t
+inline Slice makeSlice(const char* data, const char* begin, const char* end)
+{
+    Slice slice;
+    slice.offset = static_cast<uint32_t>(begin - data);
+    slice.length = static_cast<uint32_t>(end - begin);
+    return slice;
+}
+
+//协议关键字都是ASCII 只对字母忽略大小写
+inline bool equalsIgnoreCase(const StringPiece& a, const StringPiece& b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        char x = a[i];
+        char y = b[i];
+        if (x != y && (static_cast<char>(x | 0x20) != static_cast<char>(y | 0x20) ||
+                       static_cast<unsigned char>((x | 0x20) - 'a') > 'z' - 'a'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace base
+}  // namespace myMuduo
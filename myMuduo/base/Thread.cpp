@@ -37,6 +37,8 @@ void Thread::start()
     threadPtr_ = std::unique_ptr<std::thread>(new std::thread([&]() {
         //获取真正的线程ID  而不是Thread的线程ID
         tid_ = CurrentThread::tid();
+        CurrentThread::t_threadName = name_.c_str();
+        CurrentThread::setName(name_.c_str());
         sem_post(&sem);
         func_();
     }));
@@ -0,0 +1,454 @@
+#include "myMuduo/base/ThreadPool.h"
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace base {
+
+const size_t ThreadPool::kDefaultMaxQueueSize;
+const int ThreadPool::kIdleRetries;
+const int Strand::kMaxBatch;
+
+namespace {
+
+//当前线程所属的线程池和在其中的下标 不是工作线程时为nullptr
+thread_local const ThreadPool* t_pool = nullptr;
+thread_local size_t t_workerIndex = 0;
+
+int64_t nowNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+template <typename T>
+void updateMax(std::atomic<T>& maxValue, T value)
+{
+    T current = maxValue.load(std::memory_order_relaxed);
+    while (value > current && !maxValue.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(const std::string& name)
+    : name_(name)
+    , maxQueueSize_(kDefaultMaxQueueSize)
+    , nextWorker_(0)
+    , running_(false)
+    , reserved_(0)
+    , sleepers_(0)
+    , fullWaiters_(0)
+    , queued_(0)
+    , maxQueued_(0)
+    , submitted_(0)
+    , completed_(0)
+    , stolen_(0)
+    , rejected_(0)
+    , totalWaitNanos_(0)
+    , maxWaitNanos_(0)
+    , totalRunNanos_(0)
+    , maxRunNanos_(0)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+    stop();
+    //stop之后才提交的任务没有线程执行了 工作线程都已退出 可以直接取
+    for (auto& worker : workers_)
+    {
+        Item* item = nullptr;
+        while (worker->local.pop(&item) || popInbox(worker.get(), &item))
+        {
+            delete item;
+        }
+    }
+}
+
+void ThreadPool::start(int numThreads)
+{
+    assert(workers_.empty());
+    running_ = true;
+    workers_.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i)
+    {
+        workers_.emplace_back(new Worker);
+    }
+    //线程启动前所有队列都要建好 工作线程一开始就可能去偷别的队列
+    for (int i = 0; i < numThreads; ++i)
+    {
+        size_t index = static_cast<size_t>(i);
+        threads_.emplace_back(new Thread([this, index]() { workerThread(index); }, name_ + std::to_string(i)));
+        threads_.back()->start();
+    }
+}
+
+void ThreadPool::stop()
+{
+    if (!running_.exchange(false))
+    {
+        return;
+    }
+    for (auto& worker : workers_)
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->signaled = true;
+        worker->cond.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(fullMutex_);
+        notFull_.notify_all();
+    }
+    for (auto& thread : threads_)
+    {
+        thread->join();
+    }
+}
+
+void ThreadPool::submit(Task task)
+{
+    enqueue(task, true);
+}
+
+bool ThreadPool::trySubmit(Task task)
+{
+    return enqueue(task, false);
+}
+
+bool ThreadPool::inWorkerThread() const
+{
+    return t_pool == this;
+}
+
+bool ThreadPool::enqueue(Task& task, bool block)
+{
+    if (workers_.empty())
+    {
+        task();
+        return true;
+    }
+
+    //stop之后工作线程还在清空队列 它们提交的后续任务(比如Strand)仍然要接收
+    bool fromWorker = inWorkerThread();
+    if (fromWorker)
+    {
+        reserved_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        if (!running_)
+        {
+            spdlog::warn("ThreadPool {} submit after stop, task dropped", name_);
+            return false;
+        }
+        if (!reserve(block))
+        {
+            return false;
+        }
+    }
+
+    Item* item = new Item{std::move(task), nowNanos()};
+    size_t index;
+    if (fromWorker)
+    {
+        index = t_workerIndex;
+        workers_[index]->local.push(item);
+    }
+    else
+    {
+        index = nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+        Worker* worker = workers_[index].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->inbox.push_back(item);
+        worker->inboxSize.store(worker->inbox.size(), std::memory_order_relaxed);
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+
+    //任务放进队列之后再计数 和park中先登记休眠再检查queued_配对 两边至少有一边看到对方
+    updateMax(maxQueued_, queued_.fetch_add(1, std::memory_order_seq_cst) + 1);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0)
+    {
+        wakeWorker(index);
+    }
+    return true;
+}
+
+//占一个名额 队列满时block为true就等待 否则返回false
+bool ThreadPool::reserve(bool block)
+{
+    if (maxQueueSize_ == 0)
+    {
+        reserved_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t reserved = reserved_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        if (reserved < maxQueueSize_)
+        {
+            if (reserved_.compare_exchange_weak(reserved, reserved + 1, std::memory_order_relaxed))
+            {
+                return true;
+            }
+            continue;
+        }
+        if (!block)
+        {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(fullMutex_);
+            fullWaiters_.fetch_add(1, std::memory_order_seq_cst);
+            notFull_.wait(lock, [this]() {
+                return reserved_.load(std::memory_order_seq_cst) < maxQueueSize_ || !running_;
+            });
+            fullWaiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (!running_)
+        {
+            spdlog::warn("ThreadPool {} stopped while waiting for queue space, task dropped", name_);
+            return false;
+        }
+        reserved = reserved_.load(std::memory_order_relaxed);
+    }
+}
+
+//任务执行完归还名额 只有队列满过才需要加锁通知
+void ThreadPool::release()
+{
+    reserved_.fetch_sub(1, std::memory_order_seq_cst);
+    if (fullWaiters_.load(std::memory_order_seq_cst) > 0)
+    {
+        std::lock_guard<std::mutex> lock(fullMutex_);
+        notFull_.notify_one();
+    }
+}
+
+bool ThreadPool::popInbox(Worker* worker, Item** item)
+{
+    if (worker->inboxSize.load(std::memory_order_relaxed) == 0)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    if (worker->inbox.empty())
+    {
+        return false;
+    }
+    *item = worker->inbox.front();
+    worker->inbox.pop_front();
+    worker->inboxSize.store(worker->inbox.size(), std::memory_order_relaxed);
+    return true;
+}
+
+//先取自己的inbox 外部提交的任务不会被自己不断重新提交的任务(比如Strand)饿死
+//再取自己提交的任务 最后从其他线程偷
+bool ThreadPool::takeTask(size_t index, Item** item)
+{
+    Worker* self = workers_[index].get();
+    bool found = popInbox(self, item) || self->local.pop(item);
+
+    size_t n = workers_.size();
+    for (size_t i = 1; i < n && !found; ++i)
+    {
+        Worker* victim = workers_[(index + i) % n].get();
+        if (victim->local.steal(item) || popInbox(victim, item))
+        {
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+            found = true;
+        }
+    }
+    if (found)
+    {
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return found;
+}
+
+//优先唤醒任务所在的线程 它没有休眠时唤醒任意一个休眠的线程来偷
+void ThreadPool::wakeWorker(size_t preferred)
+{
+    size_t n = workers_.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        Worker* worker = workers_[(preferred + i) % n].get();
+        if (!worker->sleeping.load(std::memory_order_seq_cst))
+        {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        //已经被别的提交唤醒了 换下一个
+        if (worker->sleeping.load(std::memory_order_relaxed) && !worker->signaled)
+        {
+            worker->signaled = true;
+            worker->cond.notify_one();
+            return;
+        }
+    }
+}
+
+//休眠到被唤醒 没有任务并且已经stop时返回false
+bool ThreadPool::park(size_t index)
+{
+    Worker* worker = workers_[index].get();
+    std::unique_lock<std::mutex> lock(worker->mutex);
+    //先登记休眠再检查queued_ 和enqueue的顺序相反 不会漏掉唤醒
+    worker->sleeping.store(true, std::memory_order_seq_cst);
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+
+    bool alive = true;
+    if (queued_.load(std::memory_order_seq_cst) == 0)
+    {
+        if (!running_)
+        {
+            alive = false;
+        }
+        else
+        {
+            worker->cond.wait(lock, [worker]() { return worker->signaled; });
+        }
+    }
+    worker->signaled = false;
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    worker->sleeping.store(false, std::memory_order_relaxed);
+    return alive;
+}
+
+void ThreadPool::workerThread(size_t index)
+{
+    t_pool = this;
+    t_workerIndex = index;
+
+    //任务可能正被别的线程取走 或者steal和别人竞争失败 重试几轮还没有就休眠
+    int idle = 0;
+    while (true)
+    {
+        Item* item = nullptr;
+        if (takeTask(index, &item))
+        {
+            runTask(item);
+            release();
+            idle = 0;
+        }
+        else if (++idle < kIdleRetries)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            idle = 0;
+            if (!park(index))
+            {
+                break;
+            }
+        }
+    }
+
+    t_pool = nullptr;
+}
+
+void ThreadPool::runTask(Item* item)
+{
+    int64_t start = nowNanos();
+    int64_t wait = start - item->enqueueNanos;
+    totalWaitNanos_.fetch_add(wait, std::memory_order_relaxed);
+    updateMax(maxWaitNanos_, wait);
+
+    item->task();
+    delete item;
+
+    int64_t run = nowNanos() - start;
+    totalRunNanos_.fetch_add(run, std::memory_order_relaxed);
+    updateMax(maxRunNanos_, run);
+    completed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+ThreadPool::Stats ThreadPool::stats() const
+{
+    Stats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.completed = completed_.load(std::memory_order_relaxed);
+    stats.stolen = stolen_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.queueDepth = queued_.load(std::memory_order_relaxed);
+    stats.maxQueueDepth = maxQueued_.load(std::memory_order_relaxed);
+    int64_t completed = static_cast<int64_t>(stats.completed);
+    stats.avgWaitMicros = completed > 0 ? totalWaitNanos_.load(std::memory_order_relaxed) / completed / 1000 : 0;
+    stats.maxWaitMicros = maxWaitNanos_.load(std::memory_order_relaxed) / 1000;
+    stats.avgRunMicros = completed > 0 ? totalRunNanos_.load(std::memory_order_relaxed) / completed / 1000 : 0;
+    stats.maxRunMicros = maxRunNanos_.load(std::memory_order_relaxed) / 1000;
+    return stats;
+}
+
+Strand::Strand(ThreadPool* pool)
+    : pool_(pool)
+    , scheduled_(false)
+{
+}
+
+void Strand::post(ThreadPool::Task task)
+{
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+        if (!scheduled_)
+        {
+            scheduled_ = true;
+            schedule = true;
+        }
+    }
+    //同一时刻最多只有一个run()在线程池里 所以任务不会并发执行
+    if (schedule)
+    {
+        std::shared_ptr<Strand> self(shared_from_this());
+        pool_->submit([self]() { self->run(); });
+    }
+}
+
+size_t Strand::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+void Strand::run()
+{
+    for (int i = 0; i < kMaxBatch; ++i)
+    {
+        ThreadPool::Task task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tasks_.empty())
+            {
+                scheduled_ = false;
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_.empty())
+        {
+            scheduled_ = false;
+            return;
+        }
+    }
+    std::shared_ptr<Strand> self(shared_from_this());
+    pool_->submit([self]() { self->run(); });
+}
+
+}  // namespace base
+}  // namespace myMuduo
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "myMuduo/base/Thread.h"
+#include "myMuduo/base/WorkStealingDeque.h"
+#include "myMuduo/base/noncopyable.h"
+
+namespace myMuduo {
+namespace base {
+
+//计算线程池 把耗时的处理从IO线程挪出来
+//外部提交轮流放进各个工作线程的inbox 工作线程自己提交的任务放进自己的无锁双端队列
+//自己的任务取完了就去偷别人的 整个池子的排队任务数有上限
+//每个工作线程单独休眠和唤醒 提交时只在有线程休眠时才去唤醒 计数都是原子变量 不经过全局的锁
+class ThreadPool : noncopyable
+{
+public:
+    using Task = std::function<void()>;
+
+    struct Stats
+    {
+        uint64_t submitted;
+        uint64_t completed;
+        uint64_t stolen;     //从别的工作线程队列偷来执行的任务数
+        uint64_t rejected;   //trySubmit因为队列满失败的次数
+        size_t queueDepth;   //还没开始执行的任务数
+        size_t maxQueueDepth;
+        int64_t avgWaitMicros;  //从提交到开始执行
+        int64_t maxWaitMicros;
+        int64_t avgRunMicros;
+        int64_t maxRunMicros;
+    };
+
+    static const size_t kDefaultMaxQueueSize = 65536;
+
+    explicit ThreadPool(const std::string& name = std::string("ThreadPool"));
+    ~ThreadPool();
+
+    //start之前调用 0表示不限
+    void setMaxQueueSize(size_t maxSize) { maxQueueSize_ = maxSize; }
+
+    //numThreads为0时submit直接在调用线程执行
+    void start(int numThreads);
+    //停止接收新任务 已经排队的任务执行完后工作线程退出
+    void stop();
+
+    //队列满时阻塞 工作线程中提交不受上限限制 避免所有工作线程互相等待
+    void submit(Task task);
+    //队列满时返回false
+    bool trySubmit(Task task);
+
+    size_t queueDepth() const { return queued_.load(std::memory_order_relaxed); }
+    size_t numThreads() const { return workers_.size(); }
+    const std::string& name() const { return name_; }
+    Stats stats() const;
+
+    //当前线程是不是这个池子的工作线程
+    bool inWorkerThread() const;
+
+private:
+    struct Item
+    {
+        Task task;
+        int64_t enqueueNanos;
+    };
+
+    struct Worker
+    {
+        Worker()
+            : inboxSize(0)
+            , sleeping(false)
+            , signaled(false)
+        {
+        }
+
+        WorkStealingDeque<Item*> local;  //自己提交的任务 只有自己push/pop 其他线程steal
+        std::mutex mutex;                //保护inbox和signaled
+        std::deque<Item*> inbox;         //外部线程提交的任务 按提交顺序执行
+        std::atomic<size_t> inboxSize;   //不加锁判断inbox是否为空
+        std::condition_variable cond;
+        std::atomic<bool> sleeping;
+        bool signaled;
+    };
+
+    //空闲时先重试这么多轮再休眠
+    static const int kIdleRetries = 16;
+
+    bool enqueue(Task& task, bool block);
+    bool reserve(bool block);
+    void release();
+    bool takeTask(size_t index, Item** item);
+    static bool popInbox(Worker* worker, Item** item);
+    void wakeWorker(size_t preferred);
+    bool park(size_t index);
+    void workerThread(size_t index);
+    void runTask(Item* item);
+
+    std::string name_;
+    size_t maxQueueSize_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::unique_ptr<Thread>> threads_;
+    std::atomic<size_t> nextWorker_;
+
+    std::atomic<bool> running_;
+    std::atomic<size_t> reserved_;  //占用的名额 入队时加 执行完减
+    std::atomic<int> sleepers_;     //正在休眠或准备休眠的工作线程数
+    //只在队列满时使用 submit等待名额
+    std::mutex fullMutex_;
+    std::condition_variable notFull_;
+    std::atomic<int> fullWaiters_;
+
+    std::atomic<size_t> queued_;  //放进队列还没被取走的任务数
+    std::atomic<size_t> maxQueued_;
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> completed_;
+    std::atomic<uint64_t> stolen_;
+    std::atomic<uint64_t> rejected_;
+    std::atomic<int64_t> totalWaitNanos_;
+    std::atomic<int64_t> maxWaitNanos_;
+    std::atomic<int64_t> totalRunNanos_;
+    std::atomic<int64_t> maxRunNanos_;
+};
+
+//串行执行器 同一个Strand上的任务按提交顺序在线程池中逐个执行 不同Strand之间并行
+//每条连接一个Strand 就能保证同一连接的请求按顺序处理
+class Strand : noncopyable, public std::enable_shared_from_this<Strand>
+{
+public:
+    explicit Strand(ThreadPool* pool);
+
+    //任意线程调用
+    void post(ThreadPool::Task task);
+
+    //还没执行完的任务数
+    size_t pending() const;
+
+private:
+    //一次最多连续执行的任务数 之后重新排队 不让一个Strand长期占着工作线程
+    static const int kMaxBatch = 16;
+
+    void run();
+
+    ThreadPool* pool_;
+    mutable std::mutex mutex_;
+    std::deque<ThreadPool::Task> tasks_;
+    bool scheduled_;
+};
+
+}  // namespace base
+}  // namespace myMuduo
@@ -5,6 +5,7 @@
 #include "TimerQueue.h"
 #include "cassert"
 #include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/LoopMetrics.h"
 #include "spdlog/spdlog.h"
 namespace myMuduo {
 namespace base {
@@ -61,15 +62,18 @@ void TimerQueue::addTimerInLoop(Timer* timer)
 void TimerQueue::cancelInLoop(TimerId timerId)
 {
     loop_->assertInLoopThread();
+    assert(timers_.size() == activeTimers_.size());
 
-    for (auto it = timers_.begin(); it != timers_.end(); ++it)
+    ActiveTimer timer(timerId.getTimer(), timerId.getSequence());
+    auto it = activeTimers_.find(timer);
+    if (it != activeTimers_.end())
     {
-        if (it->second->sequence() == timerId.getSequence())
-        {
-            delete it->second;
-            timers_.erase(it);
-            return;
-        }
+        size_t n = timers_.erase(Entry(it->first->expiration(), it->first));
+        assert(n == 1);
+        (void)n;
+        delete it->first;
+        activeTimers_.erase(it);
+        return;
     }
 
     //如果该定时器已经过期或者不存在的 放到正在取消的定时器列表中
@@ -91,6 +95,8 @@ void TimerQueue::handleRead()
     }
 
     std::vector<Entry> expired = getExpired(now);
+    loop_->metrics().add(net::LoopMetrics::kTimers, expired.size());
+    loop_->metrics().setActivity(net::LoopMetrics::kInTimer, timerfd_);
     callingExpiredTimers_ = true;
     cancelingTimers_.clear();
     for (auto it = expired.begin(); it != expired.end(); ++it)
@@ -109,6 +115,10 @@ std::vector<TimerQueue::Entry> TimerQueue::getExpired(Timestamp now)
     auto it = timers_.upper_bound(sentry);
     std::copy(timers_.begin(), it, back_inserter(expired));
     timers_.erase(timers_.begin(), it);
+    for (const Entry& entry : expired)
+    {
+        activeTimers_.erase(ActiveTimer(entry.second, entry.second->sequence()));
+    }
     return expired;
 }
 
@@ -148,6 +158,10 @@ bool TimerQueue::insert(Timer* timer)
 
     auto res = timers_.insert(Entry(when, timer));
     assert(res.second);
+    auto activeRes = activeTimers_.insert(ActiveTimer(timer, timer->sequence()));
+    assert(activeRes.second);
+    (void)res;
+    (void)activeRes;
 
     return earliestChanged;
 }
@@ -30,6 +30,8 @@ public:
 private:
     using Entry = std::pair<Timestamp, Timer*>;
     using TimerList = std::set<Entry>;
+    using ActiveTimer = std::pair<Timer*, int64_t>;
+    using ActiveTimerSet = std::set<ActiveTimer>;
 
     void addTimerInLoop(Timer* timer);
     void cancelInLoop(TimerId timerId);
@@ -47,6 +49,8 @@ private:
 
     //还没到期的定时器 到期的定时器会被移除
     TimerList timers_;
+    //和timers_保存同样的定时器 按(Timer*, sequence)排序 取消时不用遍历timers_
+    ActiveTimerSet activeTimers_;
 
     //正在取消的定时器
     std::set<Timer*> cancelingTimers_;
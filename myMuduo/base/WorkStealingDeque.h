@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "myMuduo/base/noncopyable.h"
+
+namespace myMuduo {
+namespace base {
+
+//Chase-Lev无锁双端队列
+//只有拥有者线程调用push/pop 在底部LIFO操作 其他线程调用steal从顶部取 只在抢最后一个元素时才需要CAS
+//T必须是可以放进std::atomic的简单类型 一般是指针
+//扩容后旧数组可能还在被steal读 留到析构时才释放
+template <typename T>
+class WorkStealingDeque : noncopyable
+{
+public:
+    explicit WorkStealingDeque(int64_t capacity = 256)
+        : top_(0)
+        , bottom_(0)
+    {
+        int64_t rounded = 1;
+        while (rounded < capacity)
+        {
+            rounded <<= 1;
+        }
+        arrays_.emplace_back(new Array(rounded));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    //拥有者线程
+    void push(T item)
+    {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+        if (b - t > array->mask)
+        {
+            array = grow(array, t, b);
+        }
+        array->put(b, item);
+        //release 让steal看到bottom_时也能看到放进去的元素
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    //拥有者线程
+    bool pop(T* item)
+    {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        //先减bottom_再读top_ 这两步之间必须是顺序一致的 否则会和steal拿到同一个元素
+        bottom_.store(b, std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_seq_cst);
+        if (t > b)
+        {
+            //已经空了
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        *item = array->get(b);
+        if (t == b)
+        {
+            //最后一个元素 和steal竞争
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    //任意线程 失败可能是空了也可能是和别人竞争输了
+    bool steal(T* item)
+    {
+        int64_t t = top_.load(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_seq_cst);
+        if (t >= b)
+        {
+            return false;
+        }
+
+        Array* array = array_.load(std::memory_order_acquire);
+        T value = array->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return false;
+        }
+        *item = value;
+        return true;
+    }
+
+    //近似值 只用于统计和负载判断
+    size_t size() const
+    {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    struct Array
+    {
+        explicit Array(int64_t capacity)
+            : mask(capacity - 1)
+            , slots(new std::atomic<T>[capacity])
+        {
+        }
+
+        T get(int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+        void put(int64_t index, T item) { slots[index & mask].store(item, std::memory_order_relaxed); }
+
+        const int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    //容量翻倍 [t, b)之间的元素按原下标复制
+    Array* grow(Array* old, int64_t t, int64_t b)
+    {
+        arrays_.emplace_back(new Array((old->mask + 1) * 2));
+        Array* array = arrays_.back().get();
+        for (int64_t i = t; i < b; ++i)
+        {
+            array->put(i, old->get(i));
+        }
+        array_.store(array, std::memory_order_release);
+        return array;
+    }
+
+    std::atomic<int64_t> top_;
+    std::atomic<int64_t> bottom_;
+    std::atomic<Array*> array_;
+    //所有分配过的数组 只有拥有者线程修改
+    std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+}  // namespace base
+}  // namespace myMuduo
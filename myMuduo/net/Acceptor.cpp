@@ -2,22 +2,12 @@
 #include <unistd.h>
 #include "myMuduo/net/EventLoop.h"
 #include "myMuduo/net/InetAddress.h"
+#include "myMuduo/base/Logging.h"
 #include "spdlog/spdlog.h"
 
 namespace myMuduo {
 namespace net {
 
-int createNonblockingOrDie(sa_family_t family)
-{
-    int sockfd = socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
-    if (sockfd < 0)
-    {
-        spdlog::critical("createNonblockingOrDie error: {}", strerror(errno));
-        abort();
-    }
-    return sockfd;
-}
-
 Acceptor::Acceptor(EventLoop *loop, const InetAddress &listenAddr, bool reuseport)
     : loop_(loop)
     , acceptSocket_(createNonblockingOrDie(listenAddr.family()))
@@ -66,22 +56,22 @@ void Acceptor::handleRead(Timestamp receiveTime)
     {
         if (newConnectionCallback_)
         {
-            spdlog::debug("New connection accepted: fd={}, peer address={} Time={}", connfd,
-                          peerAddr.toIpPort(), receiveTime.toString());
+            MYMUDUO_LOG_DEBUG("New connection accepted: fd={}, peer address={} Time={}", connfd,
+                              peerAddr.toIpPort(), receiveTime.toString());
             newConnectionCallback_(connfd, peerAddr);
         }
         else
         {
-            spdlog::warn("New connection callback is not set, closing connection fd: {}", connfd);
+            MYMUDUO_LOG_WARN("New connection callback is not set, closing connection fd: {}", connfd);
             close(connfd);
         }
     }
     else
     {
-        spdlog::error("Accept error: {}", strerror(errno));
+        MYMUDUO_LOG_ERROR("Accept error: {}", strerror(errno));
         if (errno == EMFILE)
         {
-            spdlog::warn("socket fd limit reached, consider increasing the limit");
+            MYMUDUO_LOG_WARN("socket fd limit reached, consider increasing the limit");
         }
     }
 }
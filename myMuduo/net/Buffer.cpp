@@ -2,6 +2,7 @@
 #include <sys/uio.h>
 #include <algorithm>
 #include <cassert>
+#include "myMuduo/base/ByteSearch.h"
 
 namespace myMuduo {
 namespace net {
@@ -11,41 +12,11 @@ const char Buffer::kCRLF[] = "\r\n";
 Buffer::Buffer(int initialSize)
     : buffer_(kCheapPrepend + initialSize)
     , headIndex_(kCheapPrepend)
-    , tailIndex_(kCheapPrepend) {};
+    , tailIndex_(kCheapPrepend)
+    , crlfScanIndex_(0) {};
 
 Buffer::~Buffer() = default;
 
-size_t Buffer::readableBytesLength() const { return tailIndex_ - headIndex_; }
-
-size_t Buffer::writableBytesLength() const { return buffer_.size() - tailIndex_; }
-
-size_t Buffer::prependableBytesLength() const { return headIndex_; }
-
-//返回数据的起始位置
-const char* Buffer::peek() { return begin() + headIndex_; }
-
-//标记缓冲区头部的一部分数据为“已消耗”，使其不再可读
-//这通常在数据被应用程序完整处理后调用。
-void Buffer::retrieve(size_t len)
-{
-    assert(len <= readableBytesLength());
-    if (len < readableBytesLength())
-    {
-        headIndex_ += len;
-    }
-    else
-    {
-        //数据已经被读完了 重置缓冲区的数据索引位置
-        retrieveAll();
-    }
-}
-
-void Buffer::retrieveAll()
-{
-    headIndex_ = kCheapPrepend;
-    tailIndex_ = kCheapPrepend;
-}
-
 std::string Buffer::retrieveAllAsString() { return retrieveAsString(readableBytesLength()); }
 
 std::string Buffer::retrieveAsString(size_t len)
@@ -56,49 +27,61 @@ std::string Buffer::retrieveAsString(size_t len)
     return result;
 }
 
-void Buffer::ensureWritableBytes(size_t len)
-{
-    if (writableBytesLength() < len)
-    {
-        //如果可写空间不足，扩展缓冲区
-        makeSpace(len);
-    }
-    assert(writableBytesLength() >= len);
-}
-
-void Buffer::hasWritten(size_t len)
-{
-    assert(len <= writableBytesLength());
-    tailIndex_ += len;
-}
-
-void Buffer::append(const char* data, size_t len)
-{
-    ensureWritableBytes(len);
-    std::copy(data, data + len, beginWrite());
-    hasWritten(len);
-}
-
 void Buffer::prepend(const char* data, size_t len)
 {
     assert(len <= prependableBytesLength());
     headIndex_ -= len;
     const char* d = static_cast<const char*>(data);
     std::copy(d, d + len, begin() + headIndex_);
+    //新数据在已扫描区域前面 扫描记录失效
+    crlfScanIndex_ = 0;
 }
 
 const char* Buffer::findCRLF(const char* start)
 {
     assert(start >= peek());
     assert(start <= beginWrite());
-    const void* crlf = std::search(start, static_cast<const char*>(beginWrite()), kCRLF, kCRLF + 2);
-    return crlf == beginWrite() ? nullptr : static_cast<const char*>(crlf);
+    //retrieve之后扫描记录可能落在peek()之前
+    if (crlfScanIndex_ < headIndex_)
+    {
+        crlfScanIndex_ = headIndex_;
+    }
+    const char* scanned = begin() + crlfScanIndex_;
+    //start之前的部分不一定扫描过 只有从扫描记录之前开始找时才能跳过已扫描部分并更新记录
+    if (start > scanned)
+    {
+        return base::findCRLF(start, beginWrite());
+    }
+
+    const char* crlf = base::findCRLF(scanned, beginWrite());
+    if (crlf != nullptr)
+    {
+        crlfScanIndex_ = crlf - begin();
+    }
+    else if (tailIndex_ > headIndex_)
+    {
+        //最后一个字节可能是'\r' 下次要从它开始找
+        crlfScanIndex_ = std::max(static_cast<size_t>(scanned - begin()), tailIndex_ - 1);
+    }
+    return crlf;
+}
+
+const char* Buffer::findCRLF() { return findCRLF(peek()); }
+
+const char* Buffer::findEOL(const char* start) const
+{
+    assert(start >= peek());
+    assert(start <= beginWrite());
+    return base::findEOL(start, beginWrite());
 }
 
-const char* Buffer::findCRLF()
+const char* Buffer::findEOL() const { return findEOL(peek()); }
+
+const char* Buffer::findByte(char c) const { return base::findByte(peek(), beginWrite(), c); }
+
+const char* Buffer::findDelimiter(const char* delim, size_t len) const
 {
-    const char* start = peek();
-    return findCRLF(start);
+    return base::findDelimiter(peek(), beginWrite(), delim, len);
 }
 
 void Buffer::swap(Buffer& rhs)
@@ -106,6 +89,7 @@ void Buffer::swap(Buffer& rhs)
     buffer_.swap(rhs.buffer_);
     std::swap(headIndex_, rhs.headIndex_);
     std::swap(tailIndex_, rhs.tailIndex_);
+    std::swap(crlfScanIndex_, rhs.crlfScanIndex_);
 }
 
 //从文件描述符中读取数据
@@ -141,8 +125,6 @@ ssize_t Buffer::readFd(int fd, int* savedErrno)
     return n;
 }
 
-char* Buffer::begin() { return buffer_.data(); }
-char* Buffer::beginWrite() { return begin() + tailIndex_; }
 void Buffer::makeSpace(size_t len)
 {
     //实际可用空间 = 可写空间 + 预留空间
@@ -153,6 +135,8 @@ void Buffer::makeSpace(size_t len)
     {
         size_t dataSize = readableBytesLength();
         std::copy(begin() + headIndex_, begin() + tailIndex_, begin() + kCheapPrepend);
+        //扫描记录跟着数据一起前移
+        crlfScanIndex_ = crlfScanIndex_ > headIndex_ ? crlfScanIndex_ - (headIndex_ - kCheapPrepend) : 0;
         headIndex_ = kCheapPrepend;
         tailIndex_ = headIndex_ + dataSize;
         assert(dataSize == readableBytesLength());
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <stdint.h>
+#include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <string>
+#include <type_traits>
 #include <vector>
+#include "myMuduo/net/Endian.h"
 
 namespace myMuduo {
 namespace net {
@@ -24,6 +29,7 @@ public:
     //由扩容和buffer构造方式来保证  头少于8字节的直接用prepend就可以写入  超过8字节的需要用sendMyComplexPacket这个例子里的方式来构造buffer
     static const size_t kCheapPrepend = 8;    // 初始预留空间为8字节
     static const size_t kInitialSize = 1024;  // 初始大小为1024字节
+    static const size_t kMaxVarint64Length = 10;
 
     explicit Buffer(int initialSize = kInitialSize);
 
@@ -31,47 +37,225 @@ public:
 
     Buffer(const Buffer&) = delete;  // 禁止拷贝构造
 
-    size_t readableBytesLength() const;
-    size_t writableBytesLength() const;
-
-    size_t prependableBytesLength() const;
-
-    const char* peek();
-
-    char* beginWrite();
-
-    void retrieve(size_t len);
-
-    void retrieveAll();
+    //编解码每处理一个字段都会调用下面这些函数 定义在头文件中 不开LTO也能内联
+    size_t readableBytesLength() const { return tailIndex_ - headIndex_; }
+    size_t writableBytesLength() const { return buffer_.size() - tailIndex_; }
+
+    size_t prependableBytesLength() const { return headIndex_; }
+
+    //返回数据的起始位置 解析函数可以只拿const Buffer&
+    const char* peek() const { return begin() + headIndex_; }
+
+    //可读数据的可写视图 用于原地修改(比如WebSocket去掩码) 会清掉findCRLF()的扫描记录
+    char* beginRead()
+    {
+        //调用者可能写入"\r\n" 扫描记录不再可信
+        crlfScanIndex_ = 0;
+        return begin() + headIndex_;
+    }
+
+    char* beginWrite() { return begin() + tailIndex_; }
+    const char* beginWrite() const { return begin() + tailIndex_; }
+
+    //标记缓冲区头部的一部分数据为“已消耗”，使其不再可读
+    //这通常在数据被应用程序完整处理后调用。
+    void retrieve(size_t len)
+    {
+        assert(len <= readableBytesLength());
+        if (len < readableBytesLength())
+        {
+            headIndex_ += len;
+        }
+        else
+        {
+            //数据已经被读完了 重置缓冲区的数据索引位置
+            retrieveAll();
+        }
+    }
+
+    void retrieveAll()
+    {
+        headIndex_ = kCheapPrepend;
+        tailIndex_ = kCheapPrepend;
+        crlfScanIndex_ = 0;
+    }
 
     std::string retrieveAllAsString();
 
     std::string retrieveAsString(size_t len);
 
-    void ensureWritableBytes(size_t len);
-
-    void hasWritten(size_t len);
-
-    void append(const char* data, size_t len);
+    void ensureWritableBytes(size_t len)
+    {
+        if (writableBytesLength() < len)
+        {
+            //如果可写空间不足，扩展缓冲区
+            makeSpace(len);
+        }
+        assert(writableBytesLength() >= len);
+    }
+
+    void hasWritten(size_t len)
+    {
+        assert(len <= writableBytesLength());
+        tailIndex_ += len;
+    }
+
+    void append(const char* data, size_t len)
+    {
+        ensureWritableBytes(len);
+        ::memcpy(beginWrite(), data, len);
+        hasWritten(len);
+    }
 
     void prepend(const char* data, size_t len);
 
+    //整数按网络字节序读写 用memcpy搬运 不要求地址对齐
+    template <typename T>
+    void appendInt(T x)
+    {
+        static_assert(std::is_integral<T>::value, "appendInt needs an integer type");
+        typedef typename std::make_unsigned<T>::type U;
+        U be = sockets::ByteOrder<sizeof(T)>::toNetwork(static_cast<U>(x));
+        append(reinterpret_cast<const char*>(&be), sizeof be);
+    }
+
+    template <typename T>
+    void prependInt(T x)
+    {
+        static_assert(std::is_integral<T>::value, "prependInt needs an integer type");
+        typedef typename std::make_unsigned<T>::type U;
+        U be = sockets::ByteOrder<sizeof(T)>::toNetwork(static_cast<U>(x));
+        prepend(reinterpret_cast<const char*>(&be), sizeof be);
+    }
+
+    //调用前要保证readableBytesLength() >= sizeof(T)
+    template <typename T>
+    T peekInt() const
+    {
+        static_assert(std::is_integral<T>::value, "peekInt needs an integer type");
+        assert(readableBytesLength() >= sizeof(T));
+        typedef typename std::make_unsigned<T>::type U;
+        U be;
+        ::memcpy(&be, peek(), sizeof be);
+        return static_cast<T>(sockets::ByteOrder<sizeof(T)>::toHost(be));
+    }
+
+    template <typename T>
+    T readInt()
+    {
+        T x = peekInt<T>();
+        retrieve(sizeof(T));
+        return x;
+    }
+
+    void appendInt64(int64_t x) { appendInt(x); }
+    void appendInt32(int32_t x) { appendInt(x); }
+    void appendInt16(int16_t x) { appendInt(x); }
+    void appendInt8(int8_t x) { appendInt(x); }
+
+    void prependInt64(int64_t x) { prependInt(x); }
+    void prependInt32(int32_t x) { prependInt(x); }
+    void prependInt16(int16_t x) { prependInt(x); }
+    void prependInt8(int8_t x) { prependInt(x); }
+
+    int64_t peekInt64() const { return peekInt<int64_t>(); }
+    int32_t peekInt32() const { return peekInt<int32_t>(); }
+    int16_t peekInt16() const { return peekInt<int16_t>(); }
+    int8_t peekInt8() const { return peekInt<int8_t>(); }
+
+    int64_t readInt64() { return readInt<int64_t>(); }
+    int32_t readInt32() { return readInt<int32_t>(); }
+    int16_t readInt16() { return readInt<int16_t>(); }
+    int8_t readInt8() { return readInt<int8_t>(); }
+
+    //varint: 每字节低7位存数据 最高位为1表示后面还有字节 uint64最多占10字节
+    void appendVarint64(uint64_t x)
+    {
+        ensureWritableBytes(kMaxVarint64Length);
+        char* p = beginWrite();
+        size_t n = 0;
+        while (x >= 0x80)
+        {
+            p[n++] = static_cast<char>(x | 0x80);
+            x >>= 7;
+        }
+        p[n++] = static_cast<char>(x);
+        hasWritten(n);
+    }
+
+    //返回varint占用的字节数 数据还没收全返回0 超过10字节还没结束说明数据非法 返回-1
+    int peekVarint64(uint64_t* value) const
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(peek());
+        size_t readable = readableBytesLength();
+        uint64_t result = 0;
+        for (size_t i = 0; i < kMaxVarint64Length; ++i)
+        {
+            if (i >= readable) return 0;
+            result |= static_cast<uint64_t>(p[i] & 0x7f) << (7 * i);
+            if ((p[i] & 0x80) == 0)
+            {
+                *value = result;
+                return static_cast<int>(i + 1);
+            }
+        }
+        return -1;
+    }
+
+    int readVarint64(uint64_t* value)
+    {
+        int n = peekVarint64(value);
+        if (n > 0) retrieve(n);
+        return n;
+    }
+
+    //有符号数先做zigzag再按varint编码 返回值含义同peekVarint64
+    void appendZigZag64(int64_t x) { appendVarint64(sockets::encodeZigZag64(x)); }
+
+    int peekZigZag64(int64_t* value) const
+    {
+        uint64_t raw = 0;
+        int n = peekVarint64(&raw);
+        if (n > 0) *value = sockets::decodeZigZag64(raw);
+        return n;
+    }
+
+    int readZigZag64(int64_t* value)
+    {
+        int n = peekZigZag64(value);
+        if (n > 0) retrieve(n);
+        return n;
+    }
+
+    //查找都使用SIMD实现 见base/ByteSearch.h
+    //findCRLF()会记住上次没找到时扫描到的位置 数据分多次到达时不会从peek()重新扫描
     const char* findCRLF(const char* start);
 
     const char* findCRLF();
 
+    const char* findEOL(const char* start) const;
+
+    const char* findEOL() const;
+
+    const char* findByte(char c) const;
+
+    const char* findDelimiter(const char* delim, size_t len) const;
+
     ssize_t readFd(int fd, int* savedErrno);
 
     void swap(Buffer& rhs);
 
 private:
-    char* begin();
+    char* begin() { return buffer_.data(); }
+    const char* begin() const { return buffer_.data(); }
 
     void makeSpace(size_t len);
 
     std::vector<char> buffer_;
     size_t headIndex_;  //数据起始位置
     size_t tailIndex_;  //数据结束位置
+    //[headIndex_, crlfScanIndex_)之间已经确认没有"\r\n" 0表示没有扫描过
+    size_t crlfScanIndex_;
     static const char kCRLF[];
 };
 
@@ -81,6 +265,8 @@ private:
 // Definition of static member
 
 /*
+头部只有几个整数字段时直接用prependInt64/prependInt32即可 不需要像下面这样拷贝结构体
+
 演示如何构造并发送一个复杂头部的数据包
 
 // 假设这是我们的自定义头部结构
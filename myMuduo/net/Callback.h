@@ -23,5 +23,9 @@ using NewConnectionCallback = std::function<void(int sockfd, const InetAddress &
 using EventCallback = std::function<void()>;
 using ReadEventCallback = std::function<void(Timestamp)>;
 
+//未设置回调时的默认行为 定义在TcpConnection.cpp
+void defaultConnectionCallback(const TcpConnectionPtr &conn);
+void defaultMessageCallback(const TcpConnectionPtr &conn, Buffer *buffer, Timestamp receiveTime);
+
 }  // namespace net
 }  // namespace myMuduo
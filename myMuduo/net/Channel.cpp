@@ -2,7 +2,9 @@
 #include <cassert>
 #include <sstream>
 #include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/LoopMetrics.h"
 #include "myMuduo/net/poller/Poller.h"
+#include "myMuduo/base/Logging.h"
 #include "spdlog/spdlog.h"
 
 const int myMuduo::net::Channel::kNoneEvent = 0;
@@ -24,11 +26,11 @@ Channel::Channel(EventLoop *loop, int fd)
 {
     if (fd_ < 0)
     {
-        spdlog::error("Channel::Channel() - fd must be >= 0, but got {}", fd_);
+        MYMUDUO_LOG_ERROR("Channel::Channel() - fd must be >= 0, but got {}", fd_);
     }
     else
     {
-        spdlog::debug("Channel::Channel() fd={}", fd_);
+        MYMUDUO_LOG_DEBUG("Channel::Channel() fd={}", fd_);
     }
 }
 
@@ -81,7 +83,7 @@ void Channel::handleEvent(Timestamp receiveTime)
         else
         {
             // 如果绑定的对象已经过期，则不处理事件
-            spdlog::warn("Channel::handleEvent() - tie_ has expired, fd={}", fd_);
+            MYMUDUO_LOG_WARN("Channel::handleEvent() - tie_ has expired, fd={}", fd_);
         }
     }
     //没有绑定时直接处理 比如eventloop拥有channel eventloop的生命周期比channel长 不需要绑定确认eventloop有没有过期
@@ -94,39 +96,42 @@ void Channel::handleEvent(Timestamp receiveTime)
 void Channel::handleEventWithGuard(Timestamp receiveTime)
 {
     eventHandling_ = true;
-    spdlog::info("Channel::handleEventWithGuard() - fd={}, events={}, revents={}", fd_,
-                 eventsToString(fd_, events_), eventsToString(fd_, revents_));
+    LoopMetrics& metrics = loop_->metrics();
+    MYMUDUO_LOG_TRACE("Channel::handleEventWithGuard() - fd={}, events={}, revents={}", fd_,
+                      eventsToString(fd_, events_), eventsToString(fd_, revents_));
 
     // 连接被挂起 且 没有可读事件
     if ((revents_ & POLLHUP) && !(revents_ & POLLIN))
     {
         if (closeCallback_)
         {
-            spdlog::debug("Channel::handleEventWithGuard() - close event, fd={}", fd_);
+            MYMUDUO_LOG_DEBUG("Channel::handleEventWithGuard() - close event, fd={}", fd_);
+            metrics.setActivity(LoopMetrics::kInClose, fd_);
             closeCallback_();
         }
         else
         {
-            spdlog::warn("Channel::handleEventWithGuard() - POLLHUP without closeCallback, fd={}", fd_);
+            MYMUDUO_LOG_WARN("Channel::handleEventWithGuard() - POLLHUP without closeCallback, fd={}", fd_);
         }
     }
 
     //监听事件无效
     if (revents_ & POLLNVAL)
     {
-        spdlog::error("Channel::handleEventWithGuard() - POLLNVAL, fd={}", fd_);
+        MYMUDUO_LOG_ERROR("Channel::handleEventWithGuard() - POLLNVAL, fd={}", fd_);
     }
 
     if (revents_ & (POLLERR | POLLNVAL))
     {
         if (errorCallback_)
         {
-            spdlog::debug("Channel::handleEventWithGuard() - error event, fd={}", fd_);
+            MYMUDUO_LOG_DEBUG("Channel::handleEventWithGuard() - error event, fd={}", fd_);
+            metrics.setActivity(LoopMetrics::kInError, fd_);
             errorCallback_();
         }
         else
         {
-            spdlog::warn("Channel::handleEventWithGuard() - POLLERR without errorCallback, fd={}", fd_);
+            MYMUDUO_LOG_WARN("Channel::handleEventWithGuard() - POLLERR without errorCallback, fd={}", fd_);
         }
     }
 
@@ -134,12 +139,13 @@ void Channel::handleEventWithGuard(Timestamp receiveTime)
     {
         if (readCallback_)
         {
-            spdlog::debug("Channel::handleEventWithGuard() - read event, fd={}", fd_);
+            MYMUDUO_LOG_DEBUG("Channel::handleEventWithGuard() - read event, fd={}", fd_);
+            metrics.setActivity(LoopMetrics::kInRead, fd_);
             readCallback_(receiveTime);
         }
         else
         {
-            spdlog::warn("Channel::handleEventWithGuard() - POLLIN without readCallback, fd={}", fd_);
+            MYMUDUO_LOG_WARN("Channel::handleEventWithGuard() - POLLIN without readCallback, fd={}", fd_);
         }
     }
 
@@ -147,12 +153,13 @@ void Channel::handleEventWithGuard(Timestamp receiveTime)
     {
         if (writeCallback_)
         {
-            spdlog::debug("Channel::handleEventWithGuard() - write event, fd={}", fd_);
+            MYMUDUO_LOG_DEBUG("Channel::handleEventWithGuard() - write event, fd={}", fd_);
+            metrics.setActivity(LoopMetrics::kInWrite, fd_);
             writeCallback_();
         }
         else
         {
-            spdlog::warn("Channel::handleEventWithGuard() - POLLOUT without writeCallback, fd={}", fd_);
+            MYMUDUO_LOG_WARN("Channel::handleEventWithGuard() - POLLOUT without writeCallback, fd={}", fd_);
         }
     }
 
@@ -0,0 +1,567 @@
+#include "myMuduo/net/ConnectionPool.h"
+#include <cassert>
+#include <future>
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/base/Logging.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+namespace {
+
+//计数器只由所属loop线程写 其他线程只读 不需要原子的读-改-写
+void increase(std::atomic<uint64_t>& counter, int64_t delta = 1)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+double secondsBetween(Timestamp high, Timestamp low)
+{
+    return static_cast<double>(high.microSecondsSinceEpoch() - low.microSecondsSinceEpoch()) /
+           Timestamp::kMicroSecondsPerSecond;
+}
+
+}  // namespace
+
+//一个loop上的连接池 所有成员只在该loop线程中访问 统计计数除外
+class ConnectionPool::LoopPool : noncopyable, public std::enable_shared_from_this<ConnectionPool::LoopPool>
+{
+public:
+    LoopPool(ConnectionPool* owner, EventLoop* loop, int index)
+        : owner_(owner)
+        , loop_(loop)
+        , name_(owner->name() + "-" + std::to_string(index))
+        , nextClientId_(1)
+        , healthCheckStarted_(false)
+    {
+    }
+
+    void acquire(const InetAddress& addr, AcquireCallback cb);
+    void release(const TcpConnectionPtr& conn);
+    void shutdown();
+    void addStatsTo(ConnectionPoolStats* stats) const;
+
+private:
+    struct HostPool;
+
+    struct Entry
+    {
+        std::unique_ptr<TcpClient> client;
+        TcpConnectionPtr conn;  // 连接建立前为空
+        size_t inflight = 0;
+        Timestamp lastUsed;
+        base::TimerId connectTimer;
+        HostPool* host = nullptr;
+    };
+
+    struct HostPool
+    {
+        explicit HostPool(const InetAddress& address)
+            : addr(address)
+        {
+        }
+        InetAddress addr;
+        std::vector<std::unique_ptr<Entry>> entries;
+        std::deque<AcquireCallback> waiters;
+    };
+
+    HostPool* getHost(const InetAddress& addr);
+    Entry* pickEntry(HostPool* host) const;
+    void createEntry(HostPool* host);
+    void removeEntry(Entry* entry);
+    void serveWaiters(HostPool* host);
+    void failWaitersIfHopeless(HostPool* host);
+    void onConnection(Entry* entry, const TcpConnectionPtr& conn);
+    void onDisconnection(const TcpConnectionPtr& conn);
+    void onConnectTimeout(Entry* entry);
+    void startHealthCheck();
+    void healthCheck();
+    void markBusy(Entry* entry);
+    void markIdle(Entry* entry);
+
+    ConnectionPool* owner_;  // shutdown后为nullptr
+    EventLoop* loop_;
+    const std::string name_;
+    int nextClientId_;
+    bool healthCheckStarted_;
+    base::TimerId healthCheckTimer_;
+    std::unordered_map<std::string, std::unique_ptr<HostPool>> hosts_;  // key为ip:port
+    std::unordered_map<std::string, Entry*> entriesByConnName_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> creates_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> connectFailures_{0};
+    std::atomic<uint64_t> waits_{0};
+    std::atomic<uint64_t> rejects_{0};
+    std::atomic<uint64_t> idle_{0};
+    std::atomic<uint64_t> active_{0};
+};
+
+void ConnectionPool::LoopPool::acquire(const InetAddress& addr, AcquireCallback cb)
+{
+    loop_->assertInLoopThread();
+    if (owner_ == nullptr)
+    {
+        cb(TcpConnectionPtr());
+        return;
+    }
+    startHealthCheck();
+
+    HostPool* host = getHost(addr);
+    Entry* entry = pickEntry(host);
+    if (entry != nullptr)
+    {
+        increase(hits_);
+        markBusy(entry);
+        cb(entry->conn);
+        return;
+    }
+
+    const ConnectionPoolOptions& options = owner_->options();
+    if (host->waiters.size() >= options.maxPendingAcquires)
+    {
+        increase(rejects_);
+        cb(TcpConnectionPtr());
+        return;
+    }
+
+    //每个排队的请求最多对应一条正在建立的连接 避免突发请求时一次建出过多连接
+    size_t connecting = 0;
+    for (const auto& e : host->entries)
+    {
+        if (!e->conn)
+        {
+            ++connecting;
+        }
+    }
+    if (host->entries.size() < options.maxConnectionsPerHost && connecting <= host->waiters.size())
+    {
+        createEntry(host);
+    }
+    increase(waits_);
+    host->waiters.push_back(std::move(cb));
+}
+
+void ConnectionPool::LoopPool::release(const TcpConnectionPtr& conn)
+{
+    loop_->assertInLoopThread();
+    auto it = entriesByConnName_.find(conn->getName());
+    //连接已经被回收
+    if (it == entriesByConnName_.end())
+    {
+        return;
+    }
+
+    Entry* entry = it->second;
+    assert(entry->inflight > 0);
+    markIdle(entry);
+    entry->lastUsed = Timestamp::now();
+
+    HostPool* host = entry->host;
+    if (!host->waiters.empty())
+    {
+        serveWaiters(host);
+        return;
+    }
+
+    if (entry->inflight == 0)
+    {
+        size_t idleCount = 0;
+        for (const auto& e : host->entries)
+        {
+            if (e->conn && e->inflight == 0)
+            {
+                ++idleCount;
+            }
+        }
+        if (idleCount > owner_->options().maxIdlePerHost)
+        {
+            removeEntry(entry);
+        }
+    }
+}
+
+void ConnectionPool::LoopPool::shutdown()
+{
+    loop_->assertInLoopThread();
+    if (healthCheckStarted_)
+    {
+        loop_->cancel(healthCheckTimer_);
+    }
+
+    for (auto& item : hosts_)
+    {
+        HostPool* host = item.second.get();
+        while (!host->entries.empty())
+        {
+            removeEntry(host->entries.back().get());
+        }
+        std::deque<AcquireCallback> waiters;
+        waiters.swap(host->waiters);
+        for (auto& cb : waiters)
+        {
+            cb(TcpConnectionPtr());
+        }
+    }
+    hosts_.clear();
+    owner_ = nullptr;
+}
+
+void ConnectionPool::LoopPool::addStatsTo(ConnectionPoolStats* stats) const
+{
+    stats->hits += hits_.load(std::memory_order_relaxed);
+    stats->creates += creates_.load(std::memory_order_relaxed);
+    stats->evictions += evictions_.load(std::memory_order_relaxed);
+    stats->connectFailures += connectFailures_.load(std::memory_order_relaxed);
+    stats->waits += waits_.load(std::memory_order_relaxed);
+    stats->rejects += rejects_.load(std::memory_order_relaxed);
+    stats->idle += idle_.load(std::memory_order_relaxed);
+    stats->active += active_.load(std::memory_order_relaxed);
+}
+
+ConnectionPool::LoopPool::HostPool* ConnectionPool::LoopPool::getHost(const InetAddress& addr)
+{
+    std::string key = addr.toIpPort();
+    auto it = hosts_.find(key);
+    if (it == hosts_.end())
+    {
+        it = hosts_.emplace(key, std::unique_ptr<HostPool>(new HostPool(addr))).first;
+    }
+    return it->second.get();
+}
+
+//优先选择在途请求最少的连接 空闲连接会被优先选中
+ConnectionPool::LoopPool::Entry* ConnectionPool::LoopPool::pickEntry(HostPool* host) const
+{
+    const size_t maxPipelined = owner_->options().maxPipelinedRequests;
+    Entry* best = nullptr;
+    for (const auto& e : host->entries)
+    {
+        if (e->conn && e->conn->connected() && e->inflight < maxPipelined)
+        {
+            if (best == nullptr || e->inflight < best->inflight)
+            {
+                best = e.get();
+                if (best->inflight == 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+void ConnectionPool::LoopPool::createEntry(HostPool* host)
+{
+    std::unique_ptr<Entry> entry(new Entry);
+    Entry* rawEntry = entry.get();
+    std::string clientName = name_ + "-" + std::to_string(nextClientId_++);
+    entry->client.reset(new TcpClient(loop_, host->addr, clientName));
+    entry->host = host;
+
+    std::weak_ptr<LoopPool> weakSelf(shared_from_this());
+    ConnectionCallback userConnectionCallback = owner_->connectionCallback_;
+    //entry只在LoopPool中析构 回调里先确认LoopPool还活着
+    entry->client->setConnectionCallback([weakSelf, rawEntry, userConnectionCallback](const TcpConnectionPtr& conn) {
+        //先让使用者初始化连接上下文 再把连接交给排队的请求
+        if (userConnectionCallback)
+        {
+            userConnectionCallback(conn);
+        }
+        std::shared_ptr<LoopPool> self(weakSelf.lock());
+        if (self)
+        {
+            if (conn->connected())
+            {
+                self->onConnection(rawEntry, conn);
+            }
+            else
+            {
+                self->onDisconnection(conn);
+            }
+        }
+    });
+    if (owner_->messageCallback_)
+    {
+        entry->client->setMessageCallback(owner_->messageCallback_);
+    }
+
+    double timeout = owner_->options().connectTimeoutSeconds;
+    if (timeout > 0)
+    {
+        entry->connectTimer = loop_->runAfter(timeout, [weakSelf, rawEntry]() {
+            std::shared_ptr<LoopPool> self(weakSelf.lock());
+            if (self)
+            {
+                self->onConnectTimeout(rawEntry);
+            }
+        });
+    }
+
+    host->entries.push_back(std::move(entry));
+    increase(creates_);
+    rawEntry->client->connect();
+}
+
+//回收连接 TcpClient不能在它自己的回调里析构 放到本loop的下一轮处理
+void ConnectionPool::LoopPool::removeEntry(Entry* entry)
+{
+    HostPool* host = entry->host;
+    if (entry->conn)
+    {
+        if (entry->inflight > 0)
+        {
+            increase(active_, -1);
+        }
+        else
+        {
+            increase(idle_, -1);
+        }
+        entriesByConnName_.erase(entry->conn->getName());
+        entry->conn->forceClose();
+        entry->conn.reset();
+    }
+    else
+    {
+        loop_->cancel(entry->connectTimer);
+        entry->client->stop();
+    }
+
+    std::shared_ptr<TcpClient> client(entry->client.release());
+    loop_->queueInLoop([client]() mutable { client.reset(); });
+
+    for (auto it = host->entries.begin(); it != host->entries.end(); ++it)
+    {
+        if (it->get() == entry)
+        {
+            host->entries.erase(it);
+            break;
+        }
+    }
+    increase(evictions_);
+}
+
+void ConnectionPool::LoopPool::serveWaiters(HostPool* host)
+{
+    while (!host->waiters.empty())
+    {
+        Entry* entry = pickEntry(host);
+        if (entry == nullptr)
+        {
+            break;
+        }
+        AcquireCallback cb(std::move(host->waiters.front()));
+        host->waiters.pop_front();
+        markBusy(entry);
+        cb(entry->conn);
+    }
+}
+
+//已经没有可用或正在建立的连接 排队的请求不会再被满足
+void ConnectionPool::LoopPool::failWaitersIfHopeless(HostPool* host)
+{
+    if (!host->entries.empty())
+    {
+        return;
+    }
+    std::deque<AcquireCallback> waiters;
+    waiters.swap(host->waiters);
+    for (auto& cb : waiters)
+    {
+        cb(TcpConnectionPtr());
+    }
+}
+
+void ConnectionPool::LoopPool::onConnection(Entry* entry, const TcpConnectionPtr& conn)
+{
+    if (owner_ == nullptr)
+    {
+        return;
+    }
+    loop_->cancel(entry->connectTimer);
+    entry->conn = conn;
+    entry->lastUsed = Timestamp::now();
+    entriesByConnName_[conn->getName()] = entry;
+    increase(idle_);
+    MYMUDUO_LOG_DEBUG("ConnectionPool[{}] - connection {} up", name_, conn->getName());
+    serveWaiters(entry->host);
+}
+
+void ConnectionPool::LoopPool::onDisconnection(const TcpConnectionPtr& conn)
+{
+    if (owner_ == nullptr)
+    {
+        return;
+    }
+    auto it = entriesByConnName_.find(conn->getName());
+    if (it == entriesByConnName_.end())
+    {
+        return;
+    }
+    Entry* entry = it->second;
+    HostPool* host = entry->host;
+    MYMUDUO_LOG_DEBUG("ConnectionPool[{}] - connection {} down", name_, conn->getName());
+    removeEntry(entry);
+
+    //还有请求在排队 补一条连接
+    if (!host->waiters.empty() && host->entries.size() < owner_->options().maxConnectionsPerHost)
+    {
+        createEntry(host);
+    }
+}
+
+void ConnectionPool::LoopPool::onConnectTimeout(Entry* entry)
+{
+    //timer和entry的生命周期一致 entry析构前会取消timer
+    if (entry->conn)
+    {
+        return;
+    }
+    HostPool* host = entry->host;
+    spdlog::warn("ConnectionPool[{}] - connect to {} timeout", name_, host->addr.toIpPort());
+    increase(connectFailures_);
+    removeEntry(entry);
+    failWaitersIfHopeless(host);
+}
+
+void ConnectionPool::LoopPool::startHealthCheck()
+{
+    double interval = owner_->options().healthCheckIntervalSeconds;
+    if (healthCheckStarted_ || interval <= 0)
+    {
+        return;
+    }
+    healthCheckStarted_ = true;
+    std::weak_ptr<LoopPool> weakSelf(shared_from_this());
+    healthCheckTimer_ = loop_->runEvery(interval, [weakSelf]() {
+        std::shared_ptr<LoopPool> self(weakSelf.lock());
+        if (self)
+        {
+            self->healthCheck();
+        }
+    });
+}
+
+//只检查空闲连接 正在使用的连接由使用者负责
+void ConnectionPool::LoopPool::healthCheck()
+{
+    if (owner_ == nullptr)
+    {
+        return;
+    }
+    const double maxIdleSeconds = owner_->options().maxIdleSeconds;
+    const HealthCheckCallback& check = owner_->healthCheckCallback_;
+    Timestamp now = Timestamp::now();
+
+    for (auto& item : hosts_)
+    {
+        HostPool* host = item.second.get();
+        std::vector<Entry*> evicted;
+        for (const auto& e : host->entries)
+        {
+            if (!e->conn || e->inflight > 0)
+            {
+                continue;
+            }
+            if (!e->conn->connected() || (maxIdleSeconds > 0 && secondsBetween(now, e->lastUsed) > maxIdleSeconds) ||
+                (check && !check(e->conn)))
+            {
+                evicted.push_back(e.get());
+            }
+        }
+        for (Entry* e : evicted)
+        {
+            removeEntry(e);
+        }
+    }
+}
+
+void ConnectionPool::LoopPool::markBusy(Entry* entry)
+{
+    if (entry->inflight++ == 0)
+    {
+        increase(idle_, -1);
+        increase(active_);
+    }
+}
+
+void ConnectionPool::LoopPool::markIdle(Entry* entry)
+{
+    if (--entry->inflight == 0)
+    {
+        increase(active_, -1);
+        increase(idle_);
+    }
+}
+
+ConnectionPool::ConnectionPool(const std::vector<EventLoop*>& loops, const std::string& name,
+                               const ConnectionPoolOptions& options)
+    : name_(name)
+    , options_(options)
+{
+    if (loops.empty() || options_.maxConnectionsPerHost == 0 || options_.maxPipelinedRequests == 0)
+    {
+        spdlog::critical("ConnectionPool[{}] - invalid loops or options", name_);
+        abort();
+    }
+    int index = 0;
+    for (EventLoop* loop : loops)
+    {
+        loopPools_[loop] = std::make_shared<LoopPool>(this, loop, index++);
+    }
+}
+
+//各个LoopPool在自己的loop线程中关闭
+//LoopPool通过owner_读取options和回调 等每个loop都执行完shutdown再返回 之后不会再访问已经析构的ConnectionPool
+ConnectionPool::~ConnectionPool()
+{
+    for (auto& item : loopPools_)
+    {
+        EventLoop* loop = item.first;
+        LoopPoolPtr pool(item.second);
+        if (loop->isInLoopThread())
+        {
+            pool->shutdown();
+            continue;
+        }
+        std::promise<void> done;
+        loop->runInLoop([pool, &done]() {
+            pool->shutdown();
+            done.set_value();
+        });
+        done.get_future().wait();
+    }
+}
+
+void ConnectionPool::acquire(const InetAddress& addr, AcquireCallback cb) { localPool()->acquire(addr, std::move(cb)); }
+
+void ConnectionPool::release(const TcpConnectionPtr& conn) { localPool()->release(conn); }
+
+ConnectionPoolStats ConnectionPool::stats() const
+{
+    ConnectionPoolStats result;
+    for (const auto& item : loopPools_)
+    {
+        item.second->addStatsTo(&result);
+    }
+    return result;
+}
+
+ConnectionPool::LoopPool* ConnectionPool::localPool() const
+{
+    EventLoop* loop = EventLoop::getEventLoopOfCurrentThread();
+    auto it = loopPools_.find(loop);
+    if (it == loopPools_.end())
+    {
+        spdlog::critical("ConnectionPool[{}] - must be used in one of its loop threads", name_);
+        abort();
+    }
+    return it->second.get();
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "myMuduo/base/TimerId.h"
+#include "myMuduo/base/Timestamp.h"
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/Callback.h"
+#include "myMuduo/net/InetAddress.h"
+
+namespace myMuduo {
+namespace net {
+
+class EventLoop;
+class TcpClient;
+
+struct ConnectionPoolOptions
+{
+    size_t maxConnectionsPerHost = 8;          // 每个loop上 每个上游地址的最大连接数
+    size_t maxIdlePerHost = 4;                 // 每个loop上 每个上游地址最多保留的空闲连接数
+    double maxIdleSeconds = 60.0;              // 空闲超过该时间的连接在健康检查时回收 <=0表示不回收
+    size_t maxPipelinedRequests = 1;           // 单条连接上同时在途的最大请求数 1表示不做pipelining
+    size_t maxPendingAcquires = 1024;          // 每个上游地址排队等待连接的请求上限
+    double connectTimeoutSeconds = 3.0;        // 建立连接的超时时间
+    double healthCheckIntervalSeconds = 5.0;   // 健康检查周期 <=0表示关闭
+};
+
+struct ConnectionPoolStats
+{
+    uint64_t hits = 0;             // 直接复用了已有连接
+    uint64_t creates = 0;          // 新建连接
+    uint64_t evictions = 0;        // 回收的连接 包括空闲超时 健康检查失败 对端关闭
+    uint64_t connectFailures = 0;  // 建连超时
+    uint64_t waits = 0;            // 没有可用连接 进入排队
+    uint64_t rejects = 0;          // 排队已满 直接失败
+    uint64_t idle = 0;             // 当前空闲连接数
+    uint64_t active = 0;           // 当前正在使用的连接数
+};
+
+//按上游地址维护的连接池 每个EventLoop有一份独立的连接
+//在loop N上到来的请求只会拿到loop N拥有的连接 整个获取和归还过程都在本loop线程中完成 不加锁 也不跨线程runInLoop
+//acquire/release只能在构造时传入的某个loop线程中调用
+class ConnectionPool : noncopyable
+{
+public:
+    //获取失败时conn为nullptr
+    using AcquireCallback = std::function<void(const TcpConnectionPtr& conn)>;
+    //返回false表示连接不健康 会被回收
+    using HealthCheckCallback = std::function<bool(const TcpConnectionPtr& conn)>;
+
+    ConnectionPool(const std::vector<EventLoop*>& loops, const std::string& name,
+                   const ConnectionPoolOptions& options = ConnectionPoolOptions());
+    //阻塞到每个loop都关闭了自己的连接 所以各个loop在析构前必须还在运行
+    ~ConnectionPool();
+
+    //以下回调需要在第一次acquire之前设置
+    void setMessageCallback(MessageCallback cb) { messageCallback_ = std::move(cb); }
+    void setConnectionCallback(ConnectionCallback cb) { connectionCallback_ = std::move(cb); }
+    void setHealthCheckCallback(HealthCheckCallback cb) { healthCheckCallback_ = std::move(cb); }
+
+    void acquire(const InetAddress& addr, AcquireCallback cb);
+    //每次acquire成功后都要release一次
+    void release(const TcpConnectionPtr& conn);
+
+    const ConnectionPoolOptions& options() const { return options_; }
+    const std::string& name() const { return name_; }
+
+    //所有loop的统计之和 可以在任意线程调用
+    ConnectionPoolStats stats() const;
+
+private:
+    class LoopPool;
+    using LoopPoolPtr = std::shared_ptr<LoopPool>;
+
+    LoopPool* localPool() const;
+
+    const std::string name_;
+    const ConnectionPoolOptions options_;
+    MessageCallback messageCallback_;
+    ConnectionCallback connectionCallback_;
+    HealthCheckCallback healthCheckCallback_;
+    //构造后不再修改 各个loop线程只读
+    std::unordered_map<EventLoop*, LoopPoolPtr> loopPools_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,238 @@
+#include "myMuduo/net/ConnectionSampler.h"
+#include <netinet/tcp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/LoopMetrics.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+namespace {
+
+//所有loop的ConnectionSampler 在构造和析构时登记和注销
+std::mutex& samplersMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<ConnectionSampler*>& samplers()
+{
+    static std::vector<ConnectionSampler*> samplers;
+    return samplers;
+}
+
+uint64_t sortValue(const ConnectionSampler::Sample& sample, ConnectionSampler::SortKey key)
+{
+    switch (key)
+    {
+        case ConnectionSampler::kByRtt:
+            return sample.hasTcpInfo ? sample.rttMicros : 0;
+        case ConnectionSampler::kByRetrans:
+            return sample.hasTcpInfo ? sample.totalRetrans : 0;
+        case ConnectionSampler::kByBackpressure:
+            return static_cast<uint64_t>(sample.stats.backpressureMicros);
+        case ConnectionSampler::kByBytes:
+            return sample.stats.counters[ConnectionStats::kBytesRead] +
+                   sample.stats.counters[ConnectionStats::kBytesWritten];
+    }
+    return 0;
+}
+
+}  // namespace
+
+ConnectionSampler::Sample::Sample()
+    : hasTcpInfo(false)
+    , rttMicros(0)
+    , rttVarMicros(0)
+    , cwnd(0)
+    , unacked(0)
+    , lost(0)
+    , totalRetrans(0)
+{
+}
+
+ConnectionSampler::ConnectionSampler(EventLoop* loop)
+    : loop_(loop)
+    , cursor_(nullptr)
+    , fraction_(0)
+    , started_(false)
+{
+    std::lock_guard<std::mutex> lock(samplersMutex());
+    samplers().push_back(this);
+}
+
+ConnectionSampler::~ConnectionSampler()
+{
+    std::lock_guard<std::mutex> lock(samplersMutex());
+    samplers().erase(std::remove(samplers().begin(), samplers().end(), this), samplers().end());
+}
+
+void ConnectionSampler::add(const TcpConnectionPtr& conn)
+{
+    loop_->assertInLoopThread();
+    Entry& entry = entries_[conn.get()];
+    entry.conn = conn;
+    entry.sample = Sample();
+    entry.sample.name = conn->getName();
+    entry.sample.peer = conn->getPeerAddress().toIpPort();
+    entry.sample.loopName = loop_->metrics().loopName();
+}
+
+void ConnectionSampler::remove(TcpConnection* conn)
+{
+    loop_->assertInLoopThread();
+    if (cursor_ == conn)
+    {
+        cursor_ = nullptr;
+    }
+    entries_.erase(conn);
+}
+
+void ConnectionSampler::start(double intervalSeconds, double fraction)
+{
+    if (intervalSeconds <= 0 || fraction <= 0 || fraction > 1)
+    {
+        spdlog::critical("ConnectionSampler::start() - invalid interval {} or fraction {}", intervalSeconds, fraction);
+        abort();
+    }
+    loop_->runInLoop([this, intervalSeconds, fraction]() { startInLoop(intervalSeconds, fraction); });
+}
+
+void ConnectionSampler::stop()
+{
+    loop_->runInLoop([this]() { stopInLoop(); });
+}
+
+void ConnectionSampler::startInLoop(double intervalSeconds, double fraction)
+{
+    loop_->assertInLoopThread();
+    stopInLoop();
+    fraction_ = fraction;
+    started_ = true;
+    timerId_ = loop_->runEvery(intervalSeconds, [this]() { sample(); });
+}
+
+void ConnectionSampler::stopInLoop()
+{
+    loop_->assertInLoopThread();
+    if (started_)
+    {
+        loop_->cancel(timerId_);
+        started_ = false;
+    }
+}
+
+void ConnectionSampler::sample()
+{
+    loop_->assertInLoopThread();
+    Timestamp now = Timestamp::now();
+    int64_t nowMicros = now.microSecondsSinceEpoch();
+    for (auto& item : entries_)
+    {
+        TcpConnectionPtr conn = item.second.conn.lock();
+        if (conn)
+        {
+            item.second.sample.stats = conn->stats().snapshot(nowMicros);
+        }
+    }
+
+    //从上一次停下的位置开始轮流采样 连接数不变时每1/fraction轮覆盖所有连接
+    size_t quota = static_cast<size_t>(std::ceil(fraction_ * static_cast<double>(entries_.size())));
+    auto it = cursor_ ? entries_.upper_bound(cursor_) : entries_.begin();
+    for (size_t i = 0; i < quota; ++i, ++it)
+    {
+        if (it == entries_.end())
+        {
+            it = entries_.begin();
+        }
+        cursor_ = it->first;
+        TcpConnectionPtr conn = it->second.conn.lock();
+        struct tcp_info info;
+        if (conn && conn->getTcpInfo(&info))
+        {
+            Sample& sample = it->second.sample;
+            sample.hasTcpInfo = true;
+            sample.tcpInfoTime = now;
+            sample.rttMicros = info.tcpi_rtt;
+            sample.rttVarMicros = info.tcpi_rttvar;
+            sample.cwnd = info.tcpi_snd_cwnd;
+            sample.unacked = info.tcpi_unacked;
+            sample.lost = info.tcpi_lost;
+            sample.totalRetrans = info.tcpi_total_retrans;
+        }
+    }
+
+    std::vector<Sample> published;
+    published.reserve(entries_.size());
+    for (const auto& item : entries_)
+    {
+        published.push_back(item.second.sample);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    published_.swap(published);
+}
+
+std::vector<ConnectionSampler::Sample> ConnectionSampler::samples() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return published_;
+}
+
+std::vector<ConnectionSampler::Sample> ConnectionSampler::topN(size_t n, SortKey key)
+{
+    std::vector<Sample> all;
+    {
+        std::lock_guard<std::mutex> lock(samplersMutex());
+        for (ConnectionSampler* sampler : samplers())
+        {
+            std::vector<Sample> samples = sampler->samples();
+            all.insert(all.end(), samples.begin(), samples.end());
+        }
+    }
+
+    n = std::min(n, all.size());
+    std::partial_sort(all.begin(), all.begin() + n, all.end(), [key](const Sample& lhs, const Sample& rhs) {
+        return sortValue(lhs, key) > sortValue(rhs, key);
+    });
+    all.resize(n);
+    return all;
+}
+
+std::string ConnectionSampler::format(const std::vector<Sample>& samples)
+{
+    std::string out;
+    char buf[512];
+    for (const Sample& sample : samples)
+    {
+        const uint64_t* counters = sample.stats.counters;
+        snprintf(buf, sizeof(buf),
+                 "%s peer=%s loop=%s bytes_read=%llu bytes_written=%llu messages=%llu read_calls=%llu "
+                 "write_calls=%llu eagains=%llu backpressure_ms=%lld",
+                 sample.name.c_str(), sample.peer.c_str(), sample.loopName.c_str(),
+                 static_cast<unsigned long long>(counters[ConnectionStats::kBytesRead]),
+                 static_cast<unsigned long long>(counters[ConnectionStats::kBytesWritten]),
+                 static_cast<unsigned long long>(counters[ConnectionStats::kMessages]),
+                 static_cast<unsigned long long>(counters[ConnectionStats::kReadCalls]),
+                 static_cast<unsigned long long>(counters[ConnectionStats::kWriteCalls]),
+                 static_cast<unsigned long long>(counters[ConnectionStats::kEagains]),
+                 static_cast<long long>(sample.stats.backpressureMicros / 1000));
+        out += buf;
+        if (sample.hasTcpInfo)
+        {
+            snprintf(buf, sizeof(buf), " rtt_us=%u rttvar_us=%u cwnd=%u unacked=%u lost=%u total_retrans=%u",
+                     sample.rttMicros, sample.rttVarMicros, sample.cwnd, sample.unacked, sample.lost,
+                     sample.totalRetrans);
+            out += buf;
+        }
+        out += "\n";
+    }
+    return out;
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "myMuduo/base/TimerId.h"
+#include "myMuduo/base/Timestamp.h"
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/Callback.h"
+#include "myMuduo/net/ConnectionStats.h"
+
+namespace myMuduo {
+namespace net {
+
+class EventLoop;
+
+//每个EventLoop一个 记录本loop上的所有TcpConnection
+//start之后每隔interval在loop线程中刷新所有连接的ConnectionStats
+//并轮流对其中fraction比例的连接调用getsockopt(TCP_INFO) 取rtt cwnd 重传数
+//结果发布到一份快照中 topN在任意线程中合并所有loop的快照 找出最慢的对端
+//
+//  for (EventLoop* loop : server.threadPool()->getAllLoops())
+//      loop->connectionSampler().start(1.0, 0.1);
+//  auto slowest = ConnectionSampler::topN(10, ConnectionSampler::kByRtt);
+class ConnectionSampler : noncopyable
+{
+public:
+    struct Sample
+    {
+        Sample();
+
+        std::string name;
+        std::string peer;
+        std::string loopName;
+        ConnectionStats::Snapshot stats;
+        bool hasTcpInfo;         //还没轮到过采样时为false 下面的字段无效
+        Timestamp tcpInfoTime;   //上一次采样TCP_INFO的时间
+        uint32_t rttMicros;
+        uint32_t rttVarMicros;
+        uint32_t cwnd;           //以MSS为单位
+        uint32_t unacked;        //已发出未确认的包数
+        uint32_t lost;
+        uint32_t totalRetrans;
+    };
+
+    enum SortKey
+    {
+        kByRtt,
+        kByRetrans,
+        kByBackpressure,
+        kByBytes,  //读写字节数之和
+    };
+
+    explicit ConnectionSampler(EventLoop* loop);
+    ~ConnectionSampler();
+
+    //连接建立和销毁时由TcpConnection在loop线程中调用
+    void add(const TcpConnectionPtr& conn);
+    void remove(TcpConnection* conn);
+
+    //任意线程调用 interval秒采样一次 fraction(0~1]是每次采样TCP_INFO的连接比例
+    void start(double intervalSeconds = 1.0, double fraction = 0.1);
+    void stop();
+
+    //本loop上一次发布的快照
+    std::vector<Sample> samples() const;
+
+    //所有loop中按key从大到小的前n个连接 没有TCP_INFO的连接在kByRtt和kByRetrans中排在最后
+    static std::vector<Sample> topN(size_t n, SortKey key);
+    //每个连接一行的文本 给调试页面使用
+    static std::string format(const std::vector<Sample>& samples);
+
+private:
+    struct Entry
+    {
+        std::weak_ptr<TcpConnection> conn;
+        Sample sample;
+    };
+
+    void startInLoop(double intervalSeconds, double fraction);
+    void stopInLoop();
+    void sample();
+
+    EventLoop* loop_;
+    std::map<TcpConnection*, Entry> entries_;  //只在loop线程中使用
+    TcpConnection* cursor_;                    //上一次采样TCP_INFO的最后一个连接 下一次从它之后开始
+    double fraction_;
+    bool started_;
+    base::TimerId timerId_;
+
+    mutable std::mutex mutex_;  //保护published_
+    std::vector<Sample> published_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
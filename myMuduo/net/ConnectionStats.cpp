@@ -0,0 +1,71 @@
+#include "myMuduo/net/ConnectionStats.h"
+#include <algorithm>
+
+namespace myMuduo {
+namespace net {
+
+namespace {
+
+const char* const kCounterNames[] = {"bytes_read", "bytes_written", "messages", "read_calls", "write_calls", "eagains"};
+
+static_assert(sizeof(kCounterNames) / sizeof(kCounterNames[0]) == ConnectionStats::kNumCounters,
+              "counter names out of sync");
+
+}  // namespace
+
+ConnectionStats::Snapshot::Snapshot()
+    : backpressureMicros(0)
+{
+    std::fill(counters, counters + kNumCounters, 0);
+}
+
+ConnectionStats::ConnectionStats()
+    : backpressureMicros_(0)
+    , backpressureSince_(0)
+{
+    for (int i = 0; i < kNumCounters; ++i)
+    {
+        counters_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void ConnectionStats::beginBackpressure(int64_t nowMicros)
+{
+    if (backpressureSince_.load(std::memory_order_relaxed) == 0)
+    {
+        backpressureSince_.store(nowMicros, std::memory_order_relaxed);
+    }
+}
+
+void ConnectionStats::endBackpressure(int64_t nowMicros)
+{
+    int64_t since = backpressureSince_.load(std::memory_order_relaxed);
+    if (since != 0)
+    {
+        backpressureMicros_.store(backpressureMicros_.load(std::memory_order_relaxed) + (nowMicros - since),
+                                  std::memory_order_relaxed);
+        backpressureSince_.store(0, std::memory_order_relaxed);
+    }
+}
+
+ConnectionStats::Snapshot ConnectionStats::snapshot(int64_t nowMicros) const
+{
+    Snapshot snapshot;
+    for (int i = 0; i < kNumCounters; ++i)
+    {
+        snapshot.counters[i] = counters_[i].load(std::memory_order_relaxed);
+    }
+    //其他线程读时两个值可能不是同一时刻的 只用于统计
+    snapshot.backpressureMicros = backpressureMicros_.load(std::memory_order_relaxed);
+    int64_t since = backpressureSince_.load(std::memory_order_relaxed);
+    if (since != 0 && nowMicros > since)
+    {
+        snapshot.backpressureMicros += nowMicros - since;
+    }
+    return snapshot;
+}
+
+const char* ConnectionStats::counterName(Counter counter) { return kCounterNames[counter]; }
+
+}  // namespace net
+}  // namespace myMuduo
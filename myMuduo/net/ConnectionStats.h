@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "myMuduo/base/noncopyable.h"
+
+namespace myMuduo {
+namespace net {
+
+//每个TcpConnection一份的流量计数 只在连接所属的loop线程中写 其他线程随时可以snapshot
+//和LoopMetrics一样用relaxed原子变量load+store累加 没有lock前缀
+class ConnectionStats : noncopyable
+{
+public:
+    enum Counter
+    {
+        kBytesRead,
+        kBytesWritten,
+        kMessages,    //messageCallback的调用次数
+        kReadCalls,   //readv的次数
+        kWriteCalls,  //write的次数
+        kEagains,     //读写返回EAGAIN的次数
+        kNumCounters
+    };
+
+    struct Snapshot
+    {
+        Snapshot();
+
+        uint64_t counters[kNumCounters];
+        int64_t backpressureMicros;  //outputBuffer有积压(等待可写事件)的累计时间 包括正在积压的部分
+    };
+
+    ConnectionStats();
+
+    void add(Counter counter, uint64_t n = 1)
+    {
+        counters_[counter].store(counters_[counter].load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    uint64_t get(Counter counter) const { return counters_[counter].load(std::memory_order_relaxed); }
+
+    //开始和结束关注可写事件时调用 只在状态切换时读一次时钟
+    void beginBackpressure(int64_t nowMicros);
+    void endBackpressure(int64_t nowMicros);
+    bool inBackpressure() const { return backpressureSince_.load(std::memory_order_relaxed) != 0; }
+
+    Snapshot snapshot(int64_t nowMicros) const;
+
+    static const char* counterName(Counter counter);
+
+private:
+    std::atomic<uint64_t> counters_[kNumCounters];
+    std::atomic<int64_t> backpressureMicros_;
+    std::atomic<int64_t> backpressureSince_;  //0表示没有积压
+};
+
+}  // namespace net
+}  // namespace myMuduo
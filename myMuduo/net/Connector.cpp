@@ -0,0 +1,215 @@
+#include "myMuduo/net/Connector.h"
+#include <unistd.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "myMuduo/base/WeakCallback.h"
+#include "myMuduo/net/Channel.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/Socket.h"
+#include "myMuduo/base/Logging.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+const int Connector::kMaxRetryDelayMs;
+const int Connector::kInitRetryDelayMs;
+
+Connector::Connector(EventLoop* loop, const InetAddress& serverAddr)
+    : loop_(loop)
+    , serverAddr_(serverAddr)
+    , connect_(false)
+    , state_(kDisconnected)
+    , channelPtr_()
+    , newConnectionCallback_()
+    , retryDelayMs_(kInitRetryDelayMs)
+{
+    MYMUDUO_LOG_DEBUG("Connector::Connector() - server address: {}", serverAddr_.toIpPort());
+}
+
+Connector::~Connector() { assert(!channelPtr_); }
+
+void Connector::start()
+{
+    connect_ = true;
+    auto self = shared_from_this();
+    loop_->runInLoop([self]() { self->startInLoop(); });
+}
+
+void Connector::restart()
+{
+    loop_->assertInLoopThread();
+    setState(kDisconnected);
+    retryDelayMs_ = kInitRetryDelayMs;
+    connect_ = true;
+    startInLoop();
+}
+
+void Connector::stop()
+{
+    connect_ = false;
+    //持有shared_ptr 保证stopInLoop执行时Connector还活着
+    auto self = shared_from_this();
+    loop_->queueInLoop([self]() { self->stopInLoop(); });
+}
+
+void Connector::startInLoop()
+{
+    loop_->assertInLoopThread();
+    assert(state_ == kDisconnected);
+    if (connect_)
+    {
+        connect();
+    }
+    else
+    {
+        MYMUDUO_LOG_DEBUG("Connector::startInLoop() - do not connect");
+    }
+}
+
+void Connector::stopInLoop()
+{
+    loop_->assertInLoopThread();
+    if (state_ == kConnecting)
+    {
+        setState(kDisconnected);
+        int sockfd = removeAndResetChannel();
+        retry(sockfd);
+    }
+}
+
+void Connector::connect()
+{
+    int sockfd = createNonblockingOrDie(serverAddr_.family());
+    const struct sockaddr_in* addr = serverAddr_.getSockAddr();
+    int ret = ::connect(sockfd, reinterpret_cast<const struct sockaddr*>(addr), sizeof(struct sockaddr_in));
+    int savedErrno = (ret == 0) ? 0 : errno;
+    switch (savedErrno)
+    {
+        //连接成功或者正在连接中 等待可写事件确认结果
+        case 0:
+        case EINPROGRESS:
+        case EINTR:
+        case EISCONN:
+            connecting(sockfd);
+            break;
+
+        //可以重试的错误
+        case EAGAIN:
+        case EADDRINUSE:
+        case EADDRNOTAVAIL:
+        case ECONNREFUSED:
+        case ENETUNREACH:
+            retry(sockfd);
+            break;
+
+        case EACCES:
+        case EPERM:
+        case EAFNOSUPPORT:
+        case EALREADY:
+        case EBADF:
+        case EFAULT:
+        case ENOTSOCK:
+            spdlog::error("Connector::connect() - connect error: {}", strerror(savedErrno));
+            ::close(sockfd);
+            break;
+
+        default:
+            spdlog::error("Connector::connect() - unexpected error: {}", strerror(savedErrno));
+            ::close(sockfd);
+            break;
+    }
+}
+
+void Connector::connecting(int sockfd)
+{
+    setState(kConnecting);
+    assert(!channelPtr_);
+    channelPtr_.reset(new Channel(loop_, sockfd));
+    channelPtr_->setWriteCallback([this]() { this->handleWrite(); });
+    channelPtr_->setErrorCallback([this]() { this->handleError(); });
+    channelPtr_->enableWriting();
+}
+
+int Connector::removeAndResetChannel()
+{
+    channelPtr_->disableAll();
+    channelPtr_->remove();
+    int sockfd = channelPtr_->fd();
+    //当前可能正处于Channel::handleEvent中 不能直接析构Channel
+    auto self = shared_from_this();
+    loop_->queueInLoop([self]() { self->resetChannel(); });
+    return sockfd;
+}
+
+void Connector::resetChannel() { channelPtr_.reset(); }
+
+//可写不代表连接成功 需要用SO_ERROR确认
+void Connector::handleWrite()
+{
+    MYMUDUO_LOG_DEBUG("Connector::handleWrite() - state: {}", static_cast<int>(state_));
+    if (state_ == kConnecting)
+    {
+        int sockfd = removeAndResetChannel();
+        int err = Socket::getSocketError(sockfd);
+        if (err)
+        {
+            spdlog::warn("Connector::handleWrite() - SO_ERROR = {} {}", err, strerror(err));
+            retry(sockfd);
+        }
+        else if (isSelfConnect(sockfd))
+        {
+            spdlog::warn("Connector::handleWrite() - self connect");
+            retry(sockfd);
+        }
+        else
+        {
+            setState(kConnected);
+            if (connect_ && newConnectionCallback_)
+            {
+                newConnectionCallback_(sockfd);
+            }
+            else
+            {
+                ::close(sockfd);
+            }
+        }
+    }
+    else
+    {
+        assert(state_ == kDisconnected);
+    }
+}
+
+void Connector::handleError()
+{
+    spdlog::error("Connector::handleError() - state: {}", static_cast<int>(state_));
+    if (state_ == kConnecting)
+    {
+        int sockfd = removeAndResetChannel();
+        int err = Socket::getSocketError(sockfd);
+        MYMUDUO_LOG_DEBUG("Connector::handleError() - SO_ERROR = {} {}", err, strerror(err));
+        retry(sockfd);
+    }
+}
+
+void Connector::retry(int sockfd)
+{
+    ::close(sockfd);
+    setState(kDisconnected);
+    if (connect_)
+    {
+        spdlog::info("Connector::retry() - retry connecting to {} in {} ms", serverAddr_.toIpPort(),
+                     retryDelayMs_);
+        loop_->runAfter(retryDelayMs_ / 1000.0, makeWeakCallback(shared_from_this(), &Connector::startInLoop));
+        retryDelayMs_ = std::min(retryDelayMs_ * 2, kMaxRetryDelayMs);
+    }
+    else
+    {
+        MYMUDUO_LOG_DEBUG("Connector::retry() - do not connect");
+    }
+}
+
+}  // namespace net
+}  // namespace myMuduo
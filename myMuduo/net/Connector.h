@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/InetAddress.h"
+
+namespace myMuduo {
+namespace net {
+
+class Channel;
+class EventLoop;
+
+//主动发起连接 对应服务端的Acceptor
+//非阻塞connect 通过Channel的可写事件判断连接是否建立 失败时按指数退避重试
+class Connector : noncopyable, public std::enable_shared_from_this<Connector>
+{
+public:
+    using NewConnectionCallback = std::function<void(int sockfd)>;
+
+    Connector(EventLoop* loop, const InetAddress& serverAddr);
+    ~Connector();
+
+    void setNewConnectionCallback(NewConnectionCallback cb) { newConnectionCallback_ = std::move(cb); }
+
+    void start();    // 可以在任意线程调用
+    void restart();  // 只能在loop线程调用
+    void stop();     // 可以在任意线程调用
+
+    const InetAddress& serverAddress() const { return serverAddr_; }
+
+private:
+    enum StateE
+    {
+        kDisconnected,
+        kConnecting,
+        kConnected
+    };
+    static const int kMaxRetryDelayMs = 30 * 1000;
+    static const int kInitRetryDelayMs = 500;
+
+    void setState(StateE s) { state_ = s; }
+    void startInLoop();
+    void stopInLoop();
+    void connect();
+    void connecting(int sockfd);
+    void handleWrite();
+    void handleError();
+    void retry(int sockfd);
+    int removeAndResetChannel();
+    void resetChannel();
+
+    EventLoop* loop_;
+    InetAddress serverAddr_;
+    std::atomic<bool> connect_;
+    StateE state_;
+    std::unique_ptr<Channel> channelPtr_;
+    NewConnectionCallback newConnectionCallback_;
+    int retryDelayMs_;
+};
+
+using ConnectorPtr = std::shared_ptr<Connector>;
+
+}  // namespace net
+}  // namespace myMuduo
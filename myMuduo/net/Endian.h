@@ -0,0 +1,65 @@
+#pragma once
+
+#include <endian.h>
+#include <stdint.h>
+
+namespace myMuduo {
+namespace net {
+namespace sockets {
+
+//主机字节序和网络字节序(大端)之间转换
+inline uint64_t hostToNetwork64(uint64_t host64) { return htobe64(host64); }
+
+inline uint32_t hostToNetwork32(uint32_t host32) { return htobe32(host32); }
+
+inline uint16_t hostToNetwork16(uint16_t host16) { return htobe16(host16); }
+
+inline uint64_t networkToHost64(uint64_t net64) { return be64toh(net64); }
+
+inline uint32_t networkToHost32(uint32_t net32) { return be32toh(net32); }
+
+inline uint16_t networkToHost16(uint16_t net16) { return be16toh(net16); }
+
+//按整数宽度选择上面的函数 给Buffer的模板接口用
+template <size_t Size>
+struct ByteOrder;
+
+template <>
+struct ByteOrder<1>
+{
+    static uint8_t toNetwork(uint8_t x) { return x; }
+    static uint8_t toHost(uint8_t x) { return x; }
+};
+
+template <>
+struct ByteOrder<2>
+{
+    static uint16_t toNetwork(uint16_t x) { return hostToNetwork16(x); }
+    static uint16_t toHost(uint16_t x) { return networkToHost16(x); }
+};
+
+template <>
+struct ByteOrder<4>
+{
+    static uint32_t toNetwork(uint32_t x) { return hostToNetwork32(x); }
+    static uint32_t toHost(uint32_t x) { return networkToHost32(x); }
+};
+
+template <>
+struct ByteOrder<8>
+{
+    static uint64_t toNetwork(uint64_t x) { return hostToNetwork64(x); }
+    static uint64_t toHost(uint64_t x) { return networkToHost64(x); }
+};
+
+//zigzag把有符号数映射成无符号数 绝对值小的负数也能编码成短的varint
+inline uint64_t encodeZigZag64(int64_t n)
+{
+    return (static_cast<uint64_t>(n) << 1) ^ static_cast<uint64_t>(n >> 63);
+}
+
+inline int64_t decodeZigZag64(uint64_t n) { return static_cast<int64_t>((n >> 1) ^ (~(n & 1) + 1)); }
+
+}  // namespace sockets
+}  // namespace net
+}  // namespace myMuduo
@@ -4,7 +4,10 @@
 #include "EventLoop.h"
 #include "myMuduo/base/CurrentThread.h"
 #include "myMuduo/net/Channel.h"
+#include "myMuduo/net/ConnectionSampler.h"
+#include "myMuduo/net/LoopMetrics.h"
 #include "myMuduo/net/poller/Poller.h"
+#include "myMuduo/base/Logging.h"
 #include "spdlog/spdlog.h"
 
 namespace myMuduo {
@@ -38,10 +41,16 @@ EventLoop::EventLoop()
     , eventHandling_(false)
     , callingPendingFunctors_(false)
     , threadId_(base::CurrentThread::tid())
+    , metricsPtr_(new LoopMetrics(base::CurrentThread::threadName(), threadId_))
+    , connectionSamplerPtr_(new ConnectionSampler(this))
     , pollerPtr_(IPoller::newDefaultPoller(this))
+    , timerQueuePtr_(new base::TimerQueue(this))
     , wakeupFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))  // 创建一个非阻塞的eventfd
     , wakeupChannelPtr_(new Channel(this, wakeupFd_))
     , currentActiveChannel_(nullptr)
+    , busyPollMicros_(0)
+    , spinning_(false)
+    , spinQueued_(false)
 {
     spdlog::debug("EventLoop created in thread {}", threadId_);
     if (t_loopInThisThread)
@@ -58,10 +67,12 @@ EventLoop::EventLoop()
     // 设置wakeupChannel的回调函数，当wakeupFd有可读事件时触发
     wakeupChannelPtr_->setReadCallback([this](Timestamp timestamp) { this->handleRead(timestamp); });
     wakeupChannelPtr_->enableReading();
+    MetricsRegistry::instance().add(metricsPtr_.get());
 }
 
 EventLoop::~EventLoop()
 {
+    MetricsRegistry::instance().remove(metricsPtr_.get());
     wakeupChannelPtr_->disableAll();
     wakeupChannelPtr_->remove();
     close(wakeupFd_);
@@ -79,8 +90,19 @@ void EventLoop::loop()
     {
         activeChannels_.clear();
         //有2类fd wakeupFd 和 connFd
-        pollReturnTime_ = pollerPtr_->poll(kPollTimeMs, &activeChannels_);
+        metricsPtr_->setActivity(LoopMetrics::kInPoll);
+        int64_t busyPollMicros = busyPollMicros_.load(std::memory_order_relaxed);
+        if (busyPollMicros > 0)
+        {
+            pollReturnTime_ = busyPoll(busyPollMicros);
+        }
+        else
+        {
+            pollReturnTime_ = pollerPtr_->poll(kPollTimeMs, &activeChannels_);
+        }
 
+        metricsPtr_->add(LoopMetrics::kWakeups);
+        metricsPtr_->add(LoopMetrics::kEvents, activeChannels_.size());
         printActiveChannels();
 
         eventHandling_ = true;
@@ -94,8 +116,19 @@ void EventLoop::loop()
         //处理channel回调完成后 再执行之前queueInLoop里注册的回调
         //主要是baseloop在接收到新连接时, 调用ioLoop的连接建立回调
         doPendingFunctors();
+        doAfterIterationFunctors();
+
+        if (iterationCallback_)
+        {
+            metricsPtr_->setActivity(LoopMetrics::kInIterationCallback);
+            iterationCallback_();
+        }
+        metricsPtr_->busyMicros().record(Timestamp::now().microSecondsSinceEpoch() -
+                                         pollReturnTime_.microSecondsSinceEpoch());
     }
 
+    //退出循环后不再执行回调 LoopWatchdog不要把最后一个回调当成卡住
+    metricsPtr_->setActivity(LoopMetrics::kInPoll);
     spdlog::info("EventLoop::loop() - EventLoop {} quit", threadId_);
     looping_ = false;
 }
@@ -130,9 +163,21 @@ void EventLoop::runInLoop(Functor cb)
 //排队到loop下次循环时执行
 void EventLoop::queueInLoop(Functor cb)
 {
+    bool spinning = false;
     {
         std::lock_guard<std::mutex> lock(functorMutex_);
         pendingFunctors_.push_back(std::move(cb));
+        spinning = spinning_;
+        if (spinning)
+        {
+            spinQueued_.store(true, std::memory_order_release);
+        }
+    }
+
+    //loop正在忙等 下一次poll(0)之后就会看到 省掉eventfd的write和read
+    if (spinning)
+    {
+        return;
     }
 
     //1、非本loop线程调用queueInLoop时，直接唤醒该loop线程
@@ -157,7 +202,7 @@ void EventLoop::wakeup()
     ssize_t n = write(wakeupFd_, &one, sizeof(one));
     if (n != sizeof(one))
     {
-        spdlog::error("EventLoop::wakeup() - write {} bytes instead of {}, fd={}", n, sizeof(one), wakeupFd_);
+        MYMUDUO_LOG_ERROR("EventLoop::wakeup() - write {} bytes instead of {}, fd={}", n, sizeof(one), wakeupFd_);
     }
 }
 
@@ -198,6 +243,18 @@ void EventLoop::setContext(const base::Any &context) { context_ = context; }
 
 const base::Any &EventLoop::getContext() const { return context_; }
 
+void EventLoop::setIterationCallback(Functor cb)
+{
+    assertInLoopThread();
+    iterationCallback_ = std::move(cb);
+}
+
+void EventLoop::runAfterIteration(Functor cb)
+{
+    assertInLoopThread();
+    afterIterationFunctors_.push_back(std::move(cb));
+}
+
 void EventLoop::abortNotInLoopThread()
 {
     spdlog::critical(
@@ -214,10 +271,41 @@ void EventLoop::handleRead(const Timestamp &timestamp)
     ssize_t n = read(wakeupFd_, &one, sizeof(one));
     if (n != sizeof(one))
     {
-        spdlog::error("EventLoop::handleRead() - read {} bytes instead of {}, fd={} time={}", n,
-                      sizeof(one), wakeupFd_, timestamp.toString());
+        MYMUDUO_LOG_ERROR("EventLoop::handleRead() - read {} bytes instead of {}, fd={} time={}", n,
+                          sizeof(one), wakeupFd_, timestamp.toString());
+    }
+}
+//先用timeout=0轮询micros微秒 有事件或者有回调排队就返回 都没有再阻塞等待
+//spinning_在functorMutex_下切换 queueInLoop要么看到spinning_为true并设置spinQueued_ 要么正常唤醒
+Timestamp EventLoop::busyPoll(int64_t micros)
+{
+    {
+        std::lock_guard<std::mutex> lock(functorMutex_);
+        spinning_ = true;
+    }
+
+    Timestamp now = Timestamp::now();
+    int64_t deadline = now.microSecondsSinceEpoch() + micros;
+    while (activeChannels_.empty() && !spinQueued_.load(std::memory_order_acquire) && !quit_ &&
+           now.microSecondsSinceEpoch() < deadline)
+    {
+        now = pollerPtr_->poll(0, &activeChannels_);
+    }
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(functorMutex_);
+        spinning_ = false;
+        queued = spinQueued_.exchange(false, std::memory_order_relaxed);
+    }
+
+    if (!activeChannels_.empty() || queued || quit_)
+    {
+        return now;
     }
+    return pollerPtr_->poll(kPollTimeMs, &activeChannels_);
 }
+
 void EventLoop::doPendingFunctors()
 {
     std::vector<Functor> functors;
@@ -227,12 +315,36 @@ void EventLoop::doPendingFunctors()
         std::lock_guard<std::mutex> lock(functorMutex_);
         functors.swap(pendingFunctors_);
     }
+    if (!functors.empty())
+    {
+        metricsPtr_->setActivity(LoopMetrics::kInFunctors);
+    }
 
     for (auto it = functors.begin(); it != functors.end(); ++it)
     {
         (*it)();
     }
     callingPendingFunctors_ = false;
+    metricsPtr_->add(LoopMetrics::kFunctors, functors.size());
+    metricsPtr_->functorBatch().record(static_cast<int64_t>(functors.size()));
+}
+
+//回调里可能再queueInLoop或者runAfterIteration 本线程的queueInLoop不会唤醒loop
+//所以交替执行到两边都空了再进入poll 否则要等到下一次有事件才会执行
+void EventLoop::doAfterIterationFunctors()
+{
+    while (!afterIterationFunctors_.empty())
+    {
+        std::vector<Functor> functors;
+        functors.swap(afterIterationFunctors_);
+        metricsPtr_->setActivity(LoopMetrics::kInFunctors);
+        for (auto it = functors.begin(); it != functors.end(); ++it)
+        {
+            (*it)();
+        }
+        metricsPtr_->add(LoopMetrics::kFunctors, functors.size());
+        doPendingFunctors();
+    }
 }
 
 void EventLoop::printActiveChannels() const
@@ -240,7 +352,7 @@ void EventLoop::printActiveChannels() const
     for (auto it = activeChannels_.begin(); it != activeChannels_.end(); ++it)
     {
         Channel *channel = *it;
-        spdlog::info("activeChannels_ = {}", channel->reventsToString());
+        MYMUDUO_LOG_TRACE("activeChannels_ = {}", channel->reventsToString());
     }
 }
 
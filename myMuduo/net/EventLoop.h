@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include "myMuduo/base/Any.h"
@@ -16,6 +17,8 @@ namespace net {
 
 class Channel;
 class IPoller;
+class LoopMetrics;
+class ConnectionSampler;
 
 //1个TcpServer拥有1个baseLoop 同时会有1个EventLoopPool
 //baseLoop负责监听新连接的到来  并将新连接的connfd分配给tcpConnect
@@ -55,12 +58,32 @@ public:
     void setContext(const base::Any &context);
     const base::Any &getContext() const;
 
+    //本loop的计数器和直方图 计数只能在loop线程中累加 见LoopMetrics
+    LoopMetrics &metrics() { return *metricsPtr_; }
+    //本loop上所有连接的流量和TCP_INFO采样 默认不采样 见ConnectionSampler::start
+    ConnectionSampler &connectionSampler() { return *connectionSamplerPtr_; }
+
+    //忙等模式 阻塞在epoll_wait之前先用timeout=0轮询micros微秒 0表示关闭 任意线程调用
+    //忙等期间其他线程的queueInLoop不写eventfd 由下一次轮询发现
+    void setBusyPoll(int64_t micros) { busyPollMicros_.store(micros, std::memory_order_relaxed); }
+    int64_t busyPollMicros() const { return busyPollMicros_.load(std::memory_order_relaxed); }
+
+    //每轮循环处理完IO事件和pendingFunctors后调用 只能在loop线程中设置
+    //用来在IO空闲时执行额外的任务 比如LoopExecutor
+    void setIterationCallback(Functor cb);
+
+    //本轮IO事件和pendingFunctors处理完后、下一次poll之前执行 只能在loop线程中调用
+    //TcpConnection::setAutoCork用它把一轮中多次send合并成一次write
+    void runAfterIteration(Functor cb);
+
     static EventLoop *getEventLoopOfCurrentThread();
 
 private:
     void abortNotInLoopThread();
     void handleRead(const Timestamp &timestamp);
     void doPendingFunctors();
+    void doAfterIterationFunctors();
+    Timestamp busyPoll(int64_t micros);
 
     void printActiveChannels() const;
 
@@ -72,6 +95,8 @@ private:
     std::atomic<bool> callingPendingFunctors_;
     const pid_t threadId_;      // 创建EventLoop的线程ID
     Timestamp pollReturnTime_;  // 上次poll的返回时间
+    std::unique_ptr<LoopMetrics> metricsPtr_;
+    std::unique_ptr<ConnectionSampler> connectionSamplerPtr_;
 
     std::unique_ptr<IPoller> pollerPtr_;
     std::unique_ptr<myMuduo::base::TimerQueue> timerQueuePtr_;
@@ -80,12 +105,18 @@ private:
     std::unique_ptr<Channel> wakeupChannelPtr_;
 
     base::Any context_;
+    Functor iterationCallback_;
+    std::vector<Functor> afterIterationFunctors_;  //只在loop线程中访问 不需要加锁
 
     ChannelList activeChannels_;
     Channel *currentActiveChannel_;  //currentActiveChannel_不拥有对象 只是临时指向正在处理的Channel
 
-    std::mutex functorMutex_;  // 保护 pendingFunctors_
+    std::mutex functorMutex_;  // 保护 pendingFunctors_ spinning_
     std::vector<Functor> pendingFunctors_;
+
+    std::atomic<int64_t> busyPollMicros_;
+    bool spinning_;                   //正在忙等 queueInLoop不需要唤醒
+    std::atomic<bool> spinQueued_;    //忙等期间有新的回调排队
 };
 
 }  // namespace net
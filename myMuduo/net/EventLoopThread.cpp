@@ -1,6 +1,8 @@
 #include "myMuduo/net/EventLoopThread.h"
 #include <mutex>
+#include "myMuduo/base/CurrentThread.h"
 #include "myMuduo/net/EventLoop.h"
+#include "spdlog/spdlog.h"
 
 namespace myMuduo {
 namespace net {
@@ -8,6 +10,8 @@ namespace net {
 EventLoopThread::EventLoopThread(const ThreadInitCallback& cb, const std::string& name)
     : loop_(nullptr)
     , exiting_(false)
+    , cpu_(-1)
+    , localMemory_(false)
     , thread_([this] { this->threadFunc(); }, name)
     , cond_()
     , mutex_()
@@ -42,6 +46,15 @@ EventLoop* EventLoopThread::startLoop()
 
 void EventLoopThread::threadFunc()
 {
+    if (cpu_ >= 0 && !base::CurrentThread::setAffinity(cpu_))
+    {
+        spdlog::warn("EventLoopThread::threadFunc() - failed to bind {} to cpu {}", base::CurrentThread::threadName(), cpu_);
+    }
+    if (localMemory_ && !base::CurrentThread::setLocalMemoryPolicy())
+    {
+        spdlog::warn("EventLoopThread::threadFunc() - set_mempolicy failed in {}", base::CurrentThread::threadName());
+    }
+
     //在新线程中创建EventLoop对象 one loop per thread
     //这个loop生命周期跟新线程一致
     EventLoop loop;
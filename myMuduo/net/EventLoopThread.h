@@ -18,11 +18,17 @@ public:
     ~EventLoopThread();
     EventLoop* startLoop();
 
+    //startLoop之前调用 在线程中创建EventLoop之前生效 loop自己的内存也分配在绑定的cpu上
+    void setCpu(int cpu) { cpu_ = cpu; }
+    void setLocalMemory(bool on) { localMemory_ = on; }
+
 private:
     void threadFunc();
     
     EventLoop* loop_;
     bool exiting_;
+    int cpu_;  //-1表示不绑定
+    bool localMemory_;
     base::Thread thread_;
     std::condition_variable cond_;
     std::mutex mutex_;
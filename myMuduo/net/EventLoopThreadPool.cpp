@@ -15,6 +15,7 @@ EventLoopThreadPool::EventLoopThreadPool(EventLoop* baseLoop, const std::string&
     , name_(name)
     , started_(false)
     , numThreads_(0)
+    , numaLocalMemory_(false)
     , threadIndex_(0)
 {
     // 初始化线程池
@@ -35,6 +36,11 @@ void EventLoopThreadPool::start(const ThreadInitCallback& cb)
     {
         std::string threadName = name_ + std::to_string(i);
         std::unique_ptr<EventLoopThread> threadPtr(new EventLoopThread(cb, threadName));
+        if (!cpus_.empty())
+        {
+            threadPtr->setCpu(cpus_[static_cast<size_t>(i) % cpus_.size()]);
+        }
+        threadPtr->setLocalMemory(numaLocalMemory_);
         
         EventLoop* tmpLoop = threadPtr->startLoop();
         //loops_只是用一下loop 不管理loop
@@ -19,6 +19,10 @@ public:
     ~EventLoopThreadPool();
 
     void setThreadNum(int numThreads) { numThreads_ = numThreads; }
+    //start之前调用 第i个IO线程绑定到cpus[i % cpus.size()] 为空时不绑定
+    void setCpuAffinity(const std::vector<int>& cpus) { cpus_ = cpus; }
+    //IO线程的内存分配在本地NUMA节点 和setCpuAffinity一起使用
+    void setNumaLocalMemory(bool on) { numaLocalMemory_ = on; }
     void start(const ThreadInitCallback& cb = ThreadInitCallback());
 
     EventLoop* getNextLoop();
@@ -32,6 +36,8 @@ private:
     std::string name_;
     bool started_;
     int numThreads_;
+    std::vector<int> cpus_;
+    bool numaLocalMemory_;
     //不拥有loop的实际线程对象
     std::vector<EventLoop*> loops_;
     //实际的线程对象
@@ -0,0 +1,262 @@
+#include "myMuduo/net/LoopExecutor.h"
+#include <cassert>
+#include <chrono>
+#include <future>
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/EventLoopThreadPool.h"
+
+namespace myMuduo {
+namespace net {
+
+const int64_t LoopExecutor::kBudgetMicros;
+
+namespace {
+
+int64_t nowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+LoopExecutor::LoopExecutor(EventLoopThreadPool* threadPool)
+    : nextSlot_(0)
+    , submitted_(0)
+    , stolen_(0)
+{
+    assert(threadPool->started());
+    for (EventLoop* loop : threadPool->getAllLoops())
+    {
+        slots_.emplace_back(new Slot(loop));
+    }
+    //slots_建好之后才安装 任何一个loop开始执行时都可能去偷别的loop
+    for (auto& slot : slots_)
+    {
+        Slot* s = slot.get();
+        s->loop->runInLoop([this, s]() { s->loop->setIterationCallback([this, s]() { runTasks(s); }); });
+    }
+}
+
+LoopExecutor::~LoopExecutor()
+{
+    for (auto& slot : slots_)
+    {
+        EventLoop* loop = slot->loop;
+        if (loop->isInLoopThread())
+        {
+            loop->setIterationCallback(EventLoop::Functor());
+            continue;
+        }
+        //等loop线程确认卸载 之后它不会再碰任何slot
+        std::promise<void> removed;
+        loop->runInLoop([loop, &removed]() {
+            loop->setIterationCallback(EventLoop::Functor());
+            removed.set_value();
+        });
+        removed.get_future().wait();
+    }
+
+    //没来得及执行的任务直接丢弃
+    for (auto& slot : slots_)
+    {
+        Task* task = nullptr;
+        while (slot->deque.steal(&task))
+        {
+            delete task;
+        }
+        for (Task* t : slot->inbox)
+        {
+            delete t;
+        }
+    }
+}
+
+void LoopExecutor::submit(Task task)
+{
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    Task* t = new Task(std::move(task));
+
+    Slot* slot = currentSlot();
+    if (slot != nullptr)
+    {
+        //本loop这一轮结束时就会执行 同时叫醒一个睡眠的loop来分担
+        slot->deque.push(t);
+        slot->queued.fetch_add(1, std::memory_order_relaxed);
+        wakeParked();
+        return;
+    }
+
+    slot = leastLoadedSlot();
+    {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->inbox.push_back(t);
+    }
+    slot->queued.fetch_add(1, std::memory_order_relaxed);
+    slot->parked.store(false, std::memory_order_relaxed);
+    slot->loop->wakeup();
+}
+
+size_t LoopExecutor::pending() const
+{
+    size_t n = 0;
+    for (auto& slot : slots_)
+    {
+        n += slot->queued.load(std::memory_order_relaxed);
+    }
+    return n;
+}
+
+LoopExecutor::Stats LoopExecutor::stats() const
+{
+    Stats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.executed = 0;
+    for (auto& slot : slots_)
+    {
+        stats.executed += slot->executed.load(std::memory_order_relaxed);
+    }
+    stats.stolen = stolen_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::vector<uint64_t> LoopExecutor::executedPerLoop() const
+{
+    std::vector<uint64_t> executed;
+    for (auto& slot : slots_)
+    {
+        executed.push_back(slot->executed.load(std::memory_order_relaxed));
+    }
+    return executed;
+}
+
+//在loop线程中 每轮IO处理完后调用
+void LoopExecutor::runTasks(Slot* slot)
+{
+    slot->parked.store(false, std::memory_order_relaxed);
+
+    std::vector<Task*> inbox;
+    {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        inbox.swap(slot->inbox);
+    }
+    for (Task* t : inbox)
+    {
+        slot->deque.push(t);
+    }
+
+    int64_t deadline = nowMicros() + kBudgetMicros;
+    bool drained = false;
+    while (true)
+    {
+        Task* task = nullptr;
+        bool stolen = false;
+        if (slot->deque.pop(&task))
+        {
+            slot->queued.fetch_sub(1, std::memory_order_relaxed);
+        }
+        else if (stealTask(slot, &task))
+        {
+            stolen = true;
+        }
+        else
+        {
+            drained = true;
+            break;
+        }
+
+        (*task)();
+        delete task;
+        slot->executed.fetch_add(1, std::memory_order_relaxed);
+        if (stolen)
+        {
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (nowMicros() >= deadline)
+        {
+            break;
+        }
+    }
+
+    if (!drained || slot->queued.load(std::memory_order_relaxed) > 0)
+    {
+        //还有任务 让别的loop来偷 自己不在poll中阻塞 先处理IO再接着执行
+        wakeParked();
+        slot->loop->wakeup();
+        return;
+    }
+
+    slot->parked.store(true, std::memory_order_seq_cst);
+    //park之前刚好有人放进了收件箱 它看到的parked还是false
+    if (slot->queued.load(std::memory_order_seq_cst) > 0)
+    {
+        slot->parked.store(false, std::memory_order_relaxed);
+        slot->loop->wakeup();
+    }
+}
+
+bool LoopExecutor::stealTask(Slot* thief, Task** task)
+{
+    size_t n = slots_.size();
+    size_t start = nextSlot_.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < n; ++i)
+    {
+        Slot* victim = slots_[(start + i) % n].get();
+        if (victim != thief && victim->deque.steal(task))
+        {
+            victim->queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+LoopExecutor::Slot* LoopExecutor::currentSlot() const
+{
+    for (auto& slot : slots_)
+    {
+        if (slot->loop->isInLoopThread())
+        {
+            return slot.get();
+        }
+    }
+    return nullptr;
+}
+
+//优先选睡眠中的loop 否则选排队任务最少的
+LoopExecutor::Slot* LoopExecutor::leastLoadedSlot()
+{
+    size_t n = slots_.size();
+    size_t start = nextSlot_.fetch_add(1, std::memory_order_relaxed);
+    Slot* best = nullptr;
+    for (size_t i = 0; i < n; ++i)
+    {
+        Slot* slot = slots_[(start + i) % n].get();
+        if (slot->parked.load(std::memory_order_relaxed))
+        {
+            return slot;
+        }
+        if (best == nullptr || slot->queued.load(std::memory_order_relaxed) < best->queued.load(std::memory_order_relaxed))
+        {
+            best = slot;
+        }
+    }
+    return best;
+}
+
+//叫醒一个睡眠中的loop
+void LoopExecutor::wakeParked()
+{
+    for (auto& slot : slots_)
+    {
+        if (slot->parked.load(std::memory_order_relaxed) && slot->parked.exchange(false))
+        {
+            slot->loop->wakeup();
+            return;
+        }
+    }
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "myMuduo/base/WorkStealingDeque.h"
+#include "myMuduo/base/noncopyable.h"
+
+namespace myMuduo {
+namespace net {
+
+class EventLoop;
+class EventLoopThreadPool;
+
+//用IO线程的空闲时间执行和连接无关的任务(缓存重算 压缩等)
+//每个loop一个Chase-Lev队列 loop每轮处理完IO后执行自己队列里的任务 自己的空了就去偷别的loop的
+//一轮最多执行kBudgetMicros 剩下的留到下一轮 不会让IO等太久
+//没事可做的loop在poll中睡眠 有任务可偷时被唤醒
+//必须在EventLoopThreadPool之前析构
+class LoopExecutor : noncopyable
+{
+public:
+    using Task = std::function<void()>;
+
+    struct Stats
+    {
+        uint64_t submitted;
+        uint64_t executed;
+        uint64_t stolen;  //由提交目标之外的loop执行的任务数
+    };
+
+    static const int64_t kBudgetMicros = 1000;
+
+    //threadPool必须已经start 在baseLoop线程中构造
+    explicit LoopExecutor(EventLoopThreadPool* threadPool);
+    ~LoopExecutor();
+
+    //任意线程调用
+    //在本executor的loop线程中提交时直接放进自己的队列 否则放进最空闲的loop的收件箱
+    void submit(Task task);
+
+    //还没执行的任务数 近似值
+    size_t pending() const;
+    size_t numLoops() const { return slots_.size(); }
+    Stats stats() const;
+
+    //每个loop执行的任务数 下标和EventLoopThreadPool::getAllLoops()一致
+    std::vector<uint64_t> executedPerLoop() const;
+
+private:
+    struct Slot
+    {
+        explicit Slot(EventLoop* l)
+            : loop(l)
+            , parked(false)
+            , queued(0)
+            , executed(0)
+        {
+        }
+
+        EventLoop* loop;
+        //只有loop线程push/pop 其他loop steal
+        base::WorkStealingDeque<Task*> deque;
+        //其他线程提交的任务先放在这里 loop线程再搬进deque
+        std::mutex mutex;
+        std::vector<Task*> inbox;
+        std::atomic<bool> parked;     //上一轮没有任务 在poll中睡眠
+        std::atomic<size_t> queued;   //inbox和deque中的任务数
+        std::atomic<uint64_t> executed;
+    };
+
+    void runTasks(Slot* slot);
+    bool stealTask(Slot* thief, Task** task);
+    Slot* currentSlot() const;
+    Slot* leastLoadedSlot();
+    void wakeParked();
+
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::atomic<size_t> nextSlot_;
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> stolen_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,224 @@
+#include "myMuduo/net/LoopMetrics.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace myMuduo {
+namespace net {
+
+namespace {
+
+const char* const kCounterNames[] = {"bytes_read",   "bytes_written", "messages", "accepts", "closes",
+                                     "epoll_wakeups", "events",       "functors", "timers"};
+
+const char* const kCounterHelps[] = {"Bytes read from sockets",
+                                     "Bytes written to sockets",
+                                     "Message callbacks invoked",
+                                     "Connections accepted",
+                                     "Connections closed",
+                                     "epoll_wait returns",
+                                     "Active channels handled",
+                                     "Pending functors executed",
+                                     "Timers fired"};
+
+static_assert(sizeof(kCounterNames) / sizeof(kCounterNames[0]) == LoopMetrics::kNumCounters,
+              "counter names out of sync");
+const char* const kActivityNames[] = {"idle", "read", "write", "close", "error", "timer", "functor", "iteration"};
+
+static_assert(sizeof(kActivityNames) / sizeof(kActivityNames[0]) == LoopMetrics::kNumActivities,
+              "activity names out of sync");
+static_assert(sizeof(kCounterHelps) / sizeof(kCounterHelps[0]) == LoopMetrics::kNumCounters,
+              "counter helps out of sync");
+
+std::string labels(const LoopMetrics::Snapshot& snapshot)
+{
+    std::string escaped;
+    for (char c : snapshot.loopName)
+    {
+        if (c == '\\' || c == '"')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return "loop=\"" + escaped + "\",tid=\"" + std::to_string(snapshot.tid) + "\"";
+}
+
+void appendNumber(std::string* out, double value)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", value);
+    *out += buf;
+}
+
+//每个2的幂输出一个桶 包含小于2^k的值 le标成其中最大的值2^k-1 和Prometheus的小于等于一致
+//scale把记录的单位换成输出的单位
+void appendHistogram(std::string* out, const std::string& name, const std::string& label,
+                     const base::Histogram::Snapshot& histogram, double scale)
+{
+    uint64_t total = 0;
+    for (uint64_t n : histogram.buckets)
+    {
+        total += n;
+    }
+
+    uint64_t cumulative = 0;
+    int next = 0;
+    for (int k = 0; k < 63 && cumulative < total; ++k)
+    {
+        int end = base::Histogram::bucketIndex(static_cast<int64_t>(1) << k);
+        for (; next < end; ++next)
+        {
+            cumulative += histogram.buckets[next];
+        }
+        *out += name + "_bucket{" + label + ",le=\"";
+        appendNumber(out, static_cast<double>(base::Histogram::bucketUpperBound(end - 1)) * scale);
+        *out += "\"} " + std::to_string(cumulative) + "\n";
+    }
+    *out += name + "_bucket{" + label + ",le=\"+Inf\"} " + std::to_string(total) + "\n";
+    *out += name + "_sum{" + label + "} ";
+    appendNumber(out, static_cast<double>(histogram.sum) * scale);
+    *out += "\n";
+    *out += name + "_count{" + label + "} " + std::to_string(total) + "\n";
+}
+
+}  // namespace
+
+LoopMetrics::Snapshot::Snapshot()
+    : tid(0)
+{
+    std::fill(counters, counters + kNumCounters, 0);
+}
+
+void LoopMetrics::Snapshot::merge(const Snapshot& other)
+{
+    for (int i = 0; i < kNumCounters; ++i)
+    {
+        counters[i] += other.counters[i];
+    }
+    busyMicros.merge(other.busyMicros);
+    functorBatch.merge(other.functorBatch);
+}
+
+LoopMetrics::LoopMetrics(const std::string& loopName, pid_t tid)
+    : activity_(static_cast<uint64_t>(kInPoll) << 32 | static_cast<uint32_t>(-1))
+    , activitySeq_(0)
+    , loopName_(loopName)
+    , tid_(tid)
+{
+    for (int i = 0; i < kNumCounters; ++i)
+    {
+        counters_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+LoopMetrics::Snapshot LoopMetrics::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.loopName = loopName_;
+    snapshot.tid = tid_;
+    for (int i = 0; i < kNumCounters; ++i)
+    {
+        snapshot.counters[i] = counters_[i].load(std::memory_order_relaxed);
+    }
+    snapshot.busyMicros = busyMicros_.snapshot();
+    snapshot.functorBatch = functorBatch_.snapshot();
+    return snapshot;
+}
+
+void LoopMetrics::getActivity(uint64_t* seq, Activity* activity, int* fd) const
+{
+    //两个值不是一起读的 可能读到下一个回调的activity 只用于诊断 下一次检查时seq就变了
+    *seq = activitySeq_.load(std::memory_order_acquire);
+    uint64_t value = activity_.load(std::memory_order_relaxed);
+    *activity = static_cast<Activity>(value >> 32);
+    *fd = static_cast<int>(static_cast<uint32_t>(value));
+}
+
+const char* LoopMetrics::counterName(Counter counter) { return kCounterNames[counter]; }
+
+const char* LoopMetrics::activityName(Activity activity) { return kActivityNames[activity]; }
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+void MetricsRegistry::add(LoopMetrics* metrics)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.push_back(metrics);
+}
+
+void MetricsRegistry::remove(LoopMetrics* metrics)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.erase(std::remove(metrics_.begin(), metrics_.end(), metrics), metrics_.end());
+}
+
+std::vector<LoopMetrics::Snapshot> MetricsRegistry::snapshot()
+{
+    //持有锁期间EventLoop无法析构 LoopMetrics一直有效
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<LoopMetrics::Snapshot> snapshots;
+    snapshots.reserve(metrics_.size());
+    for (LoopMetrics* metrics : metrics_)
+    {
+        snapshots.push_back(metrics->snapshot());
+    }
+    return snapshots;
+}
+
+LoopMetrics::Snapshot MetricsRegistry::total()
+{
+    LoopMetrics::Snapshot total;
+    total.loopName = "all";
+    for (const LoopMetrics::Snapshot& snapshot : snapshot())
+    {
+        total.merge(snapshot);
+    }
+    return total;
+}
+
+void MetricsRegistry::forEach(const std::function<void(const LoopMetrics&)>& func)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (LoopMetrics* metrics : metrics_)
+    {
+        func(*metrics);
+    }
+}
+
+std::string MetricsRegistry::toPrometheus()
+{
+    std::vector<LoopMetrics::Snapshot> snapshots = snapshot();
+    std::string out;
+    for (int i = 0; i < LoopMetrics::kNumCounters; ++i)
+    {
+        std::string name = std::string("mymuduo_") + kCounterNames[i] + "_total";
+        out += "# HELP " + name + " " + kCounterHelps[i] + "\n";
+        out += "# TYPE " + name + " counter\n";
+        for (const LoopMetrics::Snapshot& snapshot : snapshots)
+        {
+            out += name + "{" + labels(snapshot) + "} " + std::to_string(snapshot.counters[i]) + "\n";
+        }
+    }
+
+    out += "# HELP mymuduo_loop_busy_seconds Time from epoll_wait return to the end of the loop iteration\n";
+    out += "# TYPE mymuduo_loop_busy_seconds histogram\n";
+    for (const LoopMetrics::Snapshot& snapshot : snapshots)
+    {
+        appendHistogram(&out, "mymuduo_loop_busy_seconds", labels(snapshot), snapshot.busyMicros, 1e-6);
+    }
+
+    out += "# HELP mymuduo_loop_functor_batch Pending functors executed per loop iteration\n";
+    out += "# TYPE mymuduo_loop_functor_batch histogram\n";
+    for (const LoopMetrics::Snapshot& snapshot : snapshots)
+    {
+        appendHistogram(&out, "mymuduo_loop_functor_batch", labels(snapshot), snapshot.functorBatch, 1);
+    }
+    return out;
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <sys/types.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "myMuduo/base/Histogram.h"
+#include "myMuduo/base/noncopyable.h"
+
+namespace myMuduo {
+namespace net {
+
+//每个EventLoop一份的计数器和直方图 以及loop当前正在执行的回调 只在loop线程中写 其他线程随时可以snapshot
+//计数器是relaxed原子变量 用load+store累加 和普通变量一样没有lock前缀
+//前后留出cache line 和堆上相邻的对象不共享cache line
+class LoopMetrics : noncopyable
+{
+public:
+    enum Counter
+    {
+        kBytesRead,
+        kBytesWritten,
+        kMessages,  //messageCallback的调用次数
+        kAccepts,
+        kCloses,
+        kWakeups,   //epoll_wait返回的次数
+        kEvents,    //活跃的Channel数
+        kFunctors,  //执行的pendingFunctors数
+        kTimers,    //到期的定时器数
+        kNumCounters
+    };
+
+    //loop当前在做什么 给LoopWatchdog定位卡住的回调
+    enum Activity
+    {
+        kInPoll,  //阻塞在epoll_wait或者忙等
+        kInRead,
+        kInWrite,
+        kInClose,
+        kInError,
+        kInTimer,
+        kInFunctors,
+        kInIterationCallback,
+        kNumActivities
+    };
+
+    struct Snapshot
+    {
+        Snapshot();
+
+        //把其他loop的数据加进来 loopName和tid不变
+        void merge(const Snapshot& other);
+
+        std::string loopName;
+        pid_t tid;
+        uint64_t counters[kNumCounters];
+        base::Histogram::Snapshot busyMicros;
+        base::Histogram::Snapshot functorBatch;
+    };
+
+    LoopMetrics(const std::string& loopName, pid_t tid);
+
+    void add(Counter counter, uint64_t n = 1)
+    {
+        counters_[counter].store(counters_[counter].load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    uint64_t get(Counter counter) const { return counters_[counter].load(std::memory_order_relaxed); }
+
+    //一轮循环中 从poll返回到处理完IO事件和pendingFunctors的微秒数
+    base::Histogram& busyMicros() { return busyMicros_; }
+    //每轮循环执行的pendingFunctors个数 即任务队列的深度
+    base::Histogram& functorBatch() { return functorBatch_; }
+
+    //每次切换回调时调用 几次普通的store 不读时钟
+    void setActivity(Activity activity, int fd = -1)
+    {
+        activity_.store((static_cast<uint64_t>(activity) << 32) | static_cast<uint32_t>(fd), std::memory_order_relaxed);
+        activitySeq_.store(activitySeq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    //seq每次setActivity加一 seq没变说明还在执行同一个回调
+    void getActivity(uint64_t* seq, Activity* activity, int* fd) const;
+
+    Snapshot snapshot() const;
+    const std::string& loopName() const { return loopName_; }
+    pid_t tid() const { return tid_; }
+
+    static const char* counterName(Counter counter);
+    static const char* activityName(Activity activity);
+
+private:
+    static const size_t kCacheLineSize = 64;
+
+    char pad0_[kCacheLineSize];
+    std::atomic<uint64_t> counters_[kNumCounters];
+    base::Histogram busyMicros_;
+    base::Histogram functorBatch_;
+    std::atomic<uint64_t> activity_;  //高32位Activity 低32位fd
+    std::atomic<uint64_t> activitySeq_;
+    const std::string loopName_;
+    const pid_t tid_;
+    char pad1_[kCacheLineSize];
+};
+
+//所有EventLoop的LoopMetrics 在EventLoop构造和析构时登记和注销
+class MetricsRegistry : noncopyable
+{
+public:
+    static MetricsRegistry& instance();
+
+    void add(LoopMetrics* metrics);
+    void remove(LoopMetrics* metrics);
+
+    //每个loop一项 按登记顺序
+    std::vector<LoopMetrics::Snapshot> snapshot();
+    //所有loop合并后的结果
+    LoopMetrics::Snapshot total();
+    //持有锁依次访问各个loop的LoopMetrics 期间loop不会析构
+    void forEach(const std::function<void(const LoopMetrics&)>& func);
+
+    //Prometheus文本格式 计数器和直方图都带loop和tid标签
+    std::string toPrometheus();
+
+private:
+    MetricsRegistry() = default;
+
+    std::mutex mutex_;
+    std::vector<LoopMetrics*> metrics_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
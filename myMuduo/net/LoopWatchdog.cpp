@@ -0,0 +1,111 @@
+#include "myMuduo/net/LoopWatchdog.h"
+#include <chrono>
+#include "myMuduo/base/Timestamp.h"
+#include "myMuduo/net/LoopMetrics.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+LoopWatchdog::LoopWatchdog(double thresholdSeconds)
+    : thresholdMicros_(static_cast<int64_t>(thresholdSeconds * Timestamp::kMicroSecondsPerSecond))
+    , stalls_(0)
+    , running_(false)
+{
+    if (thresholdMicros_ <= 0)
+    {
+        spdlog::critical("LoopWatchdog::LoopWatchdog() - threshold must be positive, got {}", thresholdSeconds);
+        abort();
+    }
+}
+
+LoopWatchdog::~LoopWatchdog() { stop(); }
+
+void LoopWatchdog::start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_)
+    {
+        return;
+    }
+    running_ = true;
+    threadPtr_.reset(new base::Thread([this]() { threadFunc(); }, "loop-watchdog"));
+    threadPtr_->start();
+}
+
+void LoopWatchdog::stop()
+{
+    std::unique_ptr<base::Thread> thread;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_)
+        {
+            return;
+        }
+        running_ = false;
+        thread.swap(threadPtr_);
+    }
+    cond_.notify_all();
+    thread->join();
+}
+
+void LoopWatchdog::threadFunc()
+{
+    std::chrono::microseconds interval(thresholdMicros_ / 4 > 0 ? thresholdMicros_ / 4 : 1);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_)
+    {
+        cond_.wait_for(lock, interval);
+        if (!running_)
+        {
+            break;
+        }
+        lock.unlock();
+        check(Timestamp::now().microSecondsSinceEpoch());
+        lock.lock();
+    }
+}
+
+void LoopWatchdog::check(int64_t nowMicros)
+{
+    std::map<const LoopMetrics*, LoopState> states;
+    MetricsRegistry::instance().forEach([&](const LoopMetrics& metrics) {
+        uint64_t seq = 0;
+        LoopMetrics::Activity activity = LoopMetrics::kInPoll;
+        int fd = -1;
+        metrics.getActivity(&seq, &activity, &fd);
+
+        //地址可能被新的EventLoop复用 tid不同就当作新的loop
+        auto it = states_.find(&metrics);
+        if (it == states_.end() || it->second.tid != metrics.tid())
+        {
+            states[&metrics] = LoopState{metrics.tid(), seq, nowMicros, false};
+            return;
+        }
+
+        LoopState state = it->second;
+        if (state.seq != seq)
+        {
+            if (state.reported)
+            {
+                spdlog::warn("LoopWatchdog - EventLoop {} (tid {}) resumed after at least {} ms", metrics.loopName(),
+                             metrics.tid(), (nowMicros - state.since) / 1000);
+            }
+            state = LoopState{metrics.tid(), seq, nowMicros, false};
+        }
+        else if (!state.reported && activity != LoopMetrics::kInPoll && nowMicros - state.since >= thresholdMicros_)
+        {
+            stalls_.fetch_add(1, std::memory_order_relaxed);
+            state.reported = true;
+            spdlog::warn("LoopWatchdog - EventLoop {} (tid {}) stalled for at least {} ms in {} callback, fd={}",
+                         metrics.loopName(), metrics.tid(), (nowMicros - state.since) / 1000,
+                         LoopMetrics::activityName(activity), fd);
+        }
+        states[&metrics] = state;
+    });
+    //已经析构的loop不再出现在新的states中
+    states_.swap(states);
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <sys/types.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "myMuduo/base/Thread.h"
+#include "myMuduo/base/noncopyable.h"
+
+namespace myMuduo {
+namespace net {
+
+class LoopMetrics;
+
+//EventLoop卡顿检测 后台线程每隔threshold/4检查一遍所有EventLoop
+//loop在切换回调时只记下当前的回调种类和fd(LoopMetrics::setActivity) 不读时钟
+//同一个回调持续超过threshold时打印loop名字 卡住的回调种类(read/write/functor/timer等)和Channel的fd
+//回调还没返回时就能发现 返回后再打印一次持续的时间
+//每轮循环耗时的分布见LoopMetrics::busyMicros
+//
+//  LoopWatchdog watchdog(0.1);
+//  watchdog.start();
+class LoopWatchdog : noncopyable
+{
+public:
+    explicit LoopWatchdog(double thresholdSeconds = 0.1);
+    ~LoopWatchdog();
+
+    void start();
+    void stop();
+
+    //发现的卡顿次数
+    uint64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+
+private:
+    struct LoopState
+    {
+        pid_t tid;
+        uint64_t seq;
+        int64_t since;  //第一次看到这个seq的时间
+        bool reported;
+    };
+
+    void threadFunc();
+    void check(int64_t nowMicros);
+
+    const int64_t thresholdMicros_;
+    std::map<const LoopMetrics*, LoopState> states_;  //只在检测线程中使用
+    std::atomic<uint64_t> stalls_;
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool running_;
+    std::unique_ptr<base::Thread> threadPtr_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "myMuduo/base/ThreadPool.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/TcpConnection.h"
+
+namespace myMuduo {
+namespace net {
+
+//把耗时的处理交给线程池 work()在strand上执行 返回值再通过runInLoop交给连接所在loop中的done(conn, result)
+//同一条连接用同一个strand 结果按提交顺序回到loop
+//连接在work执行前已经销毁就跳过 只持有weak_ptr 不延长连接的生命期
+//用法:
+//  auto strand = std::make_shared<base::Strand>(&pool); 保存在连接的context中
+//  offload(strand, conn, [req]() { return compute(req); },
+//          [](const TcpConnectionPtr& conn, std::string& result) { conn->send(result); });
+template <typename Work, typename Done>
+void offload(const std::shared_ptr<base::Strand>& strand, const TcpConnectionPtr& conn, Work work, Done done)
+{
+    using Result = typename std::decay<decltype(std::declval<Work&>()())>::type;
+    std::weak_ptr<TcpConnection> weakConn(conn);
+    strand->post([weakConn, work, done]() mutable {
+        if (weakConn.expired())
+        {
+            return;
+        }
+        std::shared_ptr<Result> result = std::make_shared<Result>(work());
+        TcpConnectionPtr guard = weakConn.lock();
+        if (!guard)
+        {
+            return;
+        }
+        //loop中的任务按入队顺序执行 strand保证了入队顺序
+        guard->getLoop()->runInLoop([guard, result, done]() mutable { done(guard, *result); });
+    });
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,72 @@
+#include "myMuduo/net/SendQueue.h"
+#include <cstring>
+#include <new>
+#include "myMuduo/net/Buffer.h"
+
+namespace myMuduo {
+namespace net {
+
+SendQueue::SendQueue()
+    : head_(nullptr)
+    , tail_(newNode(nullptr, 0))
+{
+    head_.store(tail_, std::memory_order_relaxed);
+}
+
+SendQueue::~SendQueue()
+{
+    //连接析构时可能还有没发出去的数据 连同哨兵一起释放
+    Node* node = tail_;
+    while (node != nullptr)
+    {
+        Node* next = node->next.load(std::memory_order_relaxed);
+        deleteNode(node);
+        node = next;
+    }
+}
+
+void SendQueue::push(const char* data, size_t len)
+{
+    Node* node = newNode(data, len);
+    //acq_rel 前一个生产者写入的节点内容对我们可见 我们的节点内容对下一个生产者可见
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    //从这里到下一行之间 消费者沿next走到prev就会停下
+    prev->next.store(node, std::memory_order_release);
+}
+
+size_t SendQueue::popAll(Buffer* output)
+{
+    size_t count = 0;
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    while (next != nullptr)
+    {
+        output->append(next->data(), next->length);
+        //next成为新的哨兵 它的数据已经取走了
+        deleteNode(tail_);
+        tail_ = next;
+        ++count;
+        next = tail_->next.load(std::memory_order_acquire);
+    }
+    return count;
+}
+
+SendQueue::Node* SendQueue::newNode(const char* data, size_t len)
+{
+    Node* node = new (::operator new(sizeof(Node) + len)) Node;
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->length = len;
+    if (len > 0)
+    {
+        ::memcpy(node->data(), data, len);
+    }
+    return node;
+}
+
+void SendQueue::deleteNode(Node* node)
+{
+    node->~Node();
+    ::operator delete(node);
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include "myMuduo/base/noncopyable.h"
+
+namespace myMuduo {
+namespace net {
+
+class Buffer;
+
+//TcpConnection的跨线程发送队列 多个生产者 消费者只有连接所属的loop线程
+//Vyukov的侵入式MPSC队列 push只有一次exchange 不加锁
+//每条消息只分配一次内存 节点头和数据放在一起
+class SendQueue : noncopyable
+{
+public:
+    SendQueue();
+    ~SendQueue();
+
+    //任意线程
+    void push(const char* data, size_t len);
+
+    //消费者线程 按放入顺序把数据追加到output 返回取出的消息数
+    //某个生产者exchange之后还没链接next时会在它前面停下 剩下的留给下一次popAll
+    size_t popAll(Buffer* output);
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next;
+        size_t length;
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    static Node* newNode(const char* data, size_t len);
+    static void deleteNode(Node* node);
+
+    std::atomic<Node*> head_;  //生产者端 最后放入的节点
+    Node* tail_;               //消费者端 已经取出的哨兵节点 tail_->next是下一条消息
+};
+
+}  // namespace net
+}  // namespace myMuduo
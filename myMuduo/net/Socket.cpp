@@ -74,7 +74,8 @@ int Socket::accept(InetAddress *peeraddr)
     struct sockaddr_in addr;
     memset(&addr, 0, sizeof(addr));
     socklen_t addrlen = sizeof(addr);
-    int connfd = ::accept(sockfd_, reinterpret_cast<struct sockaddr *>(&addr), &addrlen);
+    //连接fd必须是非阻塞的 否则发送缓冲区满时write会阻塞整个loop 高水位回调也永远不会触发
+    int connfd = ::accept4(sockfd_, reinterpret_cast<struct sockaddr *>(&addr), &addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
     if (connfd < 0)
     {
         spdlog::critical("Socket::accept error: {}", strerror(errno));
@@ -113,19 +114,67 @@ void Socket::setTcpNoDelay(bool on)
 void Socket::setReuseAddr(bool on)
 {
     int optval = on ? 1 : 0;
-    setsockopt(sockfd_, IPPROTO_TCP, SO_REUSEADDR, &optval, static_cast<socklen_t>(sizeof(optval)));
+    setsockopt(sockfd_, SOL_SOCKET, SO_REUSEADDR, &optval, static_cast<socklen_t>(sizeof(optval)));
 }
 
 void Socket::setReusePort(bool on)
 {
     int optval = on ? 1 : 0;
-    setsockopt(sockfd_, IPPROTO_TCP, SO_REUSEPORT, &optval, static_cast<socklen_t>(sizeof(optval)));
+    setsockopt(sockfd_, SOL_SOCKET, SO_REUSEPORT, &optval, static_cast<socklen_t>(sizeof(optval)));
 }
 
 void Socket::setKeepAlive(bool on)
 {
     int optval = on ? 1 : 0;
-    setsockopt(sockfd_, IPPROTO_TCP, SO_KEEPALIVE, &optval, static_cast<socklen_t>(sizeof(optval)));
+    setsockopt(sockfd_, SOL_SOCKET, SO_KEEPALIVE, &optval, static_cast<socklen_t>(sizeof(optval)));
+}
+
+bool Socket::setBusyPoll(int usec)
+{
+    return setsockopt(sockfd_, SOL_SOCKET, SO_BUSY_POLL, &usec, static_cast<socklen_t>(sizeof(usec))) == 0;
+}
+
+int createNonblockingOrDie(sa_family_t family)
+{
+    int sockfd = socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (sockfd < 0)
+    {
+        spdlog::critical("createNonblockingOrDie error: {}", strerror(errno));
+        abort();
+    }
+    return sockfd;
+}
+
+struct sockaddr_in getLocalAddr(int sockfd)
+{
+    struct sockaddr_in localaddr;
+    memset(&localaddr, 0, sizeof(localaddr));
+    socklen_t addrlen = sizeof(localaddr);
+    if (getsockname(sockfd, reinterpret_cast<struct sockaddr *>(&localaddr), &addrlen) < 0)
+    {
+        spdlog::critical("getLocalAddr - getsockname error: {}", strerror(errno));
+        abort();
+    }
+    return localaddr;
+}
+
+struct sockaddr_in getPeerAddr(int sockfd)
+{
+    struct sockaddr_in peeraddr;
+    memset(&peeraddr, 0, sizeof(peeraddr));
+    socklen_t addrlen = sizeof(peeraddr);
+    if (getpeername(sockfd, reinterpret_cast<struct sockaddr *>(&peeraddr), &addrlen) < 0)
+    {
+        spdlog::error("getPeerAddr - getpeername error: {}", strerror(errno));
+    }
+    return peeraddr;
+}
+
+bool isSelfConnect(int sockfd)
+{
+    struct sockaddr_in localaddr = getLocalAddr(sockfd);
+    struct sockaddr_in peeraddr = getPeerAddr(sockfd);
+    return localaddr.sin_port == peeraddr.sin_port && localaddr.sin_addr.s_addr == peeraddr.sin_addr.s_addr;
 }
 
 }  // namespace net
@@ -28,10 +28,19 @@ public:
     void setReuseAddr(bool on);
     void setReusePort(bool on);
     void setKeepAlive(bool on);
+    //SO_BUSY_POLL 阻塞读时在驱动队列上忙等usec微秒 超过net.core.busy_read需要CAP_NET_ADMIN
+    bool setBusyPoll(int usec);
 
 private:
     const int sockfd_;
 };
 
+//创建非阻塞的TCP socket 失败直接abort
+int createNonblockingOrDie(sa_family_t family);
+struct sockaddr_in getLocalAddr(int sockfd);
+struct sockaddr_in getPeerAddr(int sockfd);
+//非阻塞connect本机端口时 可能出现本端和对端地址相同的自连接
+bool isSelfConnect(int sockfd);
+
 }  // namespace net
 }  // namespace myMuduo
\ No newline at end of file
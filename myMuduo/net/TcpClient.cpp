@@ -0,0 +1,128 @@
+#include "myMuduo/net/TcpClient.h"
+#include <cassert>
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/Socket.h"
+#include "myMuduo/base/Logging.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+TcpClient::TcpClient(EventLoop* loop, const InetAddress& serverAddr, const std::string& name)
+    : loop_(loop)
+    , connectorPtr_(new Connector(loop, serverAddr))
+    , name_(name)
+    , connectionCallback_(defaultConnectionCallback)
+    , messageCallback_(defaultMessageCallback)
+    , writeCompleteCallback_()
+    , retry_(false)
+    , connect_(true)
+    , nextConnId_(1)
+{
+    if (loop_ == nullptr)
+    {
+        spdlog::critical("TcpClient::TcpClient - loop is nullptr");
+        abort();
+    }
+    connectorPtr_->setNewConnectionCallback([this](int sockfd) { this->newConnection(sockfd); });
+    MYMUDUO_LOG_DEBUG("TcpClient::TcpClient[{}] - connector {:p}", name_, static_cast<void*>(connectorPtr_.get()));
+}
+
+//TcpClient析构时连接可能还活着
+//连接的closeCallback原本会回调到TcpClient::removeConnection 需要替换成不依赖TcpClient的版本
+TcpClient::~TcpClient()
+{
+    TcpConnectionPtr conn;
+    bool unique = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        unique = connection_.use_count() == 1;
+        conn = connection_;
+    }
+
+    if (conn)
+    {
+        assert(loop_ == conn->getLoop());
+        EventLoop* loop = loop_;
+        loop_->runInLoop([conn, loop]() {
+            conn->setCloseCallback([loop](const TcpConnectionPtr& c) {
+                loop->queueInLoop([c]() { c->connectDestroyed(); });
+            });
+        });
+        //只有TcpClient持有该连接 没有人会再关闭它
+        if (unique)
+        {
+            conn->forceClose();
+        }
+    }
+    else
+    {
+        connectorPtr_->stop();
+    }
+}
+
+void TcpClient::connect()
+{
+    MYMUDUO_LOG_DEBUG("TcpClient::connect[{}] - connecting to {}", name_, connectorPtr_->serverAddress().toIpPort());
+    connect_ = true;
+    connectorPtr_->start();
+}
+
+void TcpClient::disconnect()
+{
+    connect_ = false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (connection_)
+    {
+        connection_->shutdown();
+    }
+}
+
+void TcpClient::stop()
+{
+    connect_ = false;
+    connectorPtr_->stop();
+}
+
+void TcpClient::newConnection(int sockfd)
+{
+    loop_->assertInLoopThread();
+    InetAddress peerAddr(getPeerAddr(sockfd));
+    InetAddress localAddr(getLocalAddr(sockfd));
+    std::string connName = name_ + "-" + peerAddr.toIpPort() + "-" + std::to_string(nextConnId_);
+    nextConnId_++;
+
+    TcpConnectionPtr conn(new TcpConnection(loop_, connName, sockfd, localAddr, peerAddr));
+    conn->setConnectionCallback(connectionCallback_);
+    conn->setMessageCallback(messageCallback_);
+    conn->setWriteCompleteCallback(writeCompleteCallback_);
+    conn->setCloseCallback([this](const TcpConnectionPtr& c) { this->removeConnection(c); });
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connection_ = conn;
+    }
+    conn->connectEstablished();
+}
+
+void TcpClient::removeConnection(const TcpConnectionPtr& conn)
+{
+    loop_->assertInLoopThread();
+    assert(loop_ == conn->getLoop());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        assert(connection_ == conn);
+        connection_.reset();
+    }
+
+    loop_->queueInLoop([conn]() { conn->connectDestroyed(); });
+    if (retry_ && connect_)
+    {
+        spdlog::info("TcpClient::removeConnection[{}] - reconnecting to {}", name_,
+                     connectorPtr_->serverAddress().toIpPort());
+        connectorPtr_->restart();
+    }
+}
+
+}  // namespace net
+}  // namespace myMuduo
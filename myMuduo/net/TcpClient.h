@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/Callback.h"
+#include "myMuduo/net/Connector.h"
+#include "myMuduo/net/TcpConnection.h"
+
+namespace myMuduo {
+namespace net {
+
+class EventLoop;
+
+//客户端 一个TcpClient只维护一条连接
+//连接的所有IO都在构造时传入的loop线程中处理
+class TcpClient : noncopyable
+{
+public:
+    TcpClient(EventLoop* loop, const InetAddress& serverAddr, const std::string& name);
+    ~TcpClient();
+
+    void connect();
+    void disconnect();
+    void stop();
+
+    TcpConnectionPtr connection()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return connection_;
+    }
+
+    EventLoop* getLoop() const { return loop_; }
+    bool retry() const { return retry_; }
+    //连接断开后自动重连
+    void enableRetry() { retry_ = true; }
+    const std::string& name() const { return name_; }
+
+    void setConnectionCallback(ConnectionCallback cb) { connectionCallback_ = std::move(cb); }
+    void setMessageCallback(MessageCallback cb) { messageCallback_ = std::move(cb); }
+    void setWriteCompleteCallback(WriteCompleteCallback cb) { writeCompleteCallback_ = std::move(cb); }
+
+private:
+    void newConnection(int sockfd);
+    void removeConnection(const TcpConnectionPtr& conn);
+
+    EventLoop* loop_;
+    ConnectorPtr connectorPtr_;
+    const std::string name_;
+    ConnectionCallback connectionCallback_;
+    MessageCallback messageCallback_;
+    WriteCompleteCallback writeCompleteCallback_;
+    std::atomic<bool> retry_;
+    std::atomic<bool> connect_;
+    int nextConnId_;  // 只在loop线程中使用
+    std::mutex mutex_;
+    TcpConnectionPtr connection_;  // 由mutex_保护
+};
+
+}  // namespace net
+}  // namespace myMuduo
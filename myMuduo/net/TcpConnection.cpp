@@ -1,19 +1,38 @@
 #include "myMuduo/net/TcpConnection.h"
 #include "TcpConnection.h"
 #include "myMuduo/net/Channel.h"
+#include "myMuduo/net/ConnectionSampler.h"
 #include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/LoopMetrics.h"
 #include "myMuduo/net/Socket.h"
+#include "myMuduo/base/Logging.h"
 #include "spdlog/spdlog.h"
 #include "myMuduo/base/WeakCallback.h"
 
 namespace myMuduo {
 namespace net {
+
+void defaultConnectionCallback(const TcpConnectionPtr& conn)
+{
+    MYMUDUO_LOG_DEBUG("{} -> {} is {}", conn->getLocalAddress().toIpPort(), conn->getPeerAddress().toIpPort(),
+                      conn->connected() ? "UP" : "DOWN");
+}
+
+void defaultMessageCallback(const TcpConnectionPtr&, Buffer* buffer, Timestamp)
+{
+    //没有设置消息回调时直接丢弃数据
+    buffer->retrieveAll();
+}
+
 TcpConnection::TcpConnection(EventLoop* loop, const std::string& name, int sockfd,
                              const InetAddress& localAddr, const InetAddress& peerAddr)
     : loop_(loop)
     , name_(name)
     , state_(kConnecting)
     , reading_(false)
+    , corked_(false)
+    , autoCork_(false)
+    , flushQueued_(false)
     , socketPtr_(new Socket(sockfd))
     , channelPtr_(new Channel(loop, sockfd))
     , localAddr_(localAddr)
@@ -27,28 +46,22 @@ TcpConnection::TcpConnection(EventLoop* loop, const std::string& name, int sockf
     , inputBuffer_()
     , outputBuffer_()
     , context_()
+    , stats_()
+    , sendQueue_()
+    , sendScheduled_(false)
 {
     channelPtr_->setReadCallback([this](Timestamp receiveTime) { handleRead(receiveTime); });
     channelPtr_->setWriteCallback([this]() { handleWrite(); });
     channelPtr_->setCloseCallback([this]() { handleClose(); });
     channelPtr_->setErrorCallback([this]() { handleError(); });
 
-    spdlog::debug("TcpConnection[{}] created, local address: {}, peer address: {}", name_,
-                  localAddr_.toIpPort(), peerAddr_.toIpPort());
+    MYMUDUO_LOG_DEBUG("TcpConnection[{}] created, local address: {}, peer address: {}", name_,
+                      localAddr_.toIpPort(), peerAddr_.toIpPort());
     socketPtr_->setKeepAlive(true);
 }
 
 TcpConnection::~TcpConnection() { assert(state_ == kDisconnected); }
 
-EventLoop* TcpConnection::getLoop() { return loop_; }
-
-const std::string& TcpConnection::getName() { return name_; }
-const InetAddress& TcpConnection::getLocalAddress() const { return localAddr_; }
-const InetAddress& TcpConnection::getPeerAddress() const { return peerAddr_; }
-
-bool TcpConnection::connected() const { return state_ == kConnected; }
-bool TcpConnection::disconnected() const { return state_ == kDisconnected; }
-
 bool TcpConnection::getTcpInfo(struct tcp_info* info) const { return socketPtr_->getTcpInfo(info); }
 
 const std::string TcpConnection::getTcpInfoString() const
@@ -62,9 +75,15 @@ void TcpConnection::send(const std::string& message)
 {
     if (state_ == kConnected)
     {
-        //按值传递捕获message，避免在发送过程中message被修改或销毁
-        auto self = shared_from_this();
-        loop_->runInLoop([self, message]() { self->sendInLoop(message); });
+        if (loop_->isInLoopThread())
+        {
+            sendInLoop(message.data(), message.size());
+        }
+        else
+        {
+            //拷贝进sendQueue_，避免在发送过程中message被修改或销毁
+            queueSend(message.data(), message.size());
+        }
     }
 }
 
@@ -72,9 +91,40 @@ void TcpConnection::send(Buffer* message)
 {
     if (state_ == kConnected)
     {
-        std::string str = message->retrieveAllAsString();
-        auto self = shared_from_this();
-        loop_->runInLoop([self, str]() { self->sendInLoop(str); });
+        //在loop线程中直接从Buffer发送 不经过string拷贝
+        if (loop_->isInLoopThread())
+        {
+            sendInLoop(message->peek(), message->readableBytesLength());
+            message->retrieveAll();
+        }
+        else
+        {
+            queueSend(message->peek(), message->readableBytesLength());
+            message->retrieveAll();
+        }
+    }
+}
+
+void TcpConnection::cork()
+{
+    loop_->assertInLoopThread();
+    corked_ = true;
+}
+
+void TcpConnection::uncork()
+{
+    loop_->assertInLoopThread();
+    corked_ = false;
+    flushOutput();
+}
+
+void TcpConnection::setAutoCork(bool on)
+{
+    loop_->assertInLoopThread();
+    autoCork_ = on;
+    if (!on)
+    {
+        flushOutput();
     }
 }
 
@@ -89,7 +139,7 @@ void TcpConnection::shutdown()
 }
 void TcpConnection::forceClose()
 {
-    if (state_ == kConnected || state_ == kConnecting)
+    if (state_ == kConnected || state_ == kDisconnecting)
     {
         setState(kDisconnecting);
         /*
@@ -137,6 +187,14 @@ void TcpConnection::forceCloseWithDelay(double seconds)
 }
 void TcpConnection::setTcpNoDelay(bool on) { socketPtr_->setTcpNoDelay(on); }
 
+void TcpConnection::setBusyPoll(int usec)
+{
+    if (!socketPtr_->setBusyPoll(usec))
+    {
+        MYMUDUO_LOG_WARN("TcpConnection::setBusyPoll() - {} SO_BUSY_POLL {} failed: {}", name_, usec, strerror(errno));
+    }
+}
+
 void TcpConnection::startRead()
 {
     auto self = shared_from_this();
@@ -148,10 +206,8 @@ void TcpConnection::stopRead()
     auto self = shared_from_this();
     loop_->runInLoop([self]() { self->stopReadInLoop(); });
 }
-bool TcpConnection::isReading() { return reading_; }
 
 void TcpConnection::setContext(const base::Any& context) { context_ = context; }
-const base::Any& TcpConnection::getContext() const { return context_; }
 
 void TcpConnection::setConnectionCallback(ConnectionCallback cb)
 {
@@ -173,9 +229,6 @@ void TcpConnection::setHighWaterMarkCallback(HighWaterMarkCallback cb, size_t hi
 
 void TcpConnection::setCloseCallback(CloseCallback cb) { closeCallback_ = std::move(cb); }
 
-Buffer* TcpConnection::getInputBuffer() { return &inputBuffer_; }
-Buffer* TcpConnection::getOutputBuffer() { return &outputBuffer_; }
-
 void TcpConnection::connectEstablished()
 {
     loop_->assertInLoopThread();
@@ -183,22 +236,27 @@ void TcpConnection::connectEstablished()
     setState(kConnected);
     channelPtr_->tie(shared_from_this());  // 绑定生命周期
     channelPtr_->enableReading();          // 启用读事件
+    loop_->connectionSampler().add(shared_from_this());
 
     connectionCallback_(shared_from_this());  // 调用连接回调
 
-    spdlog::debug("TcpConnection[{}] established, local address: {}, peer address: {}", name_,
-                  localAddr_.toIpPort(), peerAddr_.toIpPort());
+    MYMUDUO_LOG_DEBUG("TcpConnection[{}] established, local address: {}, peer address: {}", name_,
+                      localAddr_.toIpPort(), peerAddr_.toIpPort());
 }
 
 void TcpConnection::connectDestroyed()
 {
     loop_->assertInLoopThread();
-    if (state_ == kConnected)
+    //kDisconnecting: 已经shutdown但对端还没关闭时TcpServer被析构
+    if (state_ == kConnected || state_ == kDisconnecting)
     {
         setState(kDisconnected);
         channelPtr_->disableAll();                // 禁用所有事件
+        stats_.endBackpressure(Timestamp::now().microSecondsSinceEpoch());
+        loop_->metrics().add(LoopMetrics::kCloses);
         connectionCallback_(shared_from_this());  // 调用连接回调 处理连接断开逻辑
     }
+    loop_->connectionSampler().remove(this);
     channelPtr_->remove();
 }
 
@@ -210,14 +268,24 @@ void TcpConnection::handleRead(Timestamp receiveTime)
     loop_->assertInLoopThread();
     int saveErrno = 0;
     ssize_t n = inputBuffer_.readFd(socketPtr_->fd(), &saveErrno);
+    stats_.add(ConnectionStats::kReadCalls);
     if (n > 0)
     {
+        loop_->metrics().add(LoopMetrics::kBytesRead, static_cast<uint64_t>(n));
+        loop_->metrics().add(LoopMetrics::kMessages);
+        stats_.add(ConnectionStats::kBytesRead, static_cast<uint64_t>(n));
+        stats_.add(ConnectionStats::kMessages);
         messageCallback_(shared_from_this(), &inputBuffer_, receiveTime);
     }
     else if (n == 0)
     {
         handleClose();
     }
+    else if (saveErrno == EAGAIN)
+    {
+        //可读事件已经被消费(例如多个线程共享fd或者虚假唤醒) 不是错误
+        stats_.add(ConnectionStats::kEagains);
+    }
     else
     {
         errno = saveErrno;
@@ -237,14 +305,18 @@ void TcpConnection::handleWrite()
     if (channelPtr_->isWriting())
     {
         ssize_t n = write(channelPtr_->fd(), outputBuffer_.peek(), outputBuffer_.readableBytesLength());
+        stats_.add(ConnectionStats::kWriteCalls);
         if (n > 0)
         {
+            loop_->metrics().add(LoopMetrics::kBytesWritten, static_cast<uint64_t>(n));
+            stats_.add(ConnectionStats::kBytesWritten, static_cast<uint64_t>(n));
             outputBuffer_.retrieve(n);
             //判断数据是否发送完成
             if (outputBuffer_.readableBytesLength() == 0)
             {
                 //关闭可写事件关注 防止一直触发回调
                 channelPtr_->disableWriting();
+                stats_.endBackpressure(Timestamp::now().microSecondsSinceEpoch());
                 if (writeCompleteCallback_)
                 {
                     auto self = shared_from_this();
@@ -267,7 +339,7 @@ void TcpConnection::handleWrite()
     }
     else
     {
-        spdlog::warn("TcpConnection::handleWrite() - channel is not writing, fd: {}", channelPtr_->fd());
+        MYMUDUO_LOG_WARN("TcpConnection::handleWrite() - channel is not writing, fd: {}", channelPtr_->fd());
     }
 }
 void TcpConnection::handleClose()
@@ -276,6 +348,8 @@ void TcpConnection::handleClose()
     assert(state_ == kConnected || state_ == kDisconnecting);
     setState(kDisconnected);
     channelPtr_->disableAll();
+    stats_.endBackpressure(Timestamp::now().microSecondsSinceEpoch());
+    loop_->metrics().add(LoopMetrics::kCloses);
 
     TcpConnectionPtr guardThis(shared_from_this());
     connectionCallback_(guardThis);
@@ -285,32 +359,37 @@ void TcpConnection::handleClose()
 void TcpConnection::handleError()
 {
     int err = Socket::getSocketError(socketPtr_->fd());
-    spdlog::error("TcpConnection::handleError() - socket error: {}, fd: {}", strerror(err),
-                  socketPtr_->fd());
+    MYMUDUO_LOG_ERROR("TcpConnection::handleError() - socket error: {}, fd: {}", strerror(err),
+                      socketPtr_->fd());
 }
 
 //优先直接write到内核发送缓冲区
 //如果内核发送缓冲区满了 再将数据写入outputBuffer_
 //用handleWrite来处理可写事件
-void TcpConnection::sendInLoop(const std::string& message)
+void TcpConnection::sendInLoop(const char* data, size_t len)
 {
     loop_->assertInLoopThread();
-    size_t remaining = message.size();
+    size_t remaining = len;
     bool faultError = false;
     ssize_t n = 0;
     if (state_ == kDisconnected)
     {
-        spdlog::warn("TcpConnection::sendInLoop() - connection is disconnected, fd: {}", socketPtr_->fd());
+        MYMUDUO_LOG_WARN("TcpConnection::sendInLoop() - connection is disconnected, fd: {}", socketPtr_->fd());
         return;
     }
 
+    //cork期间不直接write 数据先积压在outputBuffer_
+    bool deferred = corked_ || autoCork_;
     //!channelPtr_->isWriting() 表示没有开启写事件 内核发送缓冲区有空间
     //outputBuffer_.readableBytesLength() == 0 应用层发送缓冲区是空的，没有积压任何待发送的数据
-    if (!channelPtr_->isWriting() && outputBuffer_.readableBytesLength() == 0)
+    if (!deferred && !channelPtr_->isWriting() && outputBuffer_.readableBytesLength() == 0)
     {
-        n = write(channelPtr_->fd(), message.data(), message.size());
+        n = write(channelPtr_->fd(), data, len);
+        stats_.add(ConnectionStats::kWriteCalls);
         if (n >= 0)
         {
+            loop_->metrics().add(LoopMetrics::kBytesWritten, static_cast<uint64_t>(n));
+            stats_.add(ConnectionStats::kBytesWritten, static_cast<uint64_t>(n));
             remaining -= n;
             if (remaining == 0 && writeCompleteCallback_)
             {
@@ -322,8 +401,12 @@ void TcpConnection::sendInLoop(const std::string& message)
         else
         {
             n = 0;  // 如果写入失败，重置n为0
+            if (errno == EWOULDBLOCK)
+            {
+                stats_.add(ConnectionStats::kEagains);
+            }
             //非缓冲区满的错误
-            if (errno != EWOULDBLOCK)
+            else
             {
                 if (errno == EPIPE || errno == ECONNRESET)
                 {
@@ -333,7 +416,7 @@ void TcpConnection::sendInLoop(const std::string& message)
         }
     }
 
-    assert(remaining <= message.size());
+    assert(remaining <= len);
     if (!faultError && remaining > 0)
     {
         size_t oldLen = outputBuffer_.readableBytesLength();
@@ -344,14 +427,108 @@ void TcpConnection::sendInLoop(const std::string& message)
                 self->highWaterMarkCallback_(self, oldLen + remaining);
             });
         }
-        outputBuffer_.append(message.data() + n, remaining);
-        if (!channelPtr_->isWriting())
+        outputBuffer_.append(data + n, remaining);
+        //已经开启写事件时由handleWrite一起发送
+        if (deferred && !channelPtr_->isWriting())
+        {
+            //显式cork的由uncork发送 自动cork的每轮只投递一次flushOutput
+            if (!corked_ && !flushQueued_)
+            {
+                flushQueued_ = true;
+                auto self = shared_from_this();
+                loop_->runAfterIteration([self]() {
+                    self->flushQueued_ = false;
+                    //投递之后又cork了 留给uncork一起发送
+                    if (!self->corked_)
+                    {
+                        self->flushOutput();
+                    }
+                });
+            }
+        }
+        else if (!channelPtr_->isWriting())
         {
             //如果没有开启写事件 则开启写事件
             channelPtr_->enableWriting();
-            spdlog::debug("TcpConnection[{}] - enable writing, fd: {}", name_, channelPtr_->fd());
+            stats_.beginBackpressure(Timestamp::now().microSecondsSinceEpoch());
+            MYMUDUO_LOG_DEBUG("TcpConnection[{}] - enable writing, fd: {}", name_, channelPtr_->fd());
+        }
+    }
+}
+
+//其他线程的send 不再为每条消息分配lambda和加loop的锁
+//sendScheduled_为true说明已经投递的flushSendQueue还没开始取数据 会把这条一起取走
+void TcpConnection::queueSend(const char* data, size_t len)
+{
+    sendQueue_.push(data, len);
+    if (!sendScheduled_.exchange(true, std::memory_order_acq_rel))
+    {
+        auto self = shared_from_this();
+        loop_->queueInLoop([self]() { self->flushSendQueue(); });
+    }
+}
+
+//一批数据合并成一次sendInLoop 通常只需要一次write
+void TcpConnection::flushSendQueue()
+{
+    loop_->assertInLoopThread();
+    //先清标记再取数据 之后放入的数据要么被这次取到 要么由它的生产者重新投递
+    //用exchange而不是store 和生产者的exchange构成同步 保证能看到exchange之前链接好的节点
+    sendScheduled_.exchange(false, std::memory_order_acq_rel);
+    Buffer batch;
+    sendQueue_.popAll(&batch);
+    if (batch.readableBytesLength() > 0)
+    {
+        sendInLoop(batch.peek(), batch.readableBytesLength());
+    }
+}
+
+//cork期间积压在outputBuffer_的数据 一次write发出 写不完再开启写事件交给handleWrite
+//outputBuffer_是连续的 一次write和把几次send的数据用writev写出效果相同
+void TcpConnection::flushOutput()
+{
+    loop_->assertInLoopThread();
+    if (state_ == kDisconnected || channelPtr_->isWriting() || outputBuffer_.readableBytesLength() == 0)
+    {
+        return;
+    }
+
+    ssize_t n = write(channelPtr_->fd(), outputBuffer_.peek(), outputBuffer_.readableBytesLength());
+    stats_.add(ConnectionStats::kWriteCalls);
+    if (n >= 0)
+    {
+        loop_->metrics().add(LoopMetrics::kBytesWritten, static_cast<uint64_t>(n));
+        stats_.add(ConnectionStats::kBytesWritten, static_cast<uint64_t>(n));
+        outputBuffer_.retrieve(n);
+    }
+    else if (errno == EWOULDBLOCK)
+    {
+        stats_.add(ConnectionStats::kEagains);
+    }
+    else
+    {
+        //EPIPE ECONNRESET等 连接随后由handleRead或handleError关闭
+        MYMUDUO_LOG_WARN("TcpConnection::flushOutput() - write error: {}, fd: {}", strerror(errno), channelPtr_->fd());
+        return;
+    }
+
+    if (outputBuffer_.readableBytesLength() == 0)
+    {
+        if (writeCompleteCallback_)
+        {
+            auto self = shared_from_this();
+            loop_->queueInLoop([self]() { self->writeCompleteCallback_(self); });
+        }
+        if (state_ == kDisconnecting)
+        {
+            shutdownInLoop();
         }
     }
+    else
+    {
+        channelPtr_->enableWriting();
+        stats_.beginBackpressure(Timestamp::now().microSecondsSinceEpoch());
+    }
 }
 
 //停止写数据 如果当前还在写数据，则不执行
@@ -361,13 +538,19 @@ void TcpConnection::shutdownInLoop()
     loop_->assertInLoopThread();
     if (!channelPtr_->isWriting())
     {
+        //cork积压的数据先发出去 发完后flushOutput或handleWrite会再调用这里
+        if (outputBuffer_.readableBytesLength() > 0)
+        {
+            flushOutput();
+            return;
+        }
         socketPtr_->shutdownWrite();
     }
 }
 void TcpConnection::forceCloseInLoop()
 {
     loop_->assertInLoopThread();
-    if (state_ == kConnected || state_ == kConnecting)
+    if (state_ == kConnected || state_ == kDisconnecting)
     {
         handleClose();
     }
@@ -376,7 +559,7 @@ void TcpConnection::forceCloseInLoop()
 void TcpConnection::setState(StateE s)
 {
     state_ = s;
-    spdlog::debug("TcpConnection[{}] - state changed to {}", name_, stateToString());
+    MYMUDUO_LOG_DEBUG("TcpConnection[{}] - state changed to {}", name_, stateToString());
 }
 
 std::string TcpConnection::stateToString()
@@ -403,7 +586,7 @@ void TcpConnection::startReadInLoop()
     {
         reading_ = true;
         channelPtr_->enableReading();  // 启用读事件
-        spdlog::debug("TcpConnection[{}] - start reading, fd: {}", name_, channelPtr_->fd());
+        MYMUDUO_LOG_DEBUG("TcpConnection[{}] - start reading, fd: {}", name_, channelPtr_->fd());
     }
 }
 void TcpConnection::stopReadInLoop()
@@ -1,11 +1,14 @@
 #pragma once
 #include <netinet/tcp.h>
+#include <atomic>
 #include <memory>
 #include "myMuduo/base/Any.h"
 #include "myMuduo/base/noncopyable.h"
 #include "myMuduo/net/Buffer.h"
 #include "myMuduo/net/Callback.h"
+#include "myMuduo/net/ConnectionStats.h"
 #include "myMuduo/net/InetAddress.h"
+#include "myMuduo/net/SendQueue.h"
 
 namespace myMuduo {
 namespace net {
@@ -19,28 +22,42 @@ public:
     TcpConnection(EventLoop* loop, const std::string& name, int sockfd,
                   const InetAddress& localAddr, const InetAddress& peerAddr);
     ~TcpConnection();
-    EventLoop* getLoop();
-    const std::string& getName();
-    const InetAddress& getLocalAddress() const;
-    const InetAddress& getPeerAddress() const;
-    bool connected() const;
-    bool disconnected() const;
+    //回调里每条消息都可能调用 定义在头文件中以便内联
+    EventLoop* getLoop() const { return loop_; }
+    const std::string& getName() const { return name_; }
+    const InetAddress& getLocalAddress() const { return localAddr_; }
+    const InetAddress& getPeerAddress() const { return peerAddr_; }
+    bool connected() const { return state_ == kConnected; }
+    bool disconnected() const { return state_ == kDisconnected; }
     bool getTcpInfo(struct tcp_info*) const;
     const std::string getTcpInfoString() const;
+    //本连接的流量计数 任意线程可读 TCP_INFO的周期采样见ConnectionSampler
+    const ConnectionStats& stats() const { return stats_; }
 
+    //其他线程调用时数据放进sendQueue_ 同一批数据只唤醒一次loop
     void send(const std::string& message);
     void send(Buffer* message);
+    //cork期间send只追加到outputBuffer_ uncork时一次write发出 只能在loop线程中调用
+    //一个响应分几次send时(响应头 消息体 尾部)用来减少小包和系统调用
+    void cork();
+    void uncork();
+    //打开后loop线程中的send都先积压 本轮IO事件和回调处理完后一次write发出 只能在loop线程中调用
+    void setAutoCork(bool on);
     void shutdown();
     void forceClose();
     void forceCloseWithDelay(double seconds);
     void setTcpNoDelay(bool on);
+    //配合EventLoop::setBusyPoll使用 失败时打印警告
+    void setBusyPoll(int usec);
 
     void startRead();
     void stopRead();
-    bool isReading();
+    bool isReading() const { return reading_; }
 
     void setContext(const base::Any& context);
-    const base::Any& getContext() const;
+    const base::Any& getContext() const { return context_; }
+    //需要原地修改context时使用 例如保存协议解析的中间状态
+    base::Any* getMutableContext() { return &context_; }
 
     void setConnectionCallback(ConnectionCallback cb);
     void setMessageCallback(MessageCallback cb);
@@ -48,8 +65,8 @@ public:
     void setHighWaterMarkCallback(HighWaterMarkCallback cb, size_t highWaterMark);
     void setCloseCallback(CloseCallback cb);
 
-    Buffer* getInputBuffer();
-    Buffer* getOutputBuffer();
+    Buffer* getInputBuffer() { return &inputBuffer_; }
+    Buffer* getOutputBuffer() { return &outputBuffer_; }
 
     void connectEstablished();
     void connectDestroyed();
@@ -68,7 +85,10 @@ private:
     void handleClose();
     void handleError();
 
-    void sendInLoop(const std::string& message);
+    void sendInLoop(const char* data, size_t len);
+    void queueSend(const char* data, size_t len);
+    void flushSendQueue();
+    void flushOutput();
     void shutdownInLoop();
     void forceCloseInLoop();
     void setState(StateE s);
@@ -78,8 +98,11 @@ private:
 
     EventLoop* loop_;
     const std::string name_;
-    StateE state_;
+    std::atomic<StateE> state_;  //send等函数会在其他线程读取
     bool reading_;
+    bool corked_;
+    bool autoCork_;
+    bool flushQueued_;  //已经runAfterIteration(flushOutput) 本轮还没执行
     std::unique_ptr<Socket> socketPtr_;
     std::unique_ptr<Channel> channelPtr_;
     const InetAddress localAddr_;
@@ -93,6 +116,9 @@ private:
     Buffer inputBuffer_;
     Buffer outputBuffer_;
     base::Any context_;
+    ConnectionStats stats_;
+    SendQueue sendQueue_;
+    std::atomic<bool> sendScheduled_;  //flushSendQueue已经投递还没开始取数据
 };
 
 }  // namespace net
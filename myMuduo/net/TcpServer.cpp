@@ -1,31 +1,20 @@
 #include "myMuduo/net/TcpServer.h"
 #include "TcpServer.h"
+#include "myMuduo/base/Logging.h"
+#include "myMuduo/net/LoopMetrics.h"
 #include "spdlog/spdlog.h"
 
 namespace myMuduo {
 namespace net {
 
-struct sockaddr_in getLocalAddr(int sockfd)
-{
-    struct sockaddr_in localaddr;
-    memset(&localaddr, 0, sizeof(localaddr));
-    socklen_t addrlen = sizeof(localaddr);
-    if (getsockname(sockfd, reinterpret_cast<struct sockaddr*>(&localaddr), &addrlen) < 0)
-    {
-        spdlog::critical("TcpServer::getLocalAddr - getsockname error: {}", strerror(errno));
-        abort();
-    }
-    return localaddr;
-}
-
 TcpServer::TcpServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name, Option option)
     : baseLoop_(loop)
     , name_(name)
     , ipPort_(listenAddr.toIpPort())
     , acceptorPtr_(new Acceptor(loop, listenAddr, option))
     , threadPoolPtr_(new EventLoopThreadPool(loop, name))
-    , connectionCallback_()
-    , messageCallback_()
+    , connectionCallback_(defaultConnectionCallback)
+    , messageCallback_(defaultMessageCallback)
     , writeCompleteCallback_()
     , threadInitCallback_()
     , started_(false)
@@ -80,7 +69,8 @@ void TcpServer::newConnection(int sockfd, const InetAddress& peerAddr)
     assert(sockfd >= 0);
     std::string connName = name_ + "-" + peerAddr.toIpPort() + "-" + std::to_string(nextConnId_);
     nextConnId_++;
-    spdlog::info("TcpServer::newConnection - new connection [{}] from {}", connName, peerAddr.toIpPort());
+    baseLoop_->metrics().add(LoopMetrics::kAccepts);
+    MYMUDUO_LOG_DEBUG("TcpServer::newConnection - new connection [{}] from {}", connName, peerAddr.toIpPort());
 
     EventLoop* ioLoop = threadPoolPtr_->getNextLoop();
     InetAddress localAddr(getLocalAddr(sockfd));
@@ -107,6 +97,7 @@ void TcpServer::removeConnectionInLoop(const TcpConnectionPtr& conn)
     baseLoop_->assertInLoopThread();
     size_t n = connections_.erase(conn->getName());
     assert(n == 1);
+    (void)n;  //NDEBUG时assert为空
     EventLoop* ioLoop = conn->getLoop();
     ioLoop->queueInLoop([conn]() { conn->connectDestroyed(); });
 }
@@ -0,0 +1,71 @@
+#include "myMuduo/net/codec/DelimiterCodec.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+const size_t DelimiterCodec::kDefaultMaxMessageLength;
+
+DelimiterCodec::DelimiterCodec(MessageViewCallback cb, const std::string& delimiter, size_t maxMessageLength)
+    : messageCallback_(std::move(cb))
+    , delimiter_(delimiter)
+    , isCRLF_(delimiter == "\r\n")
+    , maxMessageLength_(maxMessageLength)
+{
+    if (delimiter_.empty())
+    {
+        spdlog::critical("DelimiterCodec - delimiter must not be empty");
+        abort();
+    }
+}
+
+void DelimiterCodec::onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime)
+{
+    const char* end = nullptr;
+    while ((end = findDelimiter(buf)) != nullptr)
+    {
+        const char* data = buf->peek();
+        size_t length = static_cast<size_t>(end - data);
+        messageCallback_(conn, base::StringPiece(data, length), receiveTime);
+        buf->retrieve(length + delimiter_.size());
+    }
+
+    //找不到分隔符且数据已经超长 对端在发送非法数据
+    if (buf->readableBytesLength() > maxMessageLength_)
+    {
+        spdlog::error("DelimiterCodec::onMessage() - message too long, {} bytes without delimiter",
+                      buf->readableBytesLength());
+        buf->retrieveAll();
+        if (conn)
+        {
+            conn->shutdown();
+        }
+    }
+}
+
+void DelimiterCodec::encode(Buffer* buf, const base::StringPiece& message) const
+{
+    buf->append(message.data(), message.size());
+    buf->append(delimiter_.data(), delimiter_.size());
+}
+
+void DelimiterCodec::send(const TcpConnectionPtr& conn, const base::StringPiece& message) const
+{
+    Buffer buf;
+    encode(&buf, message);
+    conn->send(&buf);
+}
+
+const char* DelimiterCodec::findDelimiter(Buffer* buf) const
+{
+    if (isCRLF_)
+    {
+        return buf->findCRLF();
+    }
+    return buf->findDelimiter(delimiter_.data(), delimiter_.size());
+}
+
+}  // namespace net
+}  // namespace myMuduo
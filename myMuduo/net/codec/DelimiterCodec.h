@@ -0,0 +1,42 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include "myMuduo/base/StringPiece.h"
+#include "myMuduo/base/Timestamp.h"
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/Callback.h"
+
+namespace myMuduo {
+namespace net {
+
+//按分隔符切分消息 默认是\r\n 适用于Redis inline/SMTP这类按行的协议
+//回调拿到的消息不包含分隔符
+class DelimiterCodec : noncopyable
+{
+public:
+    //message指向inputBuffer_内部 只在回调期间有效
+    using MessageViewCallback =
+        std::function<void(const TcpConnectionPtr&, const base::StringPiece& message, Timestamp)>;
+
+    static const size_t kDefaultMaxMessageLength = 64 * 1024;
+
+    explicit DelimiterCodec(MessageViewCallback cb, const std::string& delimiter = "\r\n",
+                            size_t maxMessageLength = kDefaultMaxMessageLength);
+
+    void onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime);
+
+    void encode(Buffer* buf, const base::StringPiece& message) const;
+    void send(const TcpConnectionPtr& conn, const base::StringPiece& message) const;
+
+private:
+    const char* findDelimiter(Buffer* buf) const;
+
+    MessageViewCallback messageCallback_;
+    const std::string delimiter_;
+    const bool isCRLF_;
+    const size_t maxMessageLength_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
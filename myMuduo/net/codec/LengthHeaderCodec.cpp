@@ -0,0 +1,131 @@
+#include "myMuduo/net/codec/LengthHeaderCodec.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/Endian.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+const size_t LengthHeaderCodec::kDefaultMaxMessageLength;
+
+LengthHeaderCodec::LengthHeaderCodec(MessageViewCallback cb, size_t headerLength, Endian endian,
+                                     size_t maxMessageLength)
+    : messageCallback_(std::move(cb))
+    , headerLength_(headerLength)
+    , endian_(endian)
+    , maxMessageLength_(headerLength == 2 ? std::min<size_t>(maxMessageLength, 0xffff) : maxMessageLength)
+{
+    //长度头要能放进Buffer的预留空间
+    if (headerLength_ != 2 && headerLength_ != 4 && headerLength_ != 8)
+    {
+        spdlog::critical("LengthHeaderCodec - header length must be 2, 4 or 8, but got {}", headerLength_);
+        abort();
+    }
+}
+
+void LengthHeaderCodec::onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime)
+{
+    while (buf->readableBytesLength() >= headerLength_)
+    {
+        const char* data = buf->peek();
+        uint64_t length = decodeLength(data);
+        if (length > maxMessageLength_)
+        {
+            spdlog::error("LengthHeaderCodec::onMessage() - invalid length {}", length);
+            //丢掉非法数据 shutdown只是半关闭 对端还能继续发送 留着会让inputBuffer_无限增长
+            buf->retrieveAll();
+            if (conn)
+            {
+                conn->shutdown();
+            }
+            break;
+        }
+
+        //消息还没收全 等下次handleRead
+        if (buf->readableBytesLength() < headerLength_ + length)
+        {
+            break;
+        }
+
+        messageCallback_(conn, base::StringPiece(data + headerLength_, static_cast<size_t>(length)), receiveTime);
+        buf->retrieve(headerLength_ + static_cast<size_t>(length));
+    }
+}
+
+void LengthHeaderCodec::encode(Buffer* buf, const base::StringPiece& message) const
+{
+    assert(message.size() <= maxMessageLength_);
+    buf->append(message.data(), message.size());
+    char header[8];
+    encodeLength(message.size(), header);
+    buf->prepend(header, headerLength_);
+}
+
+void LengthHeaderCodec::send(const TcpConnectionPtr& conn, const base::StringPiece& message) const
+{
+    Buffer buf;
+    encode(&buf, message);
+    conn->send(&buf);
+}
+
+//用memcpy取出整数再转换字节序 不要求header地址对齐
+uint64_t LengthHeaderCodec::decodeLength(const char* header) const
+{
+    bool big = endian_ == kBigEndian;
+    switch (headerLength_)
+    {
+        case 2:
+        {
+            uint16_t v;
+            ::memcpy(&v, header, sizeof v);
+            return big ? sockets::networkToHost16(v) : le16toh(v);
+        }
+        case 4:
+        {
+            uint32_t v;
+            ::memcpy(&v, header, sizeof v);
+            return big ? sockets::networkToHost32(v) : le32toh(v);
+        }
+        default:
+        {
+            uint64_t v;
+            ::memcpy(&v, header, sizeof v);
+            return big ? sockets::networkToHost64(v) : le64toh(v);
+        }
+    }
+}
+
+void LengthHeaderCodec::encodeLength(uint64_t length, char* header) const
+{
+    bool big = endian_ == kBigEndian;
+    switch (headerLength_)
+    {
+        case 2:
+        {
+            uint16_t v = static_cast<uint16_t>(length);
+            v = big ? sockets::hostToNetwork16(v) : htole16(v);
+            ::memcpy(header, &v, sizeof v);
+            break;
+        }
+        case 4:
+        {
+            uint32_t v = static_cast<uint32_t>(length);
+            v = big ? sockets::hostToNetwork32(v) : htole32(v);
+            ::memcpy(header, &v, sizeof v);
+            break;
+        }
+        default:
+        {
+            uint64_t v = big ? sockets::hostToNetwork64(length) : htole64(length);
+            ::memcpy(header, &v, sizeof v);
+            break;
+        }
+    }
+}
+
+}  // namespace net
+}  // namespace myMuduo
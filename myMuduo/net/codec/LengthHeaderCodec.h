@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include "myMuduo/base/StringPiece.h"
+#include "myMuduo/base/Timestamp.h"
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/Callback.h"
+
+namespace myMuduo {
+namespace net {
+
+//消息格式: [长度头 2/4/8字节][消息体] 长度头只包含消息体的长度
+//一次onMessage会处理inputBuffer_里所有完整的消息 不拷贝消息体
+class LengthHeaderCodec : noncopyable
+{
+public:
+    enum Endian
+    {
+        kBigEndian,
+        kLittleEndian
+    };
+
+    //message指向inputBuffer_内部 只在回调期间有效 需要保存时自行拷贝
+    using MessageViewCallback =
+        std::function<void(const TcpConnectionPtr&, const base::StringPiece& message, Timestamp)>;
+
+    static const size_t kDefaultMaxMessageLength = 64 * 1024 * 1024;
+
+    explicit LengthHeaderCodec(MessageViewCallback cb, size_t headerLength = 4, Endian endian = kBigEndian,
+                               size_t maxMessageLength = kDefaultMaxMessageLength);
+
+    //可以直接作为TcpServer/TcpClient的MessageCallback
+    void onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime);
+
+    //把消息体追加到buf 长度头写到buf的预留空间里
+    void encode(Buffer* buf, const base::StringPiece& message) const;
+    void send(const TcpConnectionPtr& conn, const base::StringPiece& message) const;
+
+    size_t headerLength() const { return headerLength_; }
+
+private:
+    uint64_t decodeLength(const char* header) const;
+    void encodeLength(uint64_t length, char* header) const;
+
+    MessageViewCallback messageCallback_;
+    const size_t headerLength_;
+    const Endian endian_;
+    const size_t maxMessageLength_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
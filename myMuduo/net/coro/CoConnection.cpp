@@ -0,0 +1,228 @@
+#include "myMuduo/net/coro/CoConnection.h"
+#include <string.h>
+#include <cassert>
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/TcpConnection.h"
+
+namespace myMuduo {
+namespace net {
+namespace coro {
+
+const size_t CoConnection::kDefaultMaxLength;
+
+struct CoConnection::State
+{
+    enum ReadMode
+    {
+        kBytes,
+        kDelimiter
+    };
+
+    explicit State(const TcpConnectionPtr& conn)
+        : input(conn->getInputBuffer())
+        , output(conn->getOutputBuffer())
+        , mode(kBytes)
+        , want(0)
+        , maxLength(0)
+        , scanned(0)
+        , found(std::string::npos)
+        , closed(!conn->connected())
+        , detached(false)
+    {
+    }
+
+    //当前的读请求能否完成 连接关闭也算完成 关闭前已经收到的数据仍然可以读完
+    bool readReady()
+    {
+        size_t readable = input->readableBytesLength();
+        if (mode == kBytes)
+        {
+            return readable >= want || closed;
+        }
+
+        //从上次没找到的位置继续 不重复扫描
+        if (readable >= delimiter.size())
+        {
+            const char* data = input->peek();
+            const void* hit = memmem(data + scanned, readable - scanned, delimiter.data(), delimiter.size());
+            if (hit != nullptr)
+            {
+                found = static_cast<size_t>(static_cast<const char*>(hit) - data);
+                return true;
+            }
+            scanned = readable - delimiter.size() + 1;
+        }
+        return readable > maxLength || closed;
+    }
+
+    void handleClose()
+    {
+        if (detached || closed)
+        {
+            return;
+        }
+        closed = true;
+        if (reader)
+        {
+            resume(&reader);
+        }
+        else if (writer)
+        {
+            resume(&writer);
+        }
+    }
+
+    //先取出句柄 恢复的协程可能结束并销毁CoConnection
+    static void resume(std::coroutine_handle<>* handle)
+    {
+        std::coroutine_handle<> h = *handle;
+        *handle = nullptr;
+        h.resume();
+    }
+
+    Buffer* input;
+    Buffer* output;
+    ReadMode mode;
+    size_t want;
+    std::string delimiter;
+    size_t maxLength;
+    size_t scanned;
+    size_t found;
+    bool closed;
+    bool detached;  //CoConnection已经析构
+    std::coroutine_handle<> reader;
+    std::coroutine_handle<> writer;
+};
+
+CoConnection::CoConnection(const TcpConnectionPtr& conn)
+    : conn_(conn)
+    , state_(std::make_shared<State>(conn))
+    , consumed_(0)
+{
+    conn_->getLoop()->assertInLoopThread();
+    std::shared_ptr<State> state(state_);
+
+    conn_->setMessageCallback([state](const TcpConnectionPtr& c, Buffer* buf, Timestamp receiveTime) {
+        if (state->detached)
+        {
+            defaultMessageCallback(c, buf, receiveTime);
+        }
+        else if (state->reader && state->readReady())
+        {
+            State::resume(&state->reader);
+        }
+    });
+    //TcpConnection在数据写完后排队调用 期间可能又有新的write 所以要再检查一次outputBuffer
+    conn_->setWriteCompleteCallback([state](const TcpConnectionPtr&) {
+        if (!state->detached && state->writer && state->output->readableBytesLength() == 0)
+        {
+            State::resume(&state->writer);
+        }
+    });
+
+    //通常是在连接回调中构造的 这时不能替换正在执行的connectionCallback_ 推迟到本轮循环结束
+    //在这之前连接已经断开的话 安装时补上关闭处理
+    TcpConnectionPtr guard(conn_);
+    conn_->getLoop()->queueInLoop([guard, state]() {
+        if (state->detached)
+        {
+            return;
+        }
+        guard->setConnectionCallback([state](const TcpConnectionPtr& c) {
+            if (!c->connected())
+            {
+                state->handleClose();
+            }
+        });
+        if (!guard->connected())
+        {
+            state->handleClose();
+        }
+    });
+}
+
+CoConnection::~CoConnection()
+{
+    retrieveConsumed();
+    state_->detached = true;
+}
+
+CoConnection::ReadAwaiter CoConnection::read(size_t n)
+{
+    retrieveConsumed();
+    state_->mode = State::kBytes;
+    state_->want = n;
+    return ReadAwaiter(this);
+}
+
+CoConnection::ReadAwaiter CoConnection::readUntil(base::StringPiece delimiter, size_t maxLength)
+{
+    assert(!delimiter.empty());
+    retrieveConsumed();
+    state_->mode = State::kDelimiter;
+    state_->delimiter.assign(delimiter.data(), delimiter.size());
+    state_->maxLength = maxLength;
+    state_->scanned = 0;
+    state_->found = std::string::npos;
+    return ReadAwaiter(this);
+}
+
+CoConnection::WriteAwaiter CoConnection::write(const std::string& data)
+{
+    conn_->send(data);
+    return WriteAwaiter(this);
+}
+
+CoConnection::WriteAwaiter CoConnection::write(Buffer* data)
+{
+    conn_->send(data);
+    return WriteAwaiter(this);
+}
+
+bool CoConnection::connected() const { return !state_->closed; }
+
+void CoConnection::retrieveConsumed()
+{
+    if (consumed_ > 0)
+    {
+        state_->input->retrieve(consumed_);
+        consumed_ = 0;
+    }
+}
+
+bool CoConnection::readReady() { return state_->readReady(); }
+
+void CoConnection::suspendReader(std::coroutine_handle<> handle)
+{
+    assert(!state_->reader && !state_->writer);
+    state_->reader = handle;
+}
+
+base::StringPiece CoConnection::takeRead()
+{
+    State* state = state_.get();
+    const char* data = state->input->peek();
+    size_t readable = state->input->readableBytesLength();
+    if (state->mode == State::kBytes)
+    {
+        consumed_ = readable >= state->want ? state->want : 0;
+    }
+    else
+    {
+        consumed_ = state->found != std::string::npos ? state->found + state->delimiter.size() : 0;
+    }
+    return base::StringPiece(data, consumed_);
+}
+
+bool CoConnection::writeReady() { return state_->closed || state_->output->readableBytesLength() == 0; }
+
+void CoConnection::suspendWriter(std::coroutine_handle<> handle)
+{
+    assert(!state_->reader && !state_->writer);
+    state_->writer = handle;
+}
+
+}  // namespace coro
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "myMuduo/base/StringPiece.h"
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/Callback.h"
+
+namespace myMuduo {
+namespace net {
+
+class Buffer;
+
+namespace coro {
+
+//把TcpConnection包装成可以co_await的读写接口 在连接所在loop线程中使用 一般在连接建立的回调中spawn
+//构造时接管连接的message/writeComplete/connection回调 数据到达或写完时直接在loop线程中恢复协程
+//一条连接同一时刻只能有一个协程在等待
+//
+//  Task<void> session(TcpConnectionPtr conn)
+//  {
+//      CoConnection c(conn);
+//      while (true)
+//      {
+//          base::StringPiece line = co_await c.readUntil("\r\n");
+//          if (line.empty()) break;
+//          co_await c.write(line.toString());
+//      }
+//      conn->shutdown();
+//  }
+class CoConnection : noncopyable
+{
+public:
+    static const size_t kDefaultMaxLength = 64 * 1024;
+
+    class ReadAwaiter
+    {
+    public:
+        explicit ReadAwaiter(CoConnection* owner)
+            : owner_(owner)
+        {
+        }
+        bool await_ready() { return owner_->readReady(); }
+        void await_suspend(std::coroutine_handle<> handle) { owner_->suspendReader(handle); }
+        base::StringPiece await_resume() { return owner_->takeRead(); }
+
+    private:
+        CoConnection* owner_;
+    };
+
+    class WriteAwaiter
+    {
+    public:
+        explicit WriteAwaiter(CoConnection* owner)
+            : owner_(owner)
+        {
+        }
+        bool await_ready() { return owner_->writeReady(); }
+        void await_suspend(std::coroutine_handle<> handle) { owner_->suspendWriter(handle); }
+        bool await_resume() { return owner_->connected(); }
+
+    private:
+        CoConnection* owner_;
+    };
+
+    explicit CoConnection(const TcpConnectionPtr& conn);
+    //之后到达的数据按defaultMessageCallback丢弃 需要的话再给连接设置新的回调
+    ~CoConnection();
+
+    //恰好n个字节
+    //返回的视图指向inputBuffer 到下一次co_await之前有效 连接关闭时返回空
+    ReadAwaiter read(size_t n);
+    //读到delimiter为止 返回值包含delimiter
+    //连接关闭或者超过maxLength还没有找到时返回空
+    ReadAwaiter readUntil(base::StringPiece delimiter, size_t maxLength = kDefaultMaxLength);
+
+    //数据全部交给内核后恢复 返回false表示连接已经断开
+    WriteAwaiter write(const std::string& data);
+    WriteAwaiter write(Buffer* data);
+
+    bool connected() const;
+    const TcpConnectionPtr& connection() const { return conn_; }
+
+private:
+    struct State;
+
+    void retrieveConsumed();
+    bool readReady();
+    void suspendReader(std::coroutine_handle<> handle);
+    base::StringPiece takeRead();
+    bool writeReady();
+    void suspendWriter(std::coroutine_handle<> handle);
+
+    TcpConnectionPtr conn_;
+    //回调持有State 协程先结束时回调也不会访问已经销毁的CoConnection
+    std::shared_ptr<State> state_;
+    size_t consumed_;  //上一次读取返回的字节数 下一次读取前才从inputBuffer取走
+};
+
+}  // namespace coro
+}  // namespace net
+}  // namespace myMuduo
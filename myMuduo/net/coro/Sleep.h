@@ -0,0 +1,54 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include "myMuduo/net/EventLoop.h"
+
+namespace myMuduo {
+namespace net {
+namespace coro {
+
+//co_await sleep(loop, ms) 到期后在loop线程中恢复
+//每次等待由TimerQueue分配一个Timer 回调只捕获this和协程句柄 放得进std::function的内部存储
+//等待期间协程帧被销毁时 析构函数取消定时器 帧要在loop线程中销毁 否则取消会晚于到期
+class SleepAwaiter
+{
+public:
+    SleepAwaiter(EventLoop* loop, int64_t milliseconds)
+        : loop_(loop)
+        , milliseconds_(milliseconds)
+        , pending_(false)
+    {
+    }
+    ~SleepAwaiter()
+    {
+        if (pending_)
+        {
+            loop_->cancel(timerId_);
+        }
+    }
+
+    bool await_ready() const noexcept { return milliseconds_ <= 0; }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        pending_ = true;
+        timerId_ = loop_->runAfter(static_cast<double>(milliseconds_) / 1000.0, [this, handle]() {
+            //resume之后帧可能已经结束 不能再访问this
+            pending_ = false;
+            handle.resume();
+        });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    EventLoop* loop_;
+    int64_t milliseconds_;
+    bool pending_;  //定时器已经注册还没有到期
+    base::TimerId timerId_;
+};
+
+inline SleepAwaiter sleep(EventLoop* loop, int64_t milliseconds) { return SleepAwaiter(loop, milliseconds); }
+
+}  // namespace coro
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,171 @@
+#pragma once
+
+//C++20协程层 只在myMuduoCoro目标中编译 核心库仍然是C++11
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace myMuduo {
+namespace net {
+namespace coro {
+
+namespace detail {
+
+//协程结束时直接切换到等待它的协程 没有等待者就挂起在这里由Task析构时销毁
+struct FinalAwaiter
+{
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        std::coroutine_handle<> continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct PromiseBase
+{
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    //和其他回调一样不处理异常
+    void unhandled_exception() const noexcept { std::terminate(); }
+
+    std::coroutine_handle<> continuation;
+};
+
+}  // namespace detail
+
+//惰性启动的协程 被co_await时才开始执行 结束时恢复等待者
+//只能移动 T需要能默认构造
+template <typename T = void>
+class Task
+{
+public:
+    struct promise_type : detail::PromiseBase
+    {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_value(T v) { value = std::move(v); }
+
+        T value;
+    };
+
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr))
+    {
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            bool await_ready() const noexcept { return handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+            {
+                handle.promise().continuation = caller;
+                return handle;
+            }
+            T await_resume() { return std::move(handle.promise().value); }
+
+            std::coroutine_handle<promise_type> handle;
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : handle_(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <>
+class Task<void>
+{
+public:
+    struct promise_type : detail::PromiseBase
+    {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_void() const noexcept {}
+    };
+
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr))
+    {
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            bool await_ready() const noexcept { return handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+            {
+                handle.promise().continuation = caller;
+                return handle;
+            }
+            void await_resume() const noexcept {}
+
+            std::coroutine_handle<promise_type> handle;
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : handle_(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+//立即开始执行 结束时自己销毁
+struct Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+inline Detached runDetached(Task<void> task) { co_await std::move(task); }
+
+}  // namespace detail
+
+//在当前线程中启动一个顶层协程 一般在loop线程中调用 例如在连接建立的回调中
+//运行到第一个挂起点时返回 之后由loop中的事件恢复
+inline void spawn(Task<void> task) { detail::runDetached(std::move(task)); }
+
+}  // namespace coro
+}  // namespace net
+}  // namespace myMuduo
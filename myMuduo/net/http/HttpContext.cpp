@@ -0,0 +1,226 @@
+#include "myMuduo/net/http/HttpContext.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "myMuduo/base/ByteSearch.h"
+#include "myMuduo/base/StringUtil.h"
+#include "myMuduo/net/Buffer.h"
+
+namespace myMuduo {
+namespace net {
+
+const size_t HttpContext::kMaxLineLength;
+const size_t HttpContext::kMaxHeaderBytes;
+const size_t HttpContext::kDefaultMaxBodyLength;
+
+HttpContext::HttpContext(size_t maxBodyLength)
+    : state_(kExpectRequestLine)
+    , parsedBytes_(0)
+    , scannedBytes_(0)
+    , bodyLength_(0)
+    , maxBodyLength_(maxBodyLength)
+    , errorCode_(HttpResponse::kUnknown)
+{
+}
+
+bool HttpContext::parseRequest(Buffer* buf, Timestamp receiveTime)
+{
+    //偏移都相对于peek() Buffer内部搬移数据不影响已经记录的结果
+    const char* data = buf->peek();
+    const char* end = data + buf->readableBytesLength();
+
+    while (state_ == kExpectRequestLine || state_ == kExpectHeaders)
+    {
+        const char* lineStart = data + parsedBytes_;
+        //上次没找到时最后一个字节可能是'\r' 所以scannedBytes_停在它上面
+        const char* crlf = base::findCRLF(data + std::max(parsedBytes_, scannedBytes_), end);
+        if (crlf == nullptr)
+        {
+            if (static_cast<size_t>(end - lineStart) > kMaxLineLength)
+            {
+                return fail(HttpResponse::k431RequestHeaderFieldsTooLarge);
+            }
+            scannedBytes_ = end > lineStart ? static_cast<size_t>(end - data) - 1 : parsedBytes_;
+            break;
+        }
+
+        size_t lineLength = static_cast<size_t>(crlf - lineStart);
+        if (lineLength > kMaxLineLength || parsedBytes_ + lineLength + 2 > kMaxHeaderBytes)
+        {
+            return fail(HttpResponse::k431RequestHeaderFieldsTooLarge);
+        }
+
+        if (state_ == kExpectRequestLine)
+        {
+            if (!processRequestLine(lineStart, crlf))
+            {
+                return fail(HttpResponse::k400BadRequest);
+            }
+            request_.setReceiveTime(receiveTime);
+            state_ = kExpectHeaders;
+        }
+        else if (lineLength == 0)
+        {
+            //空行 头部结束
+            if (!processHeadersEnd(data))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            const char* colon = static_cast<const char*>(memchr(lineStart, ':', lineLength));
+            if (colon == nullptr || colon == lineStart || !processHeader(lineStart, colon, crlf))
+            {
+                return fail(HttpResponse::k400BadRequest);
+            }
+        }
+        parsedBytes_ += lineLength + 2;
+    }
+
+    //body收全之后才算完整 视图直接指向Buffer
+    if (state_ == kExpectBody && buf->readableBytesLength() >= parsedBytes_ + bodyLength_)
+    {
+        request_.setBody(base::makeSlice(data, data + parsedBytes_, data + parsedBytes_ + bodyLength_));
+        parsedBytes_ += bodyLength_;
+        state_ = kGotAll;
+    }
+
+    if (state_ == kGotAll)
+    {
+        request_.setBase(data);
+    }
+    return state_ != kError;
+}
+
+void HttpContext::consume(Buffer* buf)
+{
+    assert(state_ == kGotAll);
+    buf->retrieve(parsedBytes_);
+    reset();
+}
+
+void HttpContext::reset()
+{
+    state_ = kExpectRequestLine;
+    request_.reset();
+    parsedBytes_ = 0;
+    scannedBytes_ = 0;
+    bodyLength_ = 0;
+    errorCode_ = HttpResponse::kUnknown;
+}
+
+void HttpContext::startStream(const HttpResponse::BodyProducer& producer, bool chunked, bool close)
+{
+    streamPtr_ = std::make_shared<Stream>();
+    streamPtr_->producer = producer;
+    streamPtr_->chunked = chunked;
+    streamPtr_->close = close;
+    streamPtr_->paused = false;
+}
+
+//METHOD SP path[?query] SP HTTP/1.x
+bool HttpContext::processRequestLine(const char* begin, const char* end)
+{
+    const char* data = begin - parsedBytes_;
+    const char* space = std::find(begin, end, ' ');
+    if (space == end || !request_.setMethod(begin, space))
+    {
+        return false;
+    }
+
+    const char* start = space + 1;
+    space = std::find(start, end, ' ');
+    if (space == end || space == start)
+    {
+        return false;
+    }
+    const char* question = std::find(start, space, '?');
+    request_.setPath(base::makeSlice(data, start, question));
+    if (question != space)
+    {
+        request_.setQuery(base::makeSlice(data, question + 1, space));
+    }
+
+    start = space + 1;
+    if (end - start != 8 || !std::equal(start, end - 1, "HTTP/1."))
+    {
+        return false;
+    }
+    if (*(end - 1) == '1')
+    {
+        request_.setVersion(HttpRequest::kHttp11);
+    }
+    else if (*(end - 1) == '0')
+    {
+        request_.setVersion(HttpRequest::kHttp10);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+//[begin, colon)是字段名 colon之后去掉首尾空白是字段值
+bool HttpContext::processHeader(const char* begin, const char* colon, const char* end)
+{
+    const char* data = begin - parsedBytes_;
+    const char* value = colon + 1;
+    while (value < end && (*value == ' ' || *value == '\t'))
+    {
+        ++value;
+    }
+    while (end > value && (end[-1] == ' ' || end[-1] == '\t'))
+    {
+        --end;
+    }
+    return request_.addHeader(base::makeSlice(data, begin, colon), base::makeSlice(data, value, end));
+}
+
+//根据Content-Length决定是否还要读body 不支持chunked请求体
+bool HttpContext::processHeadersEnd(const char* data)
+{
+    request_.setBase(data);
+    if (!request_.getHeader("Transfer-Encoding").empty())
+    {
+        return fail(HttpResponse::k501NotImplemented);
+    }
+
+    base::StringPiece contentLength = request_.getHeader("Content-Length");
+    if (contentLength.empty())
+    {
+        state_ = kGotAll;
+        return true;
+    }
+
+    //只接受十进制数字 溢出之前就会超过maxBodyLength_
+    size_t length = 0;
+    for (size_t i = 0; i < contentLength.size(); ++i)
+    {
+        char c = contentLength[i];
+        if (c < '0' || c > '9')
+        {
+            return fail(HttpResponse::k400BadRequest);
+        }
+        length = length * 10 + static_cast<size_t>(c - '0');
+        if (length > maxBodyLength_)
+        {
+            return fail(HttpResponse::k413PayloadTooLarge);
+        }
+    }
+
+    bodyLength_ = length;
+    state_ = bodyLength_ == 0 ? kGotAll : kExpectBody;
+    return true;
+}
+
+bool HttpContext::fail(HttpResponse::HttpStatusCode code)
+{
+    state_ = kError;
+    errorCode_ = code;
+    return false;
+}
+
+}  // namespace net
+}  // namespace myMuduo
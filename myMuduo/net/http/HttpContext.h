@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "myMuduo/base/Timestamp.h"
+#include "myMuduo/net/http/HttpRequest.h"
+#include "myMuduo/net/http/HttpResponse.h"
+
+namespace myMuduo {
+namespace net {
+
+class Buffer;
+
+//增量解析器 保存在TcpConnection的context中
+//解析过程中不retrieve 只记录每一行解析到的偏移 数据分多次到达时从上次停下的位置继续
+//请求完整后request()中的视图直接指向inputBuffer_ 处理完再调用consume()
+class HttpContext
+{
+public:
+    enum HttpRequestParseState
+    {
+        kExpectRequestLine,
+        kExpectHeaders,
+        kExpectBody,
+        kGotAll,
+        kError
+    };
+
+    static const size_t kMaxLineLength = 8 * 1024;
+    static const size_t kMaxHeaderBytes = 64 * 1024;
+    static const size_t kDefaultMaxBodyLength = 1024 * 1024;
+
+    explicit HttpContext(size_t maxBodyLength = kDefaultMaxBodyLength);
+
+    //解析buf中的数据 解析完一个请求就停下 剩下的数据留给下一个请求(pipelining)
+    //返回false表示请求非法 errorCode()是应该回复的状态码
+    bool parseRequest(Buffer* buf, Timestamp receiveTime);
+
+    bool gotAll() const { return state_ == kGotAll; }
+
+    //处理完一个请求后调用 从buf中取走这个请求并准备解析下一个
+    void consume(Buffer* buf);
+
+    void reset();
+
+    const HttpRequest& request() const { return request_; }
+
+    HttpResponse::HttpStatusCode errorCode() const { return errorCode_; }
+
+    //正在发送的流式应答 发送完之前不解析后面的请求 保证pipelining的应答顺序
+    struct Stream
+    {
+        HttpResponse::BodyProducer producer;
+        bool chunked;
+        bool close;   //发送完后关闭连接
+        bool paused;  //outputBuffer_超过高水位 等待写完
+    };
+
+    void startStream(const HttpResponse::BodyProducer& producer, bool chunked, bool close);
+    void finishStream() { streamPtr_.reset(); }
+    Stream* stream() const { return streamPtr_.get(); }
+    bool streaming() const { return static_cast<bool>(streamPtr_); }
+
+private:
+    bool processRequestLine(const char* begin, const char* end);
+    bool processHeader(const char* begin, const char* colon, const char* end);
+    bool processHeadersEnd(const char* data);
+    bool fail(HttpResponse::HttpStatusCode code);
+
+    HttpRequestParseState state_;
+    HttpRequest request_;
+    size_t parsedBytes_;   //已经解析完的完整行的字节数 相对peek()
+    size_t scannedBytes_;  //当前行已经确认没有"\r\n"的位置 相对peek()
+    size_t bodyLength_;
+    size_t maxBodyLength_;
+    HttpResponse::HttpStatusCode errorCode_;
+    std::shared_ptr<Stream> streamPtr_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <stdint.h>
+#include "myMuduo/base/StringPiece.h"
+#include "myMuduo/base/StringUtil.h"
+#include "myMuduo/base/Timestamp.h"
+
+namespace myMuduo {
+namespace net {
+
+//请求行 头部和body都以偏移量的形式记录 实际数据留在inputBuffer_中
+//path() getHeader()等返回的视图只在HttpServer的回调期间有效 需要保存时自己拷贝
+//解析一个请求不分配内存
+class HttpRequest
+{
+public:
+    enum Method
+    {
+        kInvalid,
+        kGet,
+        kPost,
+        kHead,
+        kPut,
+        kDelete,
+        kOptions
+    };
+
+    enum Version
+    {
+        kUnknown,
+        kHttp10,
+        kHttp11
+    };
+
+    //超过这个数量的头部直接按非法请求处理
+    static const int kMaxHeaders = 64;
+
+    //相对于请求起始位置的偏移
+    typedef base::Slice Slice;
+
+    HttpRequest()
+        : base_(nullptr)
+        , method_(kInvalid)
+        , version_(kUnknown)
+        , path_{0, 0}
+        , query_{0, 0}
+        , body_{0, 0}
+        , headerCount_(0)
+        , headers_()  //每个连接构造一次 清零后拷贝(放进Any)时不会读到未初始化的内存
+    {
+    }
+
+    //复用同一个对象解析下一个请求 headers_只需要清空计数 不用整体拷贝
+    void reset()
+    {
+        base_ = nullptr;
+        method_ = kInvalid;
+        version_ = kUnknown;
+        path_ = Slice{0, 0};
+        query_ = Slice{0, 0};
+        body_ = Slice{0, 0};
+        receiveTime_ = Timestamp();
+        headerCount_ = 0;
+    }
+
+    void setVersion(Version v) { version_ = v; }
+    Version getVersion() const { return version_; }
+
+    bool setMethod(const char* start, const char* end)
+    {
+        base::StringPiece m(start, static_cast<size_t>(end - start));
+        if (m == "GET")
+            method_ = kGet;
+        else if (m == "POST")
+            method_ = kPost;
+        else if (m == "HEAD")
+            method_ = kHead;
+        else if (m == "PUT")
+            method_ = kPut;
+        else if (m == "DELETE")
+            method_ = kDelete;
+        else if (m == "OPTIONS")
+            method_ = kOptions;
+        else
+            method_ = kInvalid;
+        return method_ != kInvalid;
+    }
+
+    Method method() const { return method_; }
+
+    const char* methodString() const
+    {
+        switch (method_)
+        {
+            case kGet:
+                return "GET";
+            case kPost:
+                return "POST";
+            case kHead:
+                return "HEAD";
+            case kPut:
+                return "PUT";
+            case kDelete:
+                return "DELETE";
+            case kOptions:
+                return "OPTIONS";
+            default:
+                return "UNKNOWN";
+        }
+    }
+
+    //请求完整后由HttpContext设置 指向inputBuffer_中请求的第一个字节
+    void setBase(const char* base) { base_ = base; }
+
+    void setPath(Slice path) { path_ = path; }
+    base::StringPiece path() const { return view(path_); }
+
+    //不包含'?'
+    void setQuery(Slice query) { query_ = query; }
+    base::StringPiece query() const { return view(query_); }
+
+    void setReceiveTime(Timestamp t) { receiveTime_ = t; }
+    Timestamp receiveTime() const { return receiveTime_; }
+
+    //value已经去掉首尾空白 头部太多时返回false
+    bool addHeader(Slice name, Slice value)
+    {
+        if (headerCount_ == kMaxHeaders)
+        {
+            return false;
+        }
+        headers_[headerCount_].name = name;
+        headers_[headerCount_].value = value;
+        ++headerCount_;
+        return true;
+    }
+
+    //字段名不区分大小写 找不到返回空视图
+    base::StringPiece getHeader(const base::StringPiece& field) const
+    {
+        for (int i = 0; i < headerCount_; ++i)
+        {
+            if (base::equalsIgnoreCase(view(headers_[i].name), field))
+            {
+                return view(headers_[i].value);
+            }
+        }
+        return base::StringPiece();
+    }
+
+    int headerCount() const { return headerCount_; }
+    base::StringPiece headerName(int i) const { return view(headers_[i].name); }
+    base::StringPiece headerValue(int i) const { return view(headers_[i].value); }
+
+    void setBody(Slice body) { body_ = body; }
+    base::StringPiece body() const { return view(body_); }
+
+private:
+    struct Header
+    {
+        Slice name;
+        Slice value;
+    };
+
+    base::StringPiece view(Slice s) const { return base::StringPiece(base_ + s.offset, s.length); }
+
+    const char* base_;
+    Method method_;
+    Version version_;
+    Slice path_;
+    Slice query_;
+    Slice body_;
+    Timestamp receiveTime_;
+    int headerCount_;
+    Header headers_[kMaxHeaders];
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,92 @@
+#include "myMuduo/net/http/HttpResponse.h"
+#include <cstdio>
+#include <cstring>
+#include "myMuduo/net/Buffer.h"
+
+namespace myMuduo {
+namespace net {
+
+void HttpResponse::appendToBuffer(Buffer* output) const
+{
+    char buf[64];
+    const char* message = statusMessage_.empty() ? defaultStatusMessage(statusCode_) : statusMessage_.c_str();
+    int n = snprintf(buf, sizeof buf, "HTTP/1.1 %d ", statusCode_);
+    output->append(buf, n);
+    output->append(message, strlen(message));
+    output->append("\r\n", 2);
+
+    if (closeConnection_)
+    {
+        static const char kClose[] = "Connection: close\r\n";
+        output->append(kClose, sizeof kClose - 1);
+    }
+    else
+    {
+        static const char kKeepAlive[] = "Connection: Keep-Alive\r\n";
+        output->append(kKeepAlive, sizeof kKeepAlive - 1);
+    }
+    if (streaming())
+    {
+        if (chunked_)
+        {
+            static const char kChunked[] = "Transfer-Encoding: chunked\r\n";
+            output->append(kChunked, sizeof kChunked - 1);
+        }
+    }
+    else
+    {
+        //keep-alive时对端靠Content-Length确定响应边界 close时也带上方便客户端校验
+        n = snprintf(buf, sizeof buf, "Content-Length: %zu\r\n", body_.size());
+        output->append(buf, n);
+    }
+
+    for (const auto& header : headers_)
+    {
+        output->append(header.first.data(), header.first.size());
+        output->append(": ", 2);
+        output->append(header.second.data(), header.second.size());
+        output->append("\r\n", 2);
+    }
+
+    output->append("\r\n", 2);
+    if (!streaming())
+    {
+        output->append(body_.data(), body_.size());
+    }
+}
+
+const char* HttpResponse::defaultStatusMessage(HttpStatusCode code)
+{
+    switch (code)
+    {
+        case k200Ok:
+            return "OK";
+        case k204NoContent:
+            return "No Content";
+        case k301MovedPermanently:
+            return "Moved Permanently";
+        case k400BadRequest:
+            return "Bad Request";
+        case k404NotFound:
+            return "Not Found";
+        case k405MethodNotAllowed:
+            return "Method Not Allowed";
+        case k413PayloadTooLarge:
+            return "Payload Too Large";
+        case k426UpgradeRequired:
+            return "Upgrade Required";
+        case k431RequestHeaderFieldsTooLarge:
+            return "Request Header Fields Too Large";
+        case k500InternalServerError:
+            return "Internal Server Error";
+        case k501NotImplemented:
+            return "Not Implemented";
+        case k503ServiceUnavailable:
+            return "Service Unavailable";
+        default:
+            return "Unknown";
+    }
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+
+namespace myMuduo {
+namespace net {
+
+class Buffer;
+
+class HttpResponse
+{
+public:
+    //流式body 每次调用向chunk中写入下一段数据 返回false表示body已经结束
+    //返回true时chunk不能为空 由HttpServer在连接的loop线程中按背压节奏调用
+    using BodyProducer = std::function<bool(Buffer* chunk)>;
+
+    enum HttpStatusCode
+    {
+        kUnknown,
+        k200Ok = 200,
+        k204NoContent = 204,
+        k301MovedPermanently = 301,
+        k400BadRequest = 400,
+        k404NotFound = 404,
+        k405MethodNotAllowed = 405,
+        k413PayloadTooLarge = 413,
+        k426UpgradeRequired = 426,
+        k431RequestHeaderFieldsTooLarge = 431,
+        k500InternalServerError = 500,
+        k501NotImplemented = 501,
+        k503ServiceUnavailable = 503
+    };
+
+    explicit HttpResponse(bool close)
+        : statusCode_(kUnknown)
+        , closeConnection_(close)
+        , chunked_(false)
+    {
+    }
+
+    void setStatusCode(HttpStatusCode code) { statusCode_ = code; }
+    HttpStatusCode statusCode() const { return statusCode_; }
+
+    //为空时使用状态码对应的默认描述
+    void setStatusMessage(const std::string& message) { statusMessage_ = message; }
+
+    void setCloseConnection(bool on) { closeConnection_ = on; }
+    bool closeConnection() const { return closeConnection_; }
+
+    void setContentType(const std::string& contentType) { addHeader("Content-Type", contentType); }
+
+    void addHeader(const std::string& key, const std::string& value) { headers_[key] = value; }
+
+    void setBody(const std::string& body) { body_ = body; }
+    const std::string& body() const { return body_; }
+
+    //设置后忽略body_ 应答头之后的数据由producer分段生成 整个body不会同时在内存中
+    void setBodyProducer(BodyProducer producer) { bodyProducer_ = std::move(producer); }
+    const BodyProducer& bodyProducer() const { return bodyProducer_; }
+    bool streaming() const { return static_cast<bool>(bodyProducer_); }
+
+    //流式body的编码 true用chunked false靠关闭连接标识结束(HTTP/1.0)
+    void setChunked(bool on) { chunked_ = on; }
+    bool chunked() const { return chunked_; }
+
+    //状态行 头部 Content-Length 空行 body依次追加到output
+    //流式应答只追加到空行为止
+    void appendToBuffer(Buffer* output) const;
+
+    static const char* defaultStatusMessage(HttpStatusCode code);
+
+private:
+    std::map<std::string, std::string> headers_;
+    HttpStatusCode statusCode_;
+    std::string statusMessage_;
+    bool closeConnection_;
+    bool chunked_;
+    std::string body_;
+    BodyProducer bodyProducer_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,252 @@
+#include "myMuduo/net/http/HttpServer.h"
+#include <cstdio>
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/http/HttpContext.h"
+#include "myMuduo/net/http/HttpRequest.h"
+#include "myMuduo/net/http/HttpResponse.h"
+#include "myMuduo/base/Logging.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+namespace {
+
+const size_t kDefaultStreamHighWaterMark = 64 * 1024;
+//一次最多生成的chunk数 避免一条连接的大应答独占loop
+const int kMaxChunksPerPump = 16;
+
+void defaultHttpCallback(const HttpRequest&, HttpResponse* resp)
+{
+    resp->setStatusCode(HttpResponse::k404NotFound);
+    resp->setCloseConnection(true);
+}
+
+}  // namespace
+
+HttpServer::HttpServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name,
+                       TcpServer::Option option)
+    : server_(loop, listenAddr, name, option)
+    , httpCallback_(defaultHttpCallback)
+    , maxBodyLength_(HttpContext::kDefaultMaxBodyLength)
+    , streamHighWaterMark_(kDefaultStreamHighWaterMark)
+{
+    server_.setConnectionCallback([this](const TcpConnectionPtr& conn) { onConnection(conn); });
+    server_.setMessageCallback(
+        [this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime) { onMessage(conn, buf, receiveTime); });
+    server_.setWriteCompleteCallback([this](const TcpConnectionPtr& conn) { onWriteComplete(conn); });
+}
+
+void HttpServer::start()
+{
+    spdlog::info("HttpServer[{}] starts listening on {}", server_.name(), server_.ipPort());
+    server_.start();
+}
+
+void HttpServer::onConnection(const TcpConnectionPtr& conn)
+{
+    if (conn->connected())
+    {
+        conn->setContext(HttpContext(maxBodyLength_));
+        conn->setHighWaterMarkCallback(
+            [this](const TcpConnectionPtr& c, size_t len) { onHighWaterMark(c, len); }, streamHighWaterMark_);
+    }
+}
+
+void HttpServer::onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime)
+{
+    HttpContext* context = conn->getMutableContext()->cast<HttpContext>();
+    //已经决定关闭的连接上后续到达的数据直接丢弃
+    if (context == nullptr || !conn->connected())
+    {
+        buf->retrieveAll();
+        return;
+    }
+
+    //流式应答还没发完 后面的请求先留在buf中 堆积太多就先停止读
+    if (context->streaming())
+    {
+        if (buf->readableBytesLength() > HttpContext::kMaxHeaderBytes)
+        {
+            conn->stopRead();
+        }
+        return;
+    }
+    processRequests(conn, context, buf, receiveTime);
+}
+
+void HttpServer::processRequests(const TcpConnectionPtr& conn, HttpContext* context, Buffer* buf,
+                                 Timestamp receiveTime)
+{
+    Buffer output;
+    bool close = false;
+    while (!close && !context->streaming())
+    {
+        if (!context->parseRequest(buf, receiveTime))
+        {
+            HttpResponse response(true);
+            response.setStatusCode(context->errorCode());
+            response.appendToBuffer(&output);
+            buf->retrieveAll();
+            close = true;
+            break;
+        }
+        if (!context->gotAll())
+        {
+            break;
+        }
+        //request中的视图指向buf 处理完才能取走
+        close = onRequest(context->request(), context, &output);
+        context->consume(buf);
+    }
+
+    if (output.readableBytesLength() > 0)
+    {
+        conn->send(&output);
+    }
+    if (close)
+    {
+        conn->shutdown();
+    }
+    else if (context->streaming())
+    {
+        pumpStream(conn);
+    }
+}
+
+bool HttpServer::onRequest(const HttpRequest& req, HttpContext* context, Buffer* output)
+{
+    base::StringPiece connection = req.getHeader("Connection");
+    bool close = base::equalsIgnoreCase(connection, "close") ||
+                 (req.getVersion() == HttpRequest::kHttp10 && !base::equalsIgnoreCase(connection, "keep-alive"));
+    HttpResponse response(close);
+    httpCallback_(req, &response);
+
+    if (response.streaming())
+    {
+        //HTTP/1.0不支持chunked 只能用关闭连接表示body结束
+        bool chunked = req.getVersion() == HttpRequest::kHttp11;
+        if (!chunked)
+        {
+            response.setCloseConnection(true);
+        }
+        response.setChunked(chunked);
+        response.appendToBuffer(output);
+        context->startStream(response.bodyProducer(), chunked, response.closeConnection());
+        return false;
+    }
+
+    response.appendToBuffer(output);
+    return response.closeConnection();
+}
+
+void HttpServer::onWriteComplete(const TcpConnectionPtr& conn)
+{
+    //只在等待缓冲区写完时恢复 pump自己排队的后续调用负责其他情况
+    HttpContext* context = conn->getMutableContext()->cast<HttpContext>();
+    if (context != nullptr && context->streaming() && context->stream()->paused &&
+        conn->getOutputBuffer()->readableBytesLength() < streamHighWaterMark_)
+    {
+        context->stream()->paused = false;
+        pumpStream(conn);
+    }
+}
+
+void HttpServer::onHighWaterMark(const TcpConnectionPtr& conn, size_t len)
+{
+    HttpContext* context = conn->getMutableContext()->cast<HttpContext>();
+    if (context != nullptr && context->streaming() &&
+        conn->getOutputBuffer()->readableBytesLength() >= streamHighWaterMark_)
+    {
+        MYMUDUO_LOG_DEBUG("HttpServer::onHighWaterMark() - [{}] pause stream, {} bytes pending", conn->getName(), len);
+        context->stream()->paused = true;
+    }
+}
+
+//生成chunk直到发送缓冲区超过高水位 之后由onWriteComplete继续
+//任何时候只有一条调用链在推进 不会重复生成
+void HttpServer::pumpStream(const TcpConnectionPtr& conn)
+{
+    HttpContext* context = conn->getMutableContext()->cast<HttpContext>();
+    if (context == nullptr || !context->streaming())
+    {
+        return;
+    }
+    if (!conn->connected())
+    {
+        context->finishStream();
+        return;
+    }
+
+    HttpContext::Stream* stream = context->stream();
+    Buffer* pending = conn->getOutputBuffer();
+    for (int i = 0; i < kMaxChunksPerPump && !stream->paused; ++i)
+    {
+        Buffer body;
+        bool more = stream->producer(&body);
+        Buffer frame;
+        if (stream->chunked)
+        {
+            //长度为0的chunk表示结束 空数据不能单独成块
+            if (body.readableBytesLength() > 0)
+            {
+                char header[32];
+                int n = snprintf(header, sizeof header, "%zx\r\n", body.readableBytesLength());
+                frame.append(header, n);
+                frame.append(body.peek(), body.readableBytesLength());
+                frame.append("\r\n", 2);
+            }
+            if (!more)
+            {
+                frame.append("0\r\n\r\n", 5);
+            }
+        }
+        else
+        {
+            frame.swap(body);
+        }
+        if (frame.readableBytesLength() > 0)
+        {
+            conn->send(&frame);
+        }
+
+        if (!more)
+        {
+            bool close = stream->close;
+            context->finishStream();
+            if (close)
+            {
+                conn->shutdown();
+                return;
+            }
+            //继续处理流式应答期间积压的请求
+            if (!conn->isReading())
+            {
+                conn->startRead();
+            }
+            processRequests(conn, context, conn->getInputBuffer(), Timestamp::now());
+            return;
+        }
+
+        if (pending->readableBytesLength() >= streamHighWaterMark_)
+        {
+            stream->paused = true;
+        }
+    }
+
+    //没有被高水位暂停 让出loop后继续
+    if (!stream->paused)
+    {
+        std::weak_ptr<TcpConnection> weakConn(conn);
+        conn->getLoop()->queueInLoop([this, weakConn]() {
+            TcpConnectionPtr c = weakConn.lock();
+            if (c)
+            {
+                pumpStream(c);
+            }
+        });
+    }
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/TcpServer.h"
+
+namespace myMuduo {
+namespace net {
+
+class HttpContext;
+class HttpRequest;
+class HttpResponse;
+
+//HTTP/1.1服务器 支持keep-alive和pipelining
+//同一次读到的多个请求的应答先写进同一个Buffer 最后一次send出去
+//流式应答由WriteComplete/HighWaterMark回调驱动 发送缓冲区满时暂停producer
+class HttpServer : noncopyable
+{
+public:
+    //在连接所在的loop线程中调用 填好response即可
+    using HttpCallback = std::function<void(const HttpRequest&, HttpResponse*)>;
+
+    HttpServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name,
+               TcpServer::Option option = TcpServer::kNoReusePort);
+
+    EventLoop* getLoop() const { return server_.getLoop(); }
+
+    void setHttpCallback(HttpCallback cb) { httpCallback_ = std::move(cb); }
+
+    void setThreadNum(int numThreads) { server_.setThreadNum(numThreads); }
+
+    //超过长度的请求体直接回复413并关闭连接
+    void setMaxBodyLength(size_t maxBodyLength) { maxBodyLength_ = maxBodyLength; }
+
+    //流式应答时outputBuffer_超过这个值就暂停producer 写完后再继续
+    //每条连接占用的发送缓冲区大致不超过 高水位 + 一个chunk
+    void setStreamHighWaterMark(size_t highWaterMark) { streamHighWaterMark_ = highWaterMark; }
+
+    void start();
+
+private:
+    void onConnection(const TcpConnectionPtr& conn);
+    void onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime);
+    void onWriteComplete(const TcpConnectionPtr& conn);
+    void onHighWaterMark(const TcpConnectionPtr& conn, size_t len);
+    void processRequests(const TcpConnectionPtr& conn, HttpContext* context, Buffer* buf, Timestamp receiveTime);
+    //返回true表示应答后要关闭连接
+    bool onRequest(const HttpRequest& req, HttpContext* context, Buffer* output);
+    void pumpStream(const TcpConnectionPtr& conn);
+
+    TcpServer server_;
+    HttpCallback httpCallback_;
+    size_t maxBodyLength_;
+    size_t streamHighWaterMark_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,92 @@
+#include "myMuduo/net/http/MetricsServer.h"
+#include <cstdlib>
+#include "myMuduo/net/ConnectionSampler.h"
+#include "myMuduo/net/LoopMetrics.h"
+#include "myMuduo/net/http/HttpRequest.h"
+#include "myMuduo/net/http/HttpResponse.h"
+
+namespace myMuduo {
+namespace net {
+
+MetricsServer::MetricsServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name)
+    : server_(loop, listenAddr, name)
+{
+    server_.setHttpCallback([this](const HttpRequest& req, HttpResponse* resp) { onRequest(req, resp); });
+}
+
+namespace {
+
+const size_t kDefaultTopN = 20;
+
+//query形如sort=rtt&n=20 没有的参数返回空串
+std::string queryParam(const std::string& query, const std::string& key)
+{
+    size_t pos = 0;
+    while (pos < query.size())
+    {
+        size_t end = query.find('&', pos);
+        if (end == std::string::npos)
+        {
+            end = query.size();
+        }
+        if (query.compare(pos, key.size(), key) == 0 && pos + key.size() < end && query[pos + key.size()] == '=')
+        {
+            return query.substr(pos + key.size() + 1, end - pos - key.size() - 1);
+        }
+        pos = end + 1;
+    }
+    return std::string();
+}
+
+std::string topConnections(const std::string& query)
+{
+    ConnectionSampler::SortKey key = ConnectionSampler::kByRtt;
+    std::string sort = queryParam(query, "sort");
+    if (sort == "retrans")
+    {
+        key = ConnectionSampler::kByRetrans;
+    }
+    else if (sort == "backpressure")
+    {
+        key = ConnectionSampler::kByBackpressure;
+    }
+    else if (sort == "bytes")
+    {
+        key = ConnectionSampler::kByBytes;
+    }
+    std::string n = queryParam(query, "n");
+    size_t topN = n.empty() ? kDefaultTopN : strtoul(n.c_str(), nullptr, 10);
+    return ConnectionSampler::format(ConnectionSampler::topN(topN, key));
+}
+
+}  // namespace
+
+void MetricsServer::onRequest(const HttpRequest& req, HttpResponse* resp)
+{
+    bool connections = req.path() == "/connections";
+    if (req.path() != "/metrics" && !connections)
+    {
+        resp->setStatusCode(HttpResponse::k404NotFound);
+        resp->setStatusMessage("Not Found");
+        return;
+    }
+    if (req.method() != HttpRequest::kGet && req.method() != HttpRequest::kHead)
+    {
+        resp->setStatusCode(HttpResponse::k405MethodNotAllowed);
+        resp->setStatusMessage("Method Not Allowed");
+        return;
+    }
+    resp->setStatusCode(HttpResponse::k200Ok);
+    resp->setStatusMessage("OK");
+    if (connections)
+    {
+        resp->setContentType("text/plain");
+        resp->setBody(topConnections(req.query().toString()));
+        return;
+    }
+    resp->setContentType("text/plain; version=0.0.4");
+    resp->setBody(MetricsRegistry::instance().toPrometheus());
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/http/HttpServer.h"
+
+namespace myMuduo {
+namespace net {
+
+//内置的指标服务 GET /metrics 返回所有EventLoop的计数器和直方图 Prometheus文本格式
+//GET /connections?sort=rtt|retrans|backpressure|bytes&n=20 返回ConnectionSampler::topN的结果 每个连接一行
+//一般放在baseLoop上 单独监听一个端口 不影响业务端口
+class MetricsServer : noncopyable
+{
+public:
+    MetricsServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name = "MetricsServer");
+
+    void start() { server_.start(); }
+
+private:
+    void onRequest(const HttpRequest& req, HttpResponse* resp);
+
+    HttpServer server_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -2,6 +2,7 @@
 #include <sys/epoll.h>
 #include <cstdlib>
 #include "myMuduo/net/EventLoop.h"
+#include "myMuduo/base/Logging.h"
 #include "spdlog/spdlog.h"
 
 namespace myMuduo {
@@ -33,7 +34,7 @@ Timestamp EPollPoller::poll(int timeoutMs, ChannelList* activeChannels)
 {
     int numEvents = epoll_wait(epollfd_, events_.data(), static_cast<int>(events_.size()), timeoutMs);
     int savedErrno = errno;
-    spdlog::debug("EPollPoller::poll() - numEvents: {}, timeoutMs: {}", numEvents, timeoutMs);
+    MYMUDUO_LOG_DEBUG("EPollPoller::poll() - numEvents: {}, timeoutMs: {}", numEvents, timeoutMs);
     Timestamp now = Timestamp::now();
     if (numEvents > 0)
     {
@@ -48,7 +49,7 @@ Timestamp EPollPoller::poll(int timeoutMs, ChannelList* activeChannels)
 
     if (numEvents == 0)
     {
-        spdlog::debug("EPollPoller::poll() - no events occurred, timeout: {} ms", timeoutMs);
+        MYMUDUO_LOG_DEBUG("EPollPoller::poll() - no events occurred, timeout: {} ms", timeoutMs);
     }
     else if (numEvents < 0)
     {
@@ -59,7 +60,7 @@ Timestamp EPollPoller::poll(int timeoutMs, ChannelList* activeChannels)
         }
         else
         {
-            spdlog::debug("EPollPoller::poll() - epoll_wait interrupted by signal");
+            MYMUDUO_LOG_DEBUG("EPollPoller::poll() - epoll_wait interrupted by signal");
         }
     }
 
@@ -74,8 +75,8 @@ void EPollPoller::updateChannel(Channel* channel)
     assertInLoopThread();
     const int index = channel->index();
     const int fd = channel->fd();
-    spdlog::debug("EPollPoller::updateChannel() - fd: {}, index: {}, enent: {}", fd, index,
-                  channel->eventsToString());
+    MYMUDUO_LOG_DEBUG("EPollPoller::updateChannel() - fd: {}, index: {}, enent: {}", fd, index,
+                      channel->eventsToString());
     // 新增Channel
     if (index == kNew || index == kDeleted)
     {
@@ -127,7 +128,7 @@ void EPollPoller::removeChannel(Channel* channel)
     assertInLoopThread();
     int fd = channel->fd();
     int index = channel->index();
-    spdlog::debug("EPollPoller::removeChannel() - fd: {}, index: {}", fd, channel->index());
+    MYMUDUO_LOG_DEBUG("EPollPoller::removeChannel() - fd: {}, index: {}", fd, channel->index());
 
     // 确保Channel在channels_中注册了
     assert(channels_.find(fd) != channels_.end());
@@ -168,8 +169,8 @@ void EPollPoller::update(int operation, Channel* channel)
     event.events = channel->events();
     event.data.ptr = channel;  // 将Channel指针存储在epoll_event的data中
     int fd = channel->fd();
-    spdlog::debug("EPollPoller::update() - fd: {}, operation: {}, events: {}", fd,
-                  operationToString(operation), channel->eventsToString());
+    MYMUDUO_LOG_DEBUG("EPollPoller::update() - fd: {}, operation: {}, events: {}", fd,
+                      operationToString(operation), channel->eventsToString());
 
     if (epoll_ctl(epollfd_, operation, fd, &event) < 0)
     {
@@ -204,10 +205,12 @@ void EPollPoller::fillActiveChannels(int numEvents, ChannelList* activeChannels)
     {
         Channel* channel = static_cast<Channel*>(events_[i].data.ptr);
 
-        int fd = channel->fd();
-        ChannelMap::const_iterator it = channels_.find(fd);
+#ifndef NDEBUG
+        //只在Debug构建中检查 Release下省掉每个事件一次的哈希查找
+        ChannelMap::const_iterator it = channels_.find(channel->fd());
         assert(it != channels_.end());
         assert(it->second == channel);
+#endif
 
         channel->set_revents(events_[i].events);
         activeChannels->push_back(channel);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "myMuduo/base/StringPiece.h"
+#include "myMuduo/base/StringUtil.h"
+
+namespace myMuduo {
+namespace net {
+
+//一条RESP命令 参数以偏移的形式记录 实际数据留在inputBuffer_中
+//arg()返回的视图只在RespServer的回调期间有效 需要保存时自己拷贝
+//args_的容量在同一条连接上复用 稳定之后解析命令不分配内存
+class RespCommand
+{
+public:
+    //相对于命令起始位置的偏移
+    typedef base::Slice Slice;
+
+    RespCommand()
+        : base_(nullptr)
+    {
+    }
+
+    //命令完整后由RespParser设置 指向inputBuffer_中命令的第一个字节
+    void setBase(const char* base) { base_ = base; }
+
+    void addArg(Slice arg) { args_.push_back(arg); }
+    void reserve(size_t n) { args_.reserve(n); }
+    void clear()
+    {
+        base_ = nullptr;
+        args_.clear();
+    }
+
+    size_t argc() const { return args_.size(); }
+    base::StringPiece arg(size_t i) const { return base::StringPiece(base_ + args_[i].offset, args_[i].length); }
+
+    //命令名 比较时不区分大小写
+    base::StringPiece name() const { return args_.empty() ? base::StringPiece() : arg(0); }
+    bool is(const base::StringPiece& command) const { return !args_.empty() && base::equalsIgnoreCase(arg(0), command); }
+
+private:
+    const char* base_;
+    std::vector<Slice> args_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
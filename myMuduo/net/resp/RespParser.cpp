@@ -0,0 +1,258 @@
+#include "myMuduo/net/resp/RespParser.h"
+#include <algorithm>
+#include <cassert>
+#include "myMuduo/base/ByteSearch.h"
+#include "myMuduo/base/StringUtil.h"
+#include "myMuduo/net/Buffer.h"
+
+namespace myMuduo {
+namespace net {
+
+const size_t RespParser::kMaxInlineLength;
+const int64_t RespParser::kMaxArgs;
+const size_t RespParser::kDefaultMaxBulkLength;
+
+namespace {
+
+//聚合类型的元素个数上限 防止恶意的长度导致计数溢出
+const int64_t kMaxAggregateLength = 1LL << 32;
+
+//十进制整数 可以带负号 不能为空 不能有其他字符
+bool parseInteger(const char* begin, const char* end, int64_t* value)
+{
+    bool negative = begin < end && *begin == '-';
+    if (negative)
+    {
+        ++begin;
+    }
+    if (begin == end || end - begin > 18)
+    {
+        return false;
+    }
+    int64_t n = 0;
+    for (; begin < end; ++begin)
+    {
+        if (*begin < '0' || *begin > '9')
+        {
+            return false;
+        }
+        n = n * 10 + (*begin - '0');
+    }
+    *value = negative ? -n : n;
+    return true;
+}
+
+}  // namespace
+
+RespParser::RespParser(size_t maxBulkLength)
+    : state_(kExpectCommand)
+    , parsedBytes_(0)
+    , scannedBytes_(0)
+    , remainingArgs_(0)
+    , bulkLength_(0)
+    , maxBulkLength_(maxBulkLength)
+    , errorMessage_(nullptr)
+{
+}
+
+bool RespParser::parse(Buffer* buf)
+{
+    //偏移都相对于peek() Buffer内部搬移数据不影响已经记录的结果
+    const char* data = buf->peek();
+    const char* end = data + buf->readableBytesLength();
+
+    while (state_ != kGotAll && state_ != kError)
+    {
+        const char* lineStart = data + parsedBytes_;
+        if (state_ == kExpectBulkData)
+        {
+            //参数内容可能包含任意字节 按长度取 不查找"\r\n"
+            if (static_cast<size_t>(end - lineStart) < bulkLength_ + 2)
+            {
+                break;
+            }
+            if (lineStart[bulkLength_] != '\r' || lineStart[bulkLength_ + 1] != '\n')
+            {
+                return fail("Protocol error: expected '\\r\\n' after bulk data");
+            }
+            command_.addArg(base::makeSlice(data, lineStart, lineStart + bulkLength_));
+            parsedBytes_ += bulkLength_ + 2;
+            state_ = --remainingArgs_ == 0 ? kGotAll : kExpectBulkLength;
+            continue;
+        }
+
+        //上次没找到时最后一个字节可能是'\r' 所以scannedBytes_停在它上面
+        const char* crlf = base::findCRLF(data + std::max(parsedBytes_, scannedBytes_), end);
+        if (crlf == nullptr)
+        {
+            if (static_cast<size_t>(end - lineStart) > kMaxInlineLength)
+            {
+                return fail("Protocol error: too big inline request");
+            }
+            scannedBytes_ = end > lineStart ? static_cast<size_t>(end - data) - 1 : parsedBytes_;
+            break;
+        }
+        size_t lineLength = static_cast<size_t>(crlf - lineStart);
+        if (lineLength > kMaxInlineLength)
+        {
+            return fail("Protocol error: too big inline request");
+        }
+
+        int64_t n = 0;
+        if (state_ == kExpectBulkLength)
+        {
+            if (lineLength == 0 || *lineStart != '$')
+            {
+                return fail("Protocol error: expected '$'");
+            }
+            if (!parseInteger(lineStart + 1, crlf, &n) || n < 0 || static_cast<uint64_t>(n) > maxBulkLength_)
+            {
+                return fail("Protocol error: invalid bulk length");
+            }
+            bulkLength_ = static_cast<size_t>(n);
+            state_ = kExpectBulkData;
+        }
+        else if (lineLength > 0 && *lineStart == '*')
+        {
+            if (!parseInteger(lineStart + 1, crlf, &n) || n > kMaxArgs)
+            {
+                return fail("Protocol error: invalid multibulk length");
+            }
+            //*0和*-1是空命令 跳过
+            if (n > 0)
+            {
+                remainingArgs_ = n;
+                command_.reserve(static_cast<size_t>(std::min<int64_t>(n, 1024)));
+                state_ = kExpectBulkLength;
+            }
+        }
+        else if (!parseInline(lineStart, crlf))
+        {
+            return false;
+        }
+        parsedBytes_ += lineLength + 2;
+    }
+
+    if (state_ == kGotAll)
+    {
+        command_.setBase(data);
+    }
+    return state_ != kError;
+}
+
+//按空白分割 不支持引号 空行跳过
+bool RespParser::parseInline(const char* begin, const char* end)
+{
+    const char* data = begin - parsedBytes_;
+    const char* p = begin;
+    while (p < end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t'))
+        {
+            ++p;
+        }
+        const char* start = p;
+        while (p < end && *p != ' ' && *p != '\t')
+        {
+            ++p;
+        }
+        if (p > start)
+        {
+            command_.addArg(base::makeSlice(data, start, p));
+        }
+    }
+    if (command_.argc() > 0)
+    {
+        state_ = kGotAll;
+    }
+    return true;
+}
+
+void RespParser::consume(Buffer* buf)
+{
+    assert(state_ == kGotAll);
+    buf->retrieve(parsedBytes_);
+    reset();
+}
+
+void RespParser::reset()
+{
+    state_ = kExpectCommand;
+    command_.clear();
+    parsedBytes_ = 0;
+    scannedBytes_ = 0;
+    remainingArgs_ = 0;
+    bulkLength_ = 0;
+    errorMessage_ = nullptr;
+}
+
+bool RespParser::fail(const char* message)
+{
+    state_ = kError;
+    errorMessage_ = message;
+    return false;
+}
+
+//每读到一个值remaining减一 聚合类型再加上它的元素个数
+int64_t RespParser::scanValue(const char* data, size_t len)
+{
+    const char* p = data;
+    const char* end = data + len;
+    int64_t remaining = 1;
+    while (remaining > 0)
+    {
+        const char* crlf = base::findCRLF(p, end);
+        if (crlf == nullptr)
+        {
+            return 0;
+        }
+        const char* next = crlf + 2;
+        int64_t n = 0;
+        --remaining;
+        switch (*p)
+        {
+            case '+':  //简单字符串
+            case '-':  //错误
+            case ':':  //整数
+            case ',':  //double
+            case '(':  //大整数
+                break;
+            case '_':  //RESP3 null
+                if (crlf != p + 1) return -1;
+                break;
+            case '#':  //RESP3 boolean
+                if (crlf != p + 2 || (p[1] != 't' && p[1] != 'f')) return -1;
+                break;
+            case '$':  //bulk string
+            case '!':  //bulk error
+            case '=':  //verbatim string
+                if (!parseInteger(p + 1, crlf, &n)) return -1;
+                if (n == -1 && *p == '$') break;
+                if (n < 0) return -1;
+                if (end - next < n + 2) return 0;
+                if (next[n] != '\r' || next[n + 1] != '\n') return -1;
+                next += n + 2;
+                break;
+            case '*':  //数组
+            case '~':  //set
+            case '>':  //push
+            case '%':  //map
+            case '|':  //attribute
+                if (!parseInteger(p + 1, crlf, &n)) return -1;
+                if (n == -1 && *p == '*') break;
+                if (n < 0 || n > kMaxAggregateLength) return -1;
+                if (*p == '%' || *p == '|') n *= 2;
+                //attribute之后还跟着它修饰的值
+                if (*p == '|') n += 1;
+                remaining += n;
+                break;
+            default:
+                return -1;
+        }
+        p = next;
+    }
+    return p - data;
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include "myMuduo/net/resp/RespCommand.h"
+
+namespace myMuduo {
+namespace net {
+
+class Buffer;
+
+//RESP请求的增量解析器 保存在TcpConnection的context中
+//支持multibulk(*N\r\n$len\r\n...)和inline命令(PING\r\n) RESP2和RESP3的请求格式相同
+//解析过程中不retrieve 数据分多次到达时从上次解析完的参数继续
+//命令完整后command()中的视图直接指向inputBuffer_ 处理完再调用consume()
+class RespParser
+{
+public:
+    enum RespParseState
+    {
+        kExpectCommand,
+        kExpectBulkLength,
+        kExpectBulkData,
+        kGotAll,
+        kError
+    };
+
+    static const size_t kMaxInlineLength = 64 * 1024;
+    static const int64_t kMaxArgs = 1024 * 1024;
+    static const size_t kDefaultMaxBulkLength = 512 * 1024 * 1024;
+
+    explicit RespParser(size_t maxBulkLength = kDefaultMaxBulkLength);
+
+    //解析完一条命令就停下 剩下的数据留给下一条(pipelining)
+    //返回false表示协议错误 errorMessage()是应该回复的错误
+    bool parse(Buffer* buf);
+
+    bool gotAll() const { return state_ == kGotAll; }
+
+    //处理完一条命令后调用 从buf中取走这条命令并准备解析下一条
+    void consume(Buffer* buf);
+
+    void reset();
+
+    const RespCommand& command() const { return command_; }
+
+    const char* errorMessage() const { return errorMessage_; }
+
+    //计算data开头一个完整RESP2/RESP3值的长度 用于不解析内容直接转发应答
+    //聚合类型只计数不建树 数据不够返回0 格式错误返回-1 不支持流式类型($? *?)
+    static int64_t scanValue(const char* data, size_t len);
+
+private:
+    bool parseInline(const char* begin, const char* end);
+    bool fail(const char* message);
+
+    RespParseState state_;
+    RespCommand command_;
+    size_t parsedBytes_;   //已经解析完的字节数 相对peek()
+    size_t scannedBytes_;  //当前行已经确认没有"\r\n"的位置 相对peek()
+    int64_t remainingArgs_;
+    size_t bulkLength_;
+    size_t maxBulkLength_;
+    const char* errorMessage_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
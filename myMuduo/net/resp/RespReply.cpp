@@ -0,0 +1,124 @@
+#include "myMuduo/net/resp/RespReply.h"
+#include <algorithm>
+#include <cstdio>
+#include "myMuduo/net/Buffer.h"
+
+namespace myMuduo {
+namespace net {
+
+namespace {
+
+//从后往前写十进制 返回写入的长度 buf至少21字节
+size_t formatInteger(char* buf, int64_t value)
+{
+    char temp[21];
+    char* p = temp + sizeof temp;
+    uint64_t n = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    do
+    {
+        *--p = static_cast<char>('0' + n % 10);
+        n /= 10;
+    } while (n != 0);
+    if (value < 0)
+    {
+        *--p = '-';
+    }
+    size_t length = static_cast<size_t>(temp + sizeof temp - p);
+    std::copy(p, temp + sizeof temp, buf);
+    return length;
+}
+
+}  // namespace
+
+//类型字节 十进制数 "\r\n" 一次写入
+void RespReply::appendHeader(char type, int64_t value)
+{
+    char header[32];
+    header[0] = type;
+    size_t length = 1 + formatInteger(header + 1, value);
+    header[length++] = '\r';
+    header[length++] = '\n';
+    output_->append(header, length);
+}
+
+void RespReply::simpleString(const base::StringPiece& s)
+{
+    output_->append("+", 1);
+    output_->append(s.data(), s.size());
+    output_->append("\r\n", 2);
+}
+
+void RespReply::error(const base::StringPiece& message)
+{
+    output_->append("-", 1);
+    output_->append(message.data(), message.size());
+    output_->append("\r\n", 2);
+}
+
+void RespReply::integer(int64_t value) { appendHeader(':', value); }
+
+void RespReply::bulkString(const base::StringPiece& s)
+{
+    appendHeader('$', static_cast<int64_t>(s.size()));
+    output_->append(s.data(), s.size());
+    output_->append("\r\n", 2);
+}
+
+void RespReply::null()
+{
+    if (protocolVersion_ >= 3)
+    {
+        output_->append("_\r\n", 3);
+    }
+    else
+    {
+        output_->append("$-1\r\n", 5);
+    }
+}
+
+void RespReply::arrayHeader(size_t count) { appendHeader('*', static_cast<int64_t>(count)); }
+
+void RespReply::mapHeader(size_t pairs)
+{
+    if (protocolVersion_ >= 3)
+    {
+        appendHeader('%', static_cast<int64_t>(pairs));
+    }
+    else
+    {
+        appendHeader('*', static_cast<int64_t>(pairs * 2));
+    }
+}
+
+void RespReply::doubleValue(double value)
+{
+    char buf[32];
+    int length = snprintf(buf, sizeof buf, "%.17g", value);
+    if (protocolVersion_ >= 3)
+    {
+        output_->append(",", 1);
+        output_->append(buf, static_cast<size_t>(length));
+        output_->append("\r\n", 2);
+    }
+    else
+    {
+        bulkString(base::StringPiece(buf, static_cast<size_t>(length)));
+    }
+}
+
+void RespReply::boolean(bool value)
+{
+    if (protocolVersion_ >= 3)
+    {
+        output_->append(value ? "#t\r\n" : "#f\r\n", 4);
+    }
+    else
+    {
+        integer(value ? 1 : 0);
+    }
+}
+
+void RespReply::raw(const base::StringPiece& encoded) { output_->append(encoded.data(), encoded.size()); }
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include "myMuduo/base/StringPiece.h"
+
+namespace myMuduo {
+namespace net {
+
+class Buffer;
+
+//把应答按RESP格式追加到output
+//RESP3特有的类型在RESP2连接上降级: null -> $-1 map -> 数组 double -> bulk string boolean -> 整数
+class RespReply
+{
+public:
+    RespReply(Buffer* output, int protocolVersion)
+        : output_(output)
+        , protocolVersion_(protocolVersion)
+    {
+    }
+
+    int protocolVersion() const { return protocolVersion_; }
+    Buffer* output() const { return output_; }
+
+    void simpleString(const base::StringPiece& s);
+    //message以错误码开头 比如"ERR unknown command"
+    void error(const base::StringPiece& message);
+    void integer(int64_t value);
+    void bulkString(const base::StringPiece& s);
+    void null();
+    void arrayHeader(size_t count);
+    void mapHeader(size_t pairs);
+    void doubleValue(double value);
+    void boolean(bool value);
+
+    //已经编码好的应答 比如从后端转发来的值
+    void raw(const base::StringPiece& encoded);
+
+private:
+    void appendHeader(char type, int64_t value);
+
+    Buffer* output_;
+    int protocolVersion_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,138 @@
+#include "myMuduo/net/resp/RespServer.h"
+#include "myMuduo/net/resp/RespCommand.h"
+#include "myMuduo/net/resp/RespParser.h"
+#include "myMuduo/net/resp/RespReply.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+namespace {
+
+//每条连接的状态 protocolVersion由HELLO切换
+struct RespContext
+{
+    explicit RespContext(size_t maxBulkLength)
+        : parser(maxBulkLength)
+        , protocolVersion(2)
+    {
+    }
+
+    RespParser parser;
+    int protocolVersion;
+};
+
+void defaultCommandCallback(const TcpConnectionPtr&, const RespCommand& command, RespReply* reply)
+{
+    std::string message = "ERR unknown command '";
+    message.append(command.name().data(), command.name().size());
+    message += "'";
+    reply->error(message);
+}
+
+//HELLO [protover] 应答是服务器信息的map
+void handleHello(RespContext* context, const RespCommand& command, RespReply* reply)
+{
+    if (command.argc() >= 2)
+    {
+        base::StringPiece version = command.arg(1);
+        if (version != "2" && version != "3")
+        {
+            reply->error("NOPROTO unsupported protocol version");
+            return;
+        }
+        context->protocolVersion = version[0] - '0';
+    }
+
+    RespReply hello(reply->output(), context->protocolVersion);
+    hello.mapHeader(3);
+    hello.bulkString("server");
+    hello.bulkString("myMuduo");
+    hello.bulkString("proto");
+    hello.integer(context->protocolVersion);
+    hello.bulkString("mode");
+    hello.bulkString("standalone");
+}
+
+}  // namespace
+
+RespServer::RespServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name,
+                       TcpServer::Option option)
+    : server_(loop, listenAddr, name, option)
+    , commandCallback_(defaultCommandCallback)
+    , maxBulkLength_(RespParser::kDefaultMaxBulkLength)
+{
+    server_.setConnectionCallback([this](const TcpConnectionPtr& conn) { onConnection(conn); });
+    server_.setMessageCallback(
+        [this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime) { onMessage(conn, buf, receiveTime); });
+}
+
+void RespServer::start()
+{
+    spdlog::info("RespServer[{}] starts listening on {}", server_.name(), server_.ipPort());
+    server_.start();
+}
+
+void RespServer::onConnection(const TcpConnectionPtr& conn)
+{
+    if (conn->connected())
+    {
+        conn->setContext(RespContext(maxBulkLength_));
+    }
+}
+
+void RespServer::onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp)
+{
+    RespContext* context = conn->getMutableContext()->cast<RespContext>();
+    //已经决定关闭的连接上后续到达的数据直接丢弃
+    if (context == nullptr || !conn->connected())
+    {
+        buf->retrieveAll();
+        return;
+    }
+
+    Buffer output;
+    bool close = false;
+    RespParser* parser = &context->parser;
+    while (true)
+    {
+        if (!parser->parse(buf))
+        {
+            RespReply(&output, context->protocolVersion).error(std::string("ERR ") + parser->errorMessage());
+            spdlog::warn("RespServer::onMessage() - [{}] {}", conn->getName(), parser->errorMessage());
+            buf->retrieveAll();
+            parser->reset();
+            close = true;
+            break;
+        }
+        if (!parser->gotAll())
+        {
+            break;
+        }
+
+        //command中的视图指向buf 处理完才能取走
+        const RespCommand& command = parser->command();
+        RespReply reply(&output, context->protocolVersion);
+        if (command.is("HELLO"))
+        {
+            handleHello(context, command, &reply);
+        }
+        else
+        {
+            commandCallback_(conn, command, &reply);
+        }
+        parser->consume(buf);
+    }
+
+    if (output.readableBytesLength() > 0)
+    {
+        conn->send(&output);
+    }
+    if (close)
+    {
+        conn->shutdown();
+    }
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/TcpServer.h"
+
+namespace myMuduo {
+namespace net {
+
+class RespCommand;
+class RespReply;
+
+//RESP(Redis协议)服务器 用来实现缓存 代理一类的服务
+//一次读到的所有完整命令依次分派 应答写进同一个Buffer 最后一次send出去(深度pipelining)
+//HELLO由服务器自己处理 用于切换RESP2/RESP3 其他命令交给CommandCallback
+class RespServer : noncopyable
+{
+public:
+    //在连接所在的loop线程中调用 每条命令必须正好写一个应答
+    using CommandCallback = std::function<void(const TcpConnectionPtr&, const RespCommand&, RespReply*)>;
+
+    RespServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name,
+               TcpServer::Option option = TcpServer::kNoReusePort);
+
+    EventLoop* getLoop() const { return server_.getLoop(); }
+
+    void setCommandCallback(CommandCallback cb) { commandCallback_ = std::move(cb); }
+
+    void setThreadNum(int numThreads) { server_.setThreadNum(numThreads); }
+
+    //超过长度的参数按协议错误处理 回复错误后关闭连接
+    void setMaxBulkLength(size_t maxBulkLength) { maxBulkLength_ = maxBulkLength; }
+
+    void start();
+
+private:
+    void onConnection(const TcpConnectionPtr& conn);
+    void onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime);
+
+    TcpServer server_;
+    CommandCallback commandCallback_;
+    size_t maxBulkLength_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
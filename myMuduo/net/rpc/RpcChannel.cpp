@@ -0,0 +1,67 @@
+#include "myMuduo/net/rpc/RpcChannel.h"
+#include <string>
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/TcpConnection.h"
+
+namespace myMuduo {
+namespace net {
+
+RpcChannel::RpcChannel(const TcpConnectionPtr& conn)
+    : conn_(conn)
+    , loop_(conn->getLoop())
+    , flushQueued_(false)
+{
+}
+
+void RpcChannel::write(uint64_t id, RpcCodec::MessageType type, const base::StringPiece& method,
+                       const base::StringPiece& payload)
+{
+    loop_->assertInLoopThread();
+    RpcCodec::append(&pending_, id, type, method, payload);
+    //pending functor在本轮poll的事件都处理完之后执行
+    if (!flushQueued_)
+    {
+        flushQueued_ = true;
+        std::weak_ptr<RpcChannel> weakSelf(shared_from_this());
+        loop_->queueInLoop([weakSelf]() {
+            std::shared_ptr<RpcChannel> self = weakSelf.lock();
+            if (self)
+            {
+                self->flush();
+            }
+        });
+    }
+}
+
+void RpcChannel::flush()
+{
+    flushQueued_ = false;
+    TcpConnectionPtr conn = conn_.lock();
+    if (conn && pending_.readableBytesLength() > 0)
+    {
+        conn->send(&pending_);
+    }
+    pending_.retrieveAll();
+}
+
+void RpcResponder::send(RpcCodec::MessageType type, const base::StringPiece& payload) const
+{
+    std::shared_ptr<RpcChannel> channel = channel_.lock();
+    if (!channel)
+    {
+        return;
+    }
+    if (channel->getLoop()->isInLoopThread())
+    {
+        channel->write(id_, type, base::StringPiece(), payload);
+        return;
+    }
+    //其他线程的应答拷贝一份交给loop线程
+    uint64_t id = id_;
+    std::string data(payload.data(), payload.size());
+    channel->getLoop()->runInLoop(
+        [channel, id, type, data]() { channel->write(id, type, base::StringPiece(), data); });
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include "myMuduo/base/StringPiece.h"
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/Callback.h"
+#include "myMuduo/net/rpc/RpcCodec.h"
+
+namespace myMuduo {
+namespace net {
+
+class EventLoop;
+
+//一条连接上的消息发送 RpcServer和RpcClient共用
+//同一轮事件处理中写入的消息先攒在pending_中 本轮结束时一次send出去
+//很多小应答合并成一次write系统调用
+class RpcChannel : noncopyable, public std::enable_shared_from_this<RpcChannel>
+{
+public:
+    explicit RpcChannel(const TcpConnectionPtr& conn);
+
+    EventLoop* getLoop() const { return loop_; }
+
+    //只能在连接所在的loop线程中调用
+    void write(uint64_t id, RpcCodec::MessageType type, const base::StringPiece& method,
+               const base::StringPiece& payload);
+
+    //立即发送积攒的消息
+    void flush();
+
+private:
+    std::weak_ptr<TcpConnection> conn_;
+    EventLoop* loop_;
+    Buffer pending_;
+    bool flushQueued_;
+};
+
+//服务端写应答用 可以拷贝 可以在任何线程调用 每个请求只能应答一次
+//连接已经断开时应答被丢弃
+class RpcResponder
+{
+public:
+    RpcResponder(const std::shared_ptr<RpcChannel>& channel, uint64_t id)
+        : channel_(channel)
+        , id_(id)
+    {
+    }
+
+    void reply(const base::StringPiece& response) const { send(RpcCodec::kResponse, response); }
+    void fail(const base::StringPiece& message) const { send(RpcCodec::kError, message); }
+
+    uint64_t id() const { return id_; }
+
+private:
+    void send(RpcCodec::MessageType type, const base::StringPiece& payload) const;
+
+    std::weak_ptr<RpcChannel> channel_;
+    uint64_t id_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,149 @@
+#include "myMuduo/net/rpc/RpcClient.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/TcpConnection.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+RpcClient::RpcClient(EventLoop* loop, const InetAddress& serverAddr, const std::string& name)
+    : loop_(loop)
+    , client_(loop, serverAddr, name)
+    , codec_([this](const TcpConnectionPtr&, const base::StringPiece& frame, Timestamp) { onRpcMessage(frame); },
+             RpcCodec::kLengthHeader, LengthHeaderCodec::kBigEndian, RpcCodec::kMaxMessageLength)
+    , nextId_(1)
+{
+    client_.setConnectionCallback([this](const TcpConnectionPtr& conn) { onConnection(conn); });
+    client_.setMessageCallback([this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime) {
+        codec_.onMessage(conn, buf, receiveTime);
+    });
+}
+
+//未完成的调用直接丢弃 不再回调
+RpcClient::~RpcClient()
+{
+    loop_->assertInLoopThread();
+    //连接可能比RpcClient活得久 它的回调都引用了this
+    TcpConnectionPtr conn = client_.connection();
+    if (conn)
+    {
+        conn->setConnectionCallback(defaultConnectionCallback);
+        conn->setMessageCallback(defaultMessageCallback);
+    }
+    //定时器回调也引用了this
+    for (auto& entry : calls_)
+    {
+        if (entry.second.hasTimer)
+        {
+            loop_->cancel(entry.second.timerId);
+        }
+    }
+}
+
+void RpcClient::call(const base::StringPiece& method, const base::StringPiece& request, ResponseCallback cb,
+                     double timeoutSeconds)
+{
+    if (loop_->isInLoopThread())
+    {
+        callInLoop(method, request, std::move(cb), timeoutSeconds);
+        return;
+    }
+    std::string methodCopy(method.data(), method.size());
+    std::string requestCopy(request.data(), request.size());
+    loop_->runInLoop([this, methodCopy, requestCopy, cb, timeoutSeconds]() {
+        callInLoop(methodCopy, requestCopy, cb, timeoutSeconds);
+    });
+}
+
+void RpcClient::callInLoop(const base::StringPiece& method, const base::StringPiece& request, ResponseCallback cb,
+                           double timeoutSeconds)
+{
+    loop_->assertInLoopThread();
+    if (!channelPtr_)
+    {
+        cb(kRpcDisconnected, base::StringPiece());
+        return;
+    }
+
+    uint64_t id = nextId_++;
+    PendingCall& call = calls_[id];
+    call.callback = std::move(cb);
+    call.hasTimer = timeoutSeconds > 0;
+    if (call.hasTimer)
+    {
+        call.timerId = loop_->runAfter(timeoutSeconds, [this, id]() { onTimeout(id); });
+    }
+    channelPtr_->write(id, RpcCodec::kRequest, method, request);
+}
+
+void RpcClient::onConnection(const TcpConnectionPtr& conn)
+{
+    if (conn->connected())
+    {
+        conn->setTcpNoDelay(true);
+        channelPtr_ = std::make_shared<RpcChannel>(conn);
+    }
+    else
+    {
+        channelPtr_.reset();
+        failAll(kRpcDisconnected);
+    }
+    if (connectionCallback_)
+    {
+        connectionCallback_(conn);
+    }
+}
+
+void RpcClient::onRpcMessage(const base::StringPiece& frame)
+{
+    RpcCodec::Message message;
+    if (!RpcCodec::parse(frame, &message) || message.type == RpcCodec::kRequest)
+    {
+        spdlog::error("RpcClient::onRpcMessage() - malformed message");
+        return;
+    }
+
+    //已经超时的调用的应答直接丢弃
+    auto it = calls_.find(message.id);
+    if (it == calls_.end())
+    {
+        return;
+    }
+    PendingCall call = std::move(it->second);
+    calls_.erase(it);
+    if (call.hasTimer)
+    {
+        loop_->cancel(call.timerId);
+    }
+    call.callback(message.type == RpcCodec::kResponse ? kRpcOk : kRpcError, message.payload);
+}
+
+void RpcClient::onTimeout(uint64_t id)
+{
+    auto it = calls_.find(id);
+    if (it == calls_.end())
+    {
+        return;
+    }
+    ResponseCallback callback = std::move(it->second.callback);
+    calls_.erase(it);
+    callback(kRpcTimeout, base::StringPiece());
+}
+
+void RpcClient::failAll(RpcStatus status)
+{
+    //回调中可能发起新的调用 先把表换出来
+    std::unordered_map<uint64_t, PendingCall> calls;
+    calls.swap(calls_);
+    for (auto& entry : calls)
+    {
+        if (entry.second.hasTimer)
+        {
+            loop_->cancel(entry.second.timerId);
+        }
+        entry.second.callback(status, base::StringPiece());
+    }
+}
+
+}  // namespace net
+}  // namespace myMuduo
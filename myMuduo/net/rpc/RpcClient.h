@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "myMuduo/base/StringPiece.h"
+#include "myMuduo/base/TimerId.h"
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/TcpClient.h"
+#include "myMuduo/net/codec/LengthHeaderCodec.h"
+#include "myMuduo/net/rpc/RpcChannel.h"
+
+namespace myMuduo {
+namespace net {
+
+//异步RPC客户端 一条连接上复用任意多个未完成的调用 用请求id匹配应答
+//截止时间用loop的定时器实现 超时 断开都会以对应的状态回调
+class RpcClient : noncopyable
+{
+public:
+    //在loop线程中调用 response只在回调期间有效 kRpcError时是服务端的错误描述
+    using ResponseCallback = std::function<void(RpcStatus status, const base::StringPiece& response)>;
+
+    RpcClient(EventLoop* loop, const InetAddress& serverAddr, const std::string& name);
+    //要在loop线程中析构 未完成的调用不会再回调
+    ~RpcClient();
+
+    void connect() { client_.connect(); }
+    void disconnect() { client_.disconnect(); }
+
+    void setConnectionCallback(ConnectionCallback cb) { connectionCallback_ = std::move(cb); }
+
+    //线程安全 连接还没建立时直接以kRpcDisconnected回调
+    //timeoutSeconds <= 0 表示不设截止时间
+    void call(const base::StringPiece& method, const base::StringPiece& request, ResponseCallback cb,
+              double timeoutSeconds = 0);
+
+    //只在loop线程中调用
+    size_t outstandingCalls() const { return calls_.size(); }
+
+private:
+    struct PendingCall
+    {
+        ResponseCallback callback;
+        base::TimerId timerId;
+        bool hasTimer;
+    };
+
+    void callInLoop(const base::StringPiece& method, const base::StringPiece& request, ResponseCallback cb,
+                    double timeoutSeconds);
+    void onConnection(const TcpConnectionPtr& conn);
+    void onRpcMessage(const base::StringPiece& frame);
+    void onTimeout(uint64_t id);
+    void failAll(RpcStatus status);
+
+    EventLoop* loop_;
+    TcpClient client_;
+    LengthHeaderCodec codec_;
+    ConnectionCallback connectionCallback_;
+    std::shared_ptr<RpcChannel> channelPtr_;
+    uint64_t nextId_;
+    std::unordered_map<uint64_t, PendingCall> calls_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
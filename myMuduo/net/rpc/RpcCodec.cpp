@@ -0,0 +1,72 @@
+#include "myMuduo/net/rpc/RpcCodec.h"
+#include <cassert>
+#include <cstring>
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/Endian.h"
+
+namespace myMuduo {
+namespace net {
+
+const size_t RpcCodec::kLengthHeader;
+const size_t RpcCodec::kFixedLength;
+const size_t RpcCodec::kMaxMessageLength;
+
+void RpcCodec::append(Buffer* output, uint64_t id, MessageType type, const base::StringPiece& method,
+                      const base::StringPiece& payload)
+{
+    assert(method.size() <= 0xFFFF);
+    size_t length = kFixedLength + method.size() + payload.size();
+    assert(length <= kMaxMessageLength);
+    output->ensureWritableBytes(kLengthHeader + length);
+    output->appendInt32(static_cast<int32_t>(length));
+    output->appendInt64(static_cast<int64_t>(id));
+    output->appendInt8(static_cast<int8_t>(type));
+    output->appendInt16(static_cast<int16_t>(method.size()));
+    output->append(method.data(), method.size());
+    output->append(payload.data(), payload.size());
+}
+
+bool RpcCodec::parse(const base::StringPiece& frame, Message* message)
+{
+    if (frame.size() < kFixedLength)
+    {
+        return false;
+    }
+    const char* p = frame.data();
+    uint64_t id;
+    memcpy(&id, p, sizeof id);
+    uint16_t methodLength;
+    memcpy(&methodLength, p + 9, sizeof methodLength);
+    methodLength = sockets::networkToHost16(methodLength);
+    unsigned char type = static_cast<unsigned char>(p[8]);
+    if (type > kError || kFixedLength + methodLength > frame.size())
+    {
+        return false;
+    }
+
+    message->id = sockets::networkToHost64(id);
+    message->type = static_cast<MessageType>(type);
+    message->method.set(p + kFixedLength, methodLength);
+    message->payload.set(p + kFixedLength + methodLength, frame.size() - kFixedLength - methodLength);
+    return true;
+}
+
+const char* rpcStatusToString(RpcStatus status)
+{
+    switch (status)
+    {
+        case kRpcOk:
+            return "ok";
+        case kRpcError:
+            return "error";
+        case kRpcTimeout:
+            return "timeout";
+        case kRpcDisconnected:
+            return "disconnected";
+        default:
+            return "unknown";
+    }
+}
+
+}  // namespace net
+}  // namespace myMuduo
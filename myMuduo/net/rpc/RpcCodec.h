@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include "myMuduo/base/StringPiece.h"
+
+namespace myMuduo {
+namespace net {
+
+class Buffer;
+
+//RPC消息格式(整数都是网络字节序):
+//  [长度 4字节][请求id 8字节][类型 1字节][方法名长度 2字节][方法名][payload]
+//长度不包含自身 应答的方法名为空 kError的payload是错误描述
+class RpcCodec
+{
+public:
+    enum MessageType
+    {
+        kRequest = 0,
+        kResponse = 1,
+        kError = 2
+    };
+
+    //长度头之后的固定部分
+    struct Message
+    {
+        uint64_t id;
+        MessageType type;
+        base::StringPiece method;
+        base::StringPiece payload;
+    };
+
+    static const size_t kLengthHeader = 4;
+    static const size_t kFixedLength = 8 + 1 + 2;
+    static const size_t kMaxMessageLength = 64 * 1024 * 1024;
+
+    //一次写完整个消息 先扩容再按顺序追加 不需要prepend
+    static void append(Buffer* output, uint64_t id, MessageType type, const base::StringPiece& method,
+                       const base::StringPiece& payload);
+
+    //frame是去掉长度头之后的数据 解析结果中的视图都指向frame
+    static bool parse(const base::StringPiece& frame, Message* message);
+};
+
+//调用结果 kTimeout和kDisconnected只在客户端本地产生
+enum RpcStatus
+{
+    kRpcOk,
+    kRpcError,
+    kRpcTimeout,
+    kRpcDisconnected
+};
+
+const char* rpcStatusToString(RpcStatus status);
+
+}  // namespace net
+}  // namespace myMuduo
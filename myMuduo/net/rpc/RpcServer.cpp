@@ -0,0 +1,95 @@
+#include "myMuduo/net/rpc/RpcServer.h"
+#include <memory>
+#include "myMuduo/net/TcpConnection.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+RpcServer::RpcServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name,
+                     TcpServer::Option option)
+    : server_(loop, listenAddr, name, option)
+    , codec_([this](const TcpConnectionPtr& conn, const base::StringPiece& frame,
+                    Timestamp) { onRpcMessage(conn, frame); },
+             RpcCodec::kLengthHeader, LengthHeaderCodec::kBigEndian, RpcCodec::kMaxMessageLength)
+{
+    server_.setConnectionCallback([this](const TcpConnectionPtr& conn) { onConnection(conn); });
+    server_.setMessageCallback([this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime) {
+        codec_.onMessage(conn, buf, receiveTime);
+    });
+}
+
+void RpcServer::registerMethod(const std::string& method, Handler handler, Dispatch dispatch)
+{
+    Method& entry = methods_[method];
+    entry.handler = std::move(handler);
+    entry.dispatch = dispatch;
+}
+
+void RpcServer::start()
+{
+    for (const auto& entry : methods_)
+    {
+        if (entry.second.dispatch == kWorker && !executor_)
+        {
+            spdlog::critical("RpcServer::start() - method {} needs a worker executor", entry.first);
+            abort();
+        }
+    }
+    spdlog::info("RpcServer[{}] starts listening on {}", server_.name(), server_.ipPort());
+    server_.start();
+}
+
+void RpcServer::onConnection(const TcpConnectionPtr& conn)
+{
+    if (conn->connected())
+    {
+        conn->setContext(std::make_shared<RpcChannel>(conn));
+    }
+    else
+    {
+        //未完成的应答持有的是weak_ptr 释放channel后它们会被丢弃
+        conn->setContext(base::Any());
+    }
+}
+
+void RpcServer::onRpcMessage(const TcpConnectionPtr& conn, const base::StringPiece& frame)
+{
+    std::shared_ptr<RpcChannel>* channel = conn->getMutableContext()->cast<std::shared_ptr<RpcChannel>>();
+    if (channel == nullptr)
+    {
+        return;
+    }
+
+    RpcCodec::Message message;
+    if (!RpcCodec::parse(frame, &message) || message.type != RpcCodec::kRequest)
+    {
+        spdlog::error("RpcServer::onRpcMessage() - [{}] malformed message", conn->getName());
+        //codec还会继续交付同一次读到的后续帧 先释放channel让它们在上面直接返回
+        conn->setContext(base::Any());
+        conn->forceClose();
+        return;
+    }
+
+    RpcResponder responder(*channel, message.id);
+    //方法名一般很短 构造string不会分配内存
+    auto it = methods_.find(std::string(message.method.data(), message.method.size()));
+    if (it == methods_.end())
+    {
+        responder.fail("no such method");
+        return;
+    }
+
+    const Method& method = it->second;
+    if (method.dispatch == kInLoop)
+    {
+        method.handler(message.payload, responder);
+        return;
+    }
+    std::string request(message.payload.data(), message.payload.size());
+    Handler handler = method.handler;
+    executor_([handler, request, responder]() { handler(request, responder); });
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include "myMuduo/base/StringPiece.h"
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/TcpServer.h"
+#include "myMuduo/net/codec/LengthHeaderCodec.h"
+#include "myMuduo/net/rpc/RpcChannel.h"
+
+namespace myMuduo {
+namespace net {
+
+//异步RPC服务端 一条连接上可以同时有任意多个未完成的请求 应答按完成顺序返回
+//kInLoop的方法直接在IO线程中执行 request是inputBuffer_中的视图
+//kWorker的方法拷贝request后交给executor 适合耗时的处理
+class RpcServer : noncopyable
+{
+public:
+    enum Dispatch
+    {
+        kInLoop,
+        kWorker
+    };
+
+    //request只在handler执行期间有效 应答可以之后在任何线程通过responder发送
+    using Handler = std::function<void(const base::StringPiece& request, const RpcResponder& responder)>;
+    //把任务交给工作线程执行 比如线程池的submit
+    using Executor = std::function<void(std::function<void()>)>;
+
+    RpcServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name,
+              TcpServer::Option option = TcpServer::kNoReusePort);
+
+    EventLoop* getLoop() const { return server_.getLoop(); }
+
+    //要在start()之前注册
+    void registerMethod(const std::string& method, Handler handler, Dispatch dispatch = kInLoop);
+
+    //有kWorker方法时必须设置
+    void setWorkerExecutor(Executor executor) { executor_ = std::move(executor); }
+
+    void setThreadNum(int numThreads) { server_.setThreadNum(numThreads); }
+
+    void start();
+
+private:
+    struct Method
+    {
+        Handler handler;
+        Dispatch dispatch;
+    };
+
+    void onConnection(const TcpConnectionPtr& conn);
+    void onRpcMessage(const TcpConnectionPtr& conn, const base::StringPiece& frame);
+
+    TcpServer server_;
+    LengthHeaderCodec codec_;
+    std::unordered_map<std::string, Method> methods_;
+    Executor executor_;
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,158 @@
+#include "myMuduo/net/websocket/WebSocketCodec.h"
+#include <algorithm>
+#include <cstring>
+#include "myMuduo/net/Buffer.h"
+#include "myMuduo/net/Endian.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MYMUDUO_WEBSOCKET_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace myMuduo {
+namespace net {
+
+const size_t WebSocketCodec::kMaxHeaderLength;
+const size_t WebSocketCodec::kMaxControlPayloadLength;
+
+int WebSocketCodec::parseHeader(const char* data, size_t len, Frame* frame)
+{
+    if (len < 2)
+    {
+        return 0;
+    }
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    if ((p[0] & 0x70) != 0)
+    {
+        return -1;
+    }
+    frame->fin = (p[0] & 0x80) != 0;
+    frame->masked = (p[1] & 0x80) != 0;
+
+    unsigned opcode = p[0] & 0x0F;
+    switch (opcode)
+    {
+        case kContinuation:
+        case kText:
+        case kBinary:
+        case kClose:
+        case kPing:
+        case kPong:
+            frame->opcode = static_cast<Opcode>(opcode);
+            break;
+        default:
+            return -1;
+    }
+
+    size_t headerLength = 2;
+    uint64_t payloadLength = p[1] & 0x7F;
+    if (payloadLength == 126)
+    {
+        if (len < 4) return 0;
+        uint16_t be16;
+        memcpy(&be16, p + 2, sizeof be16);
+        payloadLength = sockets::networkToHost16(be16);
+        headerLength = 4;
+    }
+    else if (payloadLength == 127)
+    {
+        if (len < 10) return 0;
+        uint64_t be64;
+        memcpy(&be64, p + 2, sizeof be64);
+        payloadLength = sockets::networkToHost64(be64);
+        //最高位必须为0
+        if (payloadLength >> 63)
+        {
+            return -1;
+        }
+        headerLength = 10;
+    }
+    frame->payloadLength = payloadLength;
+
+    //控制帧不能分片 长度不超过125
+    if ((opcode & 0x08) && (!frame->fin || payloadLength > kMaxControlPayloadLength))
+    {
+        return -1;
+    }
+
+    if (frame->masked)
+    {
+        if (len < headerLength + 4) return 0;
+        memcpy(frame->mask, p + headerLength, 4);
+        headerLength += 4;
+    }
+    return static_cast<int>(headerLength);
+}
+
+void WebSocketCodec::unmask(char* data, size_t len, const unsigned char mask[4])
+{
+    //按内存顺序重复掩码 和大小端无关
+    uint32_t mask32;
+    memcpy(&mask32, mask, sizeof mask32);
+    uint64_t mask64 = static_cast<uint64_t>(mask32) << 32 | mask32;
+
+    //每一段都从4的倍数开始 掩码的相位不变
+    size_t i = 0;
+#ifdef MYMUDUO_WEBSOCKET_SSE2
+    const __m128i mask128 = _mm_set1_epi32(static_cast<int>(mask32));
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), mask128));
+    }
+#endif
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof word);
+        word ^= mask64;
+        memcpy(data + i, &word, sizeof word);
+    }
+    for (; i < len; ++i)
+    {
+        data[i] = static_cast<char>(data[i] ^ mask[i & 3]);
+    }
+}
+
+void WebSocketCodec::appendFrame(Buffer* output, Opcode opcode, const char* data, size_t len, bool fin)
+{
+    output->appendInt8(static_cast<int8_t>((fin ? 0x80 : 0x00) | opcode));
+    if (len < 126)
+    {
+        output->appendInt8(static_cast<int8_t>(len));
+    }
+    else if (len <= 0xFFFF)
+    {
+        output->appendInt8(126);
+        output->appendInt16(static_cast<int16_t>(len));
+    }
+    else
+    {
+        output->appendInt8(127);
+        output->appendInt64(static_cast<int64_t>(len));
+    }
+    output->append(data, len);
+}
+
+std::shared_ptr<const std::string> WebSocketCodec::makeFrame(Opcode opcode, const base::StringPiece& payload)
+{
+    Buffer frame(static_cast<int>(payload.size() + kMaxHeaderLength));
+    appendFrame(&frame, opcode, payload.data(), payload.size());
+    return std::make_shared<const std::string>(frame.retrieveAllAsString());
+}
+
+void WebSocketCodec::appendCloseFrame(Buffer* output, uint16_t code, const base::StringPiece& reason)
+{
+    char payload[kMaxControlPayloadLength];
+    uint16_t be16 = sockets::hostToNetwork16(code);
+    memcpy(payload, &be16, sizeof be16);
+    size_t reasonLength = std::min(reason.size(), kMaxControlPayloadLength - 2);
+    if (reasonLength > 0)
+    {
+        memcpy(payload + 2, reason.data(), reasonLength);
+    }
+    appendFrame(output, kClose, payload, reasonLength + 2);
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include "myMuduo/base/StringPiece.h"
+
+namespace myMuduo {
+namespace net {
+
+class Buffer;
+
+//RFC 6455帧格式 不支持扩展(RSV位必须为0)
+//  FIN RSV opcode | MASK len7 | [len16 / len64] | [mask 4字节] | payload
+class WebSocketCodec
+{
+public:
+    enum Opcode
+    {
+        kContinuation = 0x0,
+        kText = 0x1,
+        kBinary = 0x2,
+        kClose = 0x8,
+        kPing = 0x9,
+        kPong = 0xA
+    };
+
+    enum CloseCode
+    {
+        kNormalClosure = 1000,
+        kGoingAway = 1001,
+        kProtocolError = 1002,
+        kMessageTooBig = 1009
+    };
+
+    struct Frame
+    {
+        bool fin;
+        bool masked;
+        Opcode opcode;
+        unsigned char mask[4];
+        uint64_t payloadLength;
+    };
+
+    static const size_t kMaxHeaderLength = 14;
+    static const size_t kMaxControlPayloadLength = 125;
+
+    //解析data开头的帧头 不要求payload已经到达
+    //返回帧头长度 数据不够返回0 格式错误返回-1
+    static int parseHeader(const char* data, size_t len, Frame* frame);
+
+    //原地异或掩码 先按16字节(SSE2)再按8字节处理 最后逐字节收尾
+    static void unmask(char* data, size_t len, const unsigned char mask[4]);
+
+    //服务端发出的帧不加掩码
+    static void appendFrame(Buffer* output, Opcode opcode, const char* data, size_t len, bool fin = true);
+
+    //编码好的完整帧 可以同时发给多条连接
+    static std::shared_ptr<const std::string> makeFrame(Opcode opcode, const base::StringPiece& payload);
+
+    //close帧的payload: 2字节状态码 + 可选的原因
+    static void appendCloseFrame(Buffer* output, uint16_t code, const base::StringPiece& reason = base::StringPiece());
+};
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,429 @@
+#include "myMuduo/net/websocket/WebSocketServer.h"
+#include <cstring>
+#include <unordered_set>
+#include <vector>
+#include "myMuduo/base/Base64.h"
+#include "myMuduo/base/Sha1.h"
+#include "myMuduo/net/EventLoop.h"
+#include "myMuduo/net/http/HttpContext.h"
+#include "myMuduo/net/http/HttpRequest.h"
+#include "myMuduo/net/http/HttpResponse.h"
+#include "spdlog/spdlog.h"
+
+namespace myMuduo {
+namespace net {
+
+const size_t WebSocketServer::kDefaultMaxMessageLength;
+
+struct WebSocketServer::LoopConnections
+{
+    std::unordered_set<TcpConnectionPtr> connections;
+    base::TimerId pingTimer;
+};
+
+namespace {
+
+const double kDefaultPingInterval = 30.0;
+const char kWebSocketGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+void defaultWebSocketMessageCallback(const TcpConnectionPtr&, const base::StringPiece&, WebSocketCodec::Opcode, Timestamp) {}
+
+//每条连接的状态 握手之前只用到http
+struct WebSocketContext
+{
+    WebSocketContext()
+        : http(0)
+        , upgraded(false)
+        , closing(false)
+        , fragmentOpcode(WebSocketCodec::kContinuation)
+    {
+    }
+
+    HttpContext http;
+    bool upgraded;
+    //已经发出close帧 不再处理后续的帧
+    bool closing;
+    //分片消息的类型 kContinuation表示当前没有未完成的分片消息
+    WebSocketCodec::Opcode fragmentOpcode;
+    std::string fragments;
+    Timestamp lastReceiveTime;
+    std::shared_ptr<WebSocketServer::LoopConnections> loopConnectionsPtr;
+};
+
+//Connection可能是以逗号分隔的列表 比如"keep-alive, Upgrade"
+bool containsToken(base::StringPiece list, const base::StringPiece& token)
+{
+    while (!list.empty())
+    {
+        const char* comma = static_cast<const char*>(memchr(list.data(), ',', list.size()));
+        size_t length = comma == nullptr ? list.size() : static_cast<size_t>(comma - list.data());
+        base::StringPiece item(list.data(), length);
+        while (!item.empty() && (item[0] == ' ' || item[0] == '\t'))
+        {
+            item.removePrefix(1);
+        }
+        while (!item.empty() && (item[item.size() - 1] == ' ' || item[item.size() - 1] == '\t'))
+        {
+            item.removeSuffix(1);
+        }
+        if (base::equalsIgnoreCase(item, token))
+        {
+            return true;
+        }
+        list.removePrefix(comma == nullptr ? list.size() : length + 1);
+    }
+    return false;
+}
+
+//握手失败时的应答 之后关闭连接
+void rejectHandshake(const TcpConnectionPtr& conn, HttpResponse::HttpStatusCode code)
+{
+    HttpResponse response(true);
+    response.setStatusCode(code);
+    if (code == HttpResponse::k426UpgradeRequired)
+    {
+        response.addHeader("Upgrade", "websocket");
+        response.addHeader("Sec-WebSocket-Version", "13");
+    }
+    Buffer output;
+    response.appendToBuffer(&output);
+    conn->send(&output);
+    conn->shutdown();
+}
+
+//进入关闭流程 连接不再参与广播和ping
+void startClosing(const TcpConnectionPtr& conn, WebSocketContext* context, uint16_t code,
+                  const base::StringPiece& reason)
+{
+    context->closing = true;
+    if (context->loopConnectionsPtr)
+    {
+        context->loopConnectionsPtr->connections.erase(conn);
+    }
+    Buffer output;
+    WebSocketCodec::appendCloseFrame(&output, code, reason);
+    conn->send(&output);
+    conn->shutdown();
+}
+
+}  // namespace
+
+WebSocketServer::WebSocketServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name,
+                                 TcpServer::Option option)
+    : server_(loop, listenAddr, name, option)
+    , messageCallback_(defaultWebSocketMessageCallback)
+    , maxMessageLength_(kDefaultMaxMessageLength)
+    , pingInterval_(kDefaultPingInterval)
+    , pingFramePtr_(WebSocketCodec::makeFrame(WebSocketCodec::kPing, base::StringPiece()))
+{
+    server_.setConnectionCallback([this](const TcpConnectionPtr& conn) { onConnection(conn); });
+    server_.setMessageCallback(
+        [this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime) { onMessage(conn, buf, receiveTime); });
+}
+
+WebSocketServer::~WebSocketServer()
+{
+    //定时器只能在所属loop中取消
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : loops_)
+    {
+        base::TimerId timerId = entry.second->pingTimer;
+        EventLoop* loop = entry.first;
+        loop->runInLoop([loop, timerId]() { loop->cancel(timerId); });
+    }
+}
+
+void WebSocketServer::start()
+{
+    spdlog::info("WebSocketServer[{}] starts listening on {}", server_.name(), server_.ipPort());
+    server_.start();
+}
+
+void WebSocketServer::send(const TcpConnectionPtr& conn, const base::StringPiece& message,
+                           WebSocketCodec::Opcode opcode)
+{
+    Buffer output(static_cast<int>(message.size() + WebSocketCodec::kMaxHeaderLength));
+    WebSocketCodec::appendFrame(&output, opcode, message.data(), message.size());
+    conn->send(&output);
+}
+
+void WebSocketServer::close(const TcpConnectionPtr& conn, uint16_t code, const std::string& reason)
+{
+    conn->getLoop()->runInLoop([conn, code, reason]() {
+        WebSocketContext* context = conn->getMutableContext()->cast<WebSocketContext>();
+        if (context != nullptr && context->upgraded && !context->closing && conn->connected())
+        {
+            startClosing(conn, context, code, reason);
+        }
+    });
+}
+
+void WebSocketServer::broadcast(const base::StringPiece& message, WebSocketCodec::Opcode opcode)
+{
+    std::shared_ptr<const std::string> framePtr = WebSocketCodec::makeFrame(opcode, message);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : loops_)
+    {
+        std::shared_ptr<LoopConnections> connectionsPtr = entry.second;
+        //在loop线程中send直接写socket 帧本身不再拷贝
+        entry.first->runInLoop([connectionsPtr, framePtr]() {
+            for (const TcpConnectionPtr& conn : connectionsPtr->connections)
+            {
+                conn->send(*framePtr);
+            }
+        });
+    }
+}
+
+void WebSocketServer::onConnection(const TcpConnectionPtr& conn)
+{
+    if (conn->connected())
+    {
+        conn->setContext(WebSocketContext());
+        return;
+    }
+
+    WebSocketContext* context = conn->getMutableContext()->cast<WebSocketContext>();
+    if (context != nullptr && context->upgraded)
+    {
+        if (context->loopConnectionsPtr)
+        {
+            context->loopConnectionsPtr->connections.erase(conn);
+            context->loopConnectionsPtr.reset();
+        }
+        if (connectionCallback_)
+        {
+            connectionCallback_(conn);
+        }
+    }
+}
+
+void WebSocketServer::onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime)
+{
+    WebSocketContext* context = conn->getMutableContext()->cast<WebSocketContext>();
+    if (context == nullptr || context->closing || !conn->connected())
+    {
+        buf->retrieveAll();
+        return;
+    }
+    if (!context->upgraded && !handshake(conn, buf, receiveTime))
+    {
+        return;
+    }
+    //客户端可能紧跟着握手请求发送帧
+    processFrames(conn, buf, receiveTime);
+}
+
+bool WebSocketServer::handshake(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime)
+{
+    WebSocketContext* context = conn->getMutableContext()->cast<WebSocketContext>();
+    HttpContext* http = &context->http;
+    if (!http->parseRequest(buf, receiveTime))
+    {
+        buf->retrieveAll();
+        context->closing = true;
+        rejectHandshake(conn, http->errorCode());
+        return false;
+    }
+    if (!http->gotAll())
+    {
+        return false;
+    }
+
+    const HttpRequest& req = http->request();
+    HttpResponse::HttpStatusCode error = HttpResponse::kUnknown;
+    base::StringPiece key = req.getHeader("Sec-WebSocket-Key");
+    if (req.method() != HttpRequest::kGet || req.getVersion() != HttpRequest::kHttp11)
+    {
+        error = HttpResponse::k400BadRequest;
+    }
+    else if (!base::equalsIgnoreCase(req.getHeader("Upgrade"), "websocket") ||
+             !containsToken(req.getHeader("Connection"), "upgrade") || req.getHeader("Sec-WebSocket-Version") != "13")
+    {
+        error = HttpResponse::k426UpgradeRequired;
+    }
+    else if (key.empty())
+    {
+        error = HttpResponse::k400BadRequest;
+    }
+    if (error != HttpResponse::kUnknown)
+    {
+        buf->retrieveAll();
+        context->closing = true;
+        rejectHandshake(conn, error);
+        return false;
+    }
+
+    //Sec-WebSocket-Accept = base64(sha1(key + GUID))
+    std::string accept(key.data(), key.size());
+    accept += kWebSocketGuid;
+    std::string digest = base::sha1(accept.data(), accept.size());
+    accept = base::base64Encode(digest.data(), digest.size());
+
+    //101不能带Content-Length 不经过HttpResponse
+    Buffer output;
+    static const char kSwitching[] =
+        "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: ";
+    output.append(kSwitching, sizeof kSwitching - 1);
+    output.append(accept.data(), accept.size());
+    output.append("\r\n\r\n", 4);
+    conn->send(&output);
+    http->consume(buf);
+
+    context->upgraded = true;
+    context->lastReceiveTime = receiveTime;
+    context->loopConnectionsPtr = connectionsOf(conn->getLoop());
+    context->loopConnectionsPtr->connections.insert(conn);
+    if (connectionCallback_)
+    {
+        connectionCallback_(conn);
+    }
+    return true;
+}
+
+//一次处理buf中所有完整的帧 帧没收全时留在buf中 大小受maxMessageLength_限制
+void WebSocketServer::processFrames(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime)
+{
+    WebSocketContext* context = conn->getMutableContext()->cast<WebSocketContext>();
+    while (!context->closing && conn->connected())
+    {
+        WebSocketCodec::Frame frame;
+        int headerLength = WebSocketCodec::parseHeader(buf->peek(), buf->readableBytesLength(), &frame);
+        if (headerLength == 0)
+        {
+            break;
+        }
+        //客户端发来的帧必须加掩码
+        if (headerLength < 0 || !frame.masked)
+        {
+            spdlog::warn("WebSocketServer::processFrames() - [{}] protocol error", conn->getName());
+            startClosing(conn, context, WebSocketCodec::kProtocolError, base::StringPiece());
+            break;
+        }
+        if (frame.payloadLength > maxMessageLength_ || context->fragments.size() + frame.payloadLength > maxMessageLength_)
+        {
+            spdlog::warn("WebSocketServer::processFrames() - [{}] message too big", conn->getName());
+            startClosing(conn, context, WebSocketCodec::kMessageTooBig, base::StringPiece());
+            break;
+        }
+        size_t payloadLength = static_cast<size_t>(frame.payloadLength);
+        if (buf->readableBytesLength() < headerLength + payloadLength)
+        {
+            break;
+        }
+
+        char* payload = buf->beginRead() + headerLength;
+        WebSocketCodec::unmask(payload, payloadLength, frame.mask);
+        context->lastReceiveTime = receiveTime;
+
+        bool dataFrame = frame.opcode == WebSocketCodec::kText || frame.opcode == WebSocketCodec::kBinary;
+        if (dataFrame || frame.opcode == WebSocketCodec::kContinuation)
+        {
+            //分片消息进行中不能开始新消息 没有分片消息时不能收到延续帧
+            if (dataFrame == (context->fragmentOpcode != WebSocketCodec::kContinuation))
+            {
+                startClosing(conn, context, WebSocketCodec::kProtocolError, base::StringPiece());
+                break;
+            }
+            if (dataFrame && frame.fin)
+            {
+                messageCallback_(conn, base::StringPiece(payload, payloadLength), frame.opcode, receiveTime);
+            }
+            else
+            {
+                if (dataFrame)
+                {
+                    context->fragmentOpcode = frame.opcode;
+                }
+                context->fragments.append(payload, payloadLength);
+                if (frame.fin)
+                {
+                    WebSocketCodec::Opcode opcode = context->fragmentOpcode;
+                    context->fragmentOpcode = WebSocketCodec::kContinuation;
+                    messageCallback_(conn, context->fragments, opcode, receiveTime);
+                    context->fragments.clear();
+                }
+            }
+        }
+        else if (frame.opcode == WebSocketCodec::kPing)
+        {
+            send(conn, base::StringPiece(payload, payloadLength), WebSocketCodec::kPong);
+        }
+        else if (frame.opcode == WebSocketCodec::kClose)
+        {
+            //对方的状态码合法时回1000 否则回1002
+            //1005 1006 1015只在本地表示状态 不能出现在帧里 1000-4999以外的都是非法的 长度为1的载荷也是非法的
+            uint16_t code = WebSocketCodec::kNormalClosure;
+            if (payloadLength == 1)
+            {
+                code = WebSocketCodec::kProtocolError;
+            }
+            else if (payloadLength >= 2)
+            {
+                uint16_t peerCode = static_cast<uint16_t>(static_cast<unsigned char>(payload[0]) << 8 |
+                                                          static_cast<unsigned char>(payload[1]));
+                if (peerCode < 1000 || peerCode > 4999 || peerCode == 1005 || peerCode == 1006 || peerCode == 1015)
+                {
+                    code = WebSocketCodec::kProtocolError;
+                }
+            }
+            startClosing(conn, context, code, base::StringPiece());
+        }
+        buf->retrieve(headerLength + payloadLength);
+    }
+
+    if (context->closing)
+    {
+        buf->retrieveAll();
+    }
+}
+
+//第一次有连接升级时创建 同时在这个loop中启动ping定时器
+std::shared_ptr<WebSocketServer::LoopConnections> WebSocketServer::connectionsOf(EventLoop* loop)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<LoopConnections>& connectionsPtr = loops_[loop];
+    if (connectionsPtr)
+    {
+        return connectionsPtr;
+    }
+
+    connectionsPtr = std::make_shared<LoopConnections>();
+    if (pingInterval_ > 0)
+    {
+        std::weak_ptr<LoopConnections> weakConnections(connectionsPtr);
+        std::shared_ptr<const std::string> pingFramePtr = pingFramePtr_;
+        int64_t timeoutMicroSeconds = static_cast<int64_t>(pingInterval_ * 2 * Timestamp::kMicroSecondsPerSecond);
+        connectionsPtr->pingTimer = loop->runEvery(pingInterval_, [weakConnections, pingFramePtr, timeoutMicroSeconds]() {
+            std::shared_ptr<LoopConnections> connections = weakConnections.lock();
+            if (!connections)
+            {
+                return;
+            }
+            int64_t now = Timestamp::now().microSecondsSinceEpoch();
+            std::vector<TcpConnectionPtr> expired;
+            for (const TcpConnectionPtr& conn : connections->connections)
+            {
+                WebSocketContext* context = conn->getMutableContext()->cast<WebSocketContext>();
+                if (now - context->lastReceiveTime.microSecondsSinceEpoch() > timeoutMicroSeconds)
+                {
+                    expired.push_back(conn);
+                }
+                else
+                {
+                    conn->send(*pingFramePtr);
+                }
+            }
+            for (const TcpConnectionPtr& conn : expired)
+            {
+                spdlog::info("WebSocketServer - [{}] ping timeout", conn->getName());
+                connections->connections.erase(conn);
+                conn->forceClose();
+            }
+        });
+    }
+    return connectionsPtr;
+}
+
+}  // namespace net
+}  // namespace myMuduo
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "myMuduo/base/StringPiece.h"
+#include "myMuduo/base/noncopyable.h"
+#include "myMuduo/net/TcpServer.h"
+#include "myMuduo/net/websocket/WebSocketCodec.h"
+
+namespace myMuduo {
+namespace net {
+
+//WebSocket服务器 先用HttpContext解析升级请求 回复101之后按RFC 6455帧处理
+//收到的帧在inputBuffer_中原地去掩码 未分片的消息直接以视图交给回调 不拷贝
+//每个loop一个定时器 定时给本loop上的连接发ping 超时没有任何数据的连接被关闭
+class WebSocketServer : noncopyable
+{
+public:
+    //message指向inputBuffer_或者分片拼接缓冲区 只在回调期间有效
+    //opcode是kText或者kBinary 不校验文本消息的UTF-8
+    using WebSocketMessageCallback = std::function<void(const TcpConnectionPtr&, const base::StringPiece& message,
+                                                        WebSocketCodec::Opcode opcode, Timestamp)>;
+
+    static const size_t kDefaultMaxMessageLength = 16 * 1024 * 1024;
+
+    WebSocketServer(EventLoop* loop, const InetAddress& listenAddr, const std::string& name,
+                    TcpServer::Option option = TcpServer::kNoReusePort);
+    ~WebSocketServer();
+
+    EventLoop* getLoop() const { return server_.getLoop(); }
+
+    //握手完成和升级后的连接断开时调用 没完成握手的连接不会通知
+    void setConnectionCallback(ConnectionCallback cb) { connectionCallback_ = std::move(cb); }
+    void setMessageCallback(WebSocketMessageCallback cb) { messageCallback_ = std::move(cb); }
+
+    void setThreadNum(int numThreads) { server_.setThreadNum(numThreads); }
+
+    //单帧或者分片拼接后超过这个长度的消息 回复1009并关闭连接
+    void setMaxMessageLength(size_t maxMessageLength) { maxMessageLength_ = maxMessageLength; }
+
+    //每隔seconds秒发一次ping 两个间隔内没收到任何帧就关闭连接 0表示不发 要在start()之前设置
+    void setPingInterval(double seconds) { pingInterval_ = seconds; }
+
+    void start();
+
+    //线程安全
+    static void send(const TcpConnectionPtr& conn, const base::StringPiece& message,
+                     WebSocketCodec::Opcode opcode = WebSocketCodec::kText);
+    //发送close帧后半关闭 之后到达的数据都丢弃
+    static void close(const TcpConnectionPtr& conn, uint16_t code = WebSocketCodec::kNormalClosure,
+                      const std::string& reason = std::string());
+
+    //消息只编码一次 每个loop排队一个任务 把同一份帧发给本loop上的所有连接
+    void broadcast(const base::StringPiece& message, WebSocketCodec::Opcode opcode = WebSocketCodec::kText);
+
+    //每个loop上已升级的连接 只在所属loop线程中访问
+    struct LoopConnections;
+
+private:
+    void onConnection(const TcpConnectionPtr& conn);
+    void onMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime);
+    //返回false表示握手失败或者还没收全
+    bool handshake(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime);
+    void processFrames(const TcpConnectionPtr& conn, Buffer* buf, Timestamp receiveTime);
+    std::shared_ptr<LoopConnections> connectionsOf(EventLoop* loop);
+
+    TcpServer server_;
+    ConnectionCallback connectionCallback_;
+    WebSocketMessageCallback messageCallback_;
+    size_t maxMessageLength_;
+    double pingInterval_;
+    std::shared_ptr<const std::string> pingFramePtr_;
+    std::mutex mutex_;
+    std::map<EventLoop*, std::shared_ptr<LoopConnections>> loops_;
+};
+
+}  // namespace net
+}  // namespace myMuduo